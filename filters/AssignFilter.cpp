@@ -34,6 +34,9 @@
 
 #include "AssignFilter.hpp"
 
+#include <algorithm>
+
+#include <pdal/PointSpan.hpp>
 #include <pdal/StageFactory.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 
@@ -189,13 +192,88 @@ bool AssignFilter::processOne(PointRef& point)
 }
 
 
+// Same as processOne(), but the condition and range assignments are
+// done a dimension at a time and the statements are evaluated for the
+// whole span.
+void AssignFilter::processBatch(PointSpan& span)
+{
+    std::vector<char> apply(span.size(), 1);
+    std::vector<double> vals;
+
+    if (m_args->m_condition.m_id != Dimension::Id::Unknown)
+    {
+        span.getField(m_args->m_condition.m_id, vals);
+        for (point_count_t i = 0; i < span.size(); ++i)
+            apply[i] = m_args->m_condition.valuePasses(vals[i]);
+    }
+
+    PointRef point(span.table());
+    for (AssignRange& r : m_args->m_assignments)
+    {
+        span.getField(r.m_id, vals);
+        for (point_count_t i = 0; i < span.size(); ++i)
+            if (apply[i] && r.valuePasses(vals[i]))
+            {
+                point.setPointId(span.id(i));
+                point.setField(r.m_id, r.m_value);
+            }
+    }
+
+    std::vector<double> cond;
+    for (expr::AssignStatement& expr : m_args->m_statements)
+    {
+        Dimension::Id dim = expr.identExpr().eval();
+        expr.conditionalExpr().program().eval(span, cond);
+        expr.valueExpr().program().eval(span, vals);
+        for (point_count_t i = 0; i < span.size(); ++i)
+            if (apply[i] && cond[i] != 0)
+            {
+                point.setPointId(span.id(i));
+                point.setField(dim, vals[i]);
+            }
+    }
+}
+
+
+// Same as processOne(), but the statements are evaluated for blocks of
+// points.
 void AssignFilter::filter(PointView& view)
 {
+    std::vector<char> apply(view.size(), 1);
     PointRef point(view, 0);
     for (PointId id = 0; id < view.size(); ++id)
     {
         point.setPointId(id);
-        processOne(point);
+        if (m_args->m_condition.m_id != Dimension::Id::Unknown)
+        {
+            double condVal =
+                point.getFieldAs<double>(m_args->m_condition.m_id);
+            apply[id] = m_args->m_condition.valuePasses(condVal);
+            if (!apply[id])
+                continue;
+        }
+        for (AssignRange& r : m_args->m_assignments)
+            if (r.valuePasses(point.getFieldAs<double>(r.m_id)))
+                point.setField(r.m_id, r.m_value);
+    }
+
+    using expr::ViewEvaluator;
+    for (expr::AssignStatement& expr : m_args->m_statements)
+    {
+        Dimension::Id dim = expr.identExpr().eval();
+        ViewEvaluator cond(expr.conditionalExpr().program(), view);
+        ViewEvaluator value(expr.valueExpr().program(), view);
+        for (PointId begin = 0; begin < view.size();
+            begin += ViewEvaluator::BlockSize)
+        {
+            point_count_t count =
+                (std::min)(ViewEvaluator::BlockSize, view.size() - begin);
+            const double *c = cond.eval(begin, count);
+            const double *v = value.eval(begin, count);
+            for (point_count_t i = 0; i < count; ++i)
+                if (apply[begin + i] && c[i] != 0)
+                    view.setField(dim, begin + i, v[i]);
+        }
     }
 }
 
@@ -54,7 +54,12 @@ private:
     virtual void addArgs(ProgramArgs& args);
     virtual void prepared(PointTableRef table);
     virtual bool processOne(PointRef& point);
+    virtual void processBatch(PointSpan& span);
     virtual void filter(PointView& view);
+    virtual bool parallelViewSafe() const
+        { return true; }
+    virtual bool parallelPointSafe() const
+        { return true; }
 
     AssignFilter& operator=(const AssignFilter&) = delete;
     AssignFilter(const AssignFilter&) = delete;
@@ -65,6 +65,16 @@ void ClusterFilter::addArgs(ProgramArgs& args)
         (std::numeric_limits<uint64_t>::max)());
     args.add("tolerance", "Radius", m_tolerance, 1.0);
     args.add("is3d", "Perform cluster extraction in 3D?", m_is3d, true);
+    args.add("threads", "Number of threads used to run this filter",
+        m_threads, 1);
+    args.add("kd_storage", "Storage of coordinates in the KD index "
+        "(view, double, float)", m_kdStorage, KDStorage::Double);
+}
+
+void ClusterFilter::initialize()
+{
+    if (m_threads < 1)
+        throwError("Option 'threads' must be greater than 0.");
 }
 
 void ClusterFilter::addDimensions(PointLayoutPtr layout)
@@ -77,10 +87,10 @@ void ClusterFilter::filter(PointView& view)
     std::deque<PointIdList> clusters;
     if (m_is3d)
         clusters = Segmentation::extractClusters<KD3Index>(view, m_minPoints,
-            m_maxPoints, m_tolerance);
+            m_maxPoints, m_tolerance, m_threads, m_kdStorage);
     else
         clusters = Segmentation::extractClusters<KD2Index>(view, m_minPoints,
-            m_maxPoints, m_tolerance);
+            m_maxPoints, m_tolerance, m_threads, m_kdStorage);
 
     uint64_t id = 1;
     for (auto const& c : clusters)
@@ -58,9 +58,12 @@ private:
     uint64_t m_maxPoints;
     double m_tolerance;
     bool m_is3d;
+    int m_threads;
+    KDStorage m_kdStorage;
 
     virtual void addArgs(ProgramArgs& args);
     virtual void addDimensions(PointLayoutPtr layout);
+    virtual void initialize();
     virtual void filter(PointView& view);
 };
 
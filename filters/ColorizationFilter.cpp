@@ -34,11 +34,13 @@
 
 #include "ColorizationFilter.hpp"
 
+#include <pdal/PointSpan.hpp>
 #include <pdal/PointView.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 #include <pdal/private/gdal/Raster.hpp>
+#include <pdal/private/gdal/RasterSampler.hpp>
 
-#include <array>
+#include <algorithm>
 
 namespace pdal
 {
@@ -136,6 +138,8 @@ void ColorizationFilter::addArgs(ProgramArgs& args)
 {
     args.add("raster", "Raster filename", m_rasterFilename);
     args.add("dimensions", "Dimensions to use for colorization", m_dimSpec);
+    args.add("cache_size", "Memory used to cache raster blocks (MB)",
+        m_cacheSize, (size_t)256);
 }
 
 
@@ -150,6 +154,7 @@ void ColorizationFilter::initialize()
 
     uint32_t defaultBand = 1;
     m_bands.clear();
+    m_bandNums.clear();
     for (std::string& dim : m_dimSpec)
     {
         try
@@ -160,6 +165,7 @@ void ColorizationFilter::initialize()
             if (bi.m_band <= bandTypes.size())
                 bi.m_type = bandTypes[bi.m_band - 1];
             m_bands.push_back(bi);
+            m_bandNums.push_back((int)bi.m_band);
         }
         catch(const std::string& what)
         {
@@ -196,26 +202,20 @@ void ColorizationFilter::ready(PointTableRef table)
             throwError(m_raster->errorMsg());
         }
     }
+    m_sampler.reset(new RasterSampler(*m_raster, m_cacheSize * 1024 * 1024));
 }
 
 
 bool ColorizationFilter::processOne(PointRef& point)
 {
-    static std::vector<double> data;
-    static std::array<double, 2> pix;
-
     double x = point.getFieldAs<double>(Dimension::Id::X);
     double y = point.getFieldAs<double>(Dimension::Id::Y);
 
-    if (m_raster->read(x, y, data, pix) == gdal::GDALError::None)
+    for (BandInfo& b : m_bands)
     {
-        int i(0);
-        for (auto bi = m_bands.begin(); bi != m_bands.end(); ++bi)
-        {
-            BandInfo& b = *bi;
-            point.setField(b.m_dim, data[i] * b.m_scale);
-            ++i;
-        }
+        double value;
+        if (m_sampler->sample(x, y, (int)b.m_band, value))
+            point.setField(b.m_dim, value * b.m_scale);
     }
 
     // always return true to retain all points inside OR outside the raster. the output bands of
@@ -224,13 +224,59 @@ bool ColorizationFilter::processOne(PointRef& point)
 }
 
 
+// Sample a span of points at once so that each raster block is read
+// once for all the points that fall in it.
+void ColorizationFilter::processBatch(PointSpan& span)
+{
+    std::vector<double> x, y, values;
+    std::vector<char> valid;
+    span.getField(Dimension::Id::X, x);
+    span.getField(Dimension::Id::Y, y);
+
+    m_sampler->sample(x, y, m_bandNums, values, valid);
+    for (point_count_t i = 0; i < span.size(); ++i)
+    {
+        if (!valid[i])
+            continue;
+        PointRef point(span.table(), span.id(i));
+        for (size_t b = 0; b < m_bands.size(); ++b)
+            point.setField(m_bands[b].m_dim,
+                values[i * m_bands.size() + b] * m_bands[b].m_scale);
+    }
+}
+
+
 void ColorizationFilter::filter(PointView& view)
 {
-    PointRef point = view.point(0);
-    for (PointId idx = 0; idx < view.size(); ++idx)
+    // Points are sampled in blocks to limit the size of the buffers.
+    const point_count_t BlockSize = 1 << 20;
+
+    std::vector<double> x, y, values;
+    std::vector<char> valid;
+    PointRef point(view, 0);
+    for (PointId start = 0; start < view.size(); start += BlockSize)
     {
-        point.setPointId(idx);
-        processOne(point);
+        const point_count_t count =
+            (std::min)(BlockSize, view.size() - start);
+        x.resize(count);
+        y.resize(count);
+        for (point_count_t i = 0; i < count; ++i)
+        {
+            point.setPointId(start + i);
+            x[i] = point.getFieldAs<double>(Dimension::Id::X);
+            y[i] = point.getFieldAs<double>(Dimension::Id::Y);
+        }
+
+        m_sampler->sample(x, y, m_bandNums, values, valid);
+        for (point_count_t i = 0; i < count; ++i)
+        {
+            if (!valid[i])
+                continue;
+            point.setPointId(start + i);
+            for (size_t b = 0; b < m_bands.size(); ++b)
+                point.setField(m_bands[b].m_dim,
+                    values[i * m_bands.size() + b] * m_bands[b].m_scale);
+        }
     }
 }
 
@@ -42,7 +42,11 @@
 namespace pdal
 {
 
-namespace gdal { class Raster; }
+namespace gdal
+{
+    class Raster;
+    class RasterSampler;
+}
 
 // Provides GDAL-based raster overlay that places output data in
 // specified dimensions. It also supports scaling the data by a multiplier
@@ -81,13 +85,17 @@ private:
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void ready(PointTableRef table);
     virtual bool processOne(PointRef& point);
+    virtual void processBatch(PointSpan& span);
     virtual void filter(PointView& view);
 
     StringList m_dimSpec;
     std::string m_rasterFilename;
     std::vector<BandInfo> m_bands;
+    std::vector<int> m_bandNums;
+    size_t m_cacheSize;
 
     std::unique_ptr<gdal::Raster> m_raster;
+    std::unique_ptr<gdal::RasterSampler> m_sampler;
 };
 
 } // namespace pdal
@@ -38,9 +38,14 @@
 #include "DBSCANFilter.hpp"
 
 #include <pdal/KDIndex.hpp>
+#include <pdal/util/Executor.hpp>
 
+#include "private/UnionFind.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
 #include <string>
-#include <unordered_set>
 
 namespace pdal
 {
@@ -58,7 +63,8 @@ std::string DBSCANFilter::getName() const
     return s_info.name;
 }
 
-DBSCANFilter::DBSCANFilter() : Filter()
+DBSCANFilter::DBSCANFilter() : Filter(), m_threads(1), m_clusters(0),
+    m_memory(0), m_indexTime(0), m_coreTime(0), m_clusterTime(0)
 {
 }
 
@@ -69,6 +75,16 @@ void DBSCANFilter::addArgs(ProgramArgs& args)
     args.add("eps", "Epsilon", m_eps, 1.0);
     args.add("dimensions", "Dimensions to cluster", m_dimStringList,
              {"X", "Y", "Z"});
+    args.add("threads", "Number of threads used to run this filter",
+        m_threads, 1);
+    args.add("kd_storage", "Storage of coordinates in the KD index "
+        "(view, double, float)", m_kdStorage, KDStorage::Double);
+}
+
+void DBSCANFilter::initialize()
+{
+    if (m_threads < 1)
+        throwError("Option 'threads' must be greater than 0.");
 }
 
 void DBSCANFilter::addDimensions(PointLayoutPtr layout)
@@ -94,81 +110,131 @@ void DBSCANFilter::prepared(PointTableRef table)
     }
 }
 
+void DBSCANFilter::ready(PointTableRef table)
+{
+    m_clusters = 0;
+    m_memory = 0;
+    m_indexTime = 0;
+    m_coreTime = 0;
+    m_clusterTime = 0;
+}
+
+namespace
+{
+
+double elapsed(std::chrono::steady_clock::time_point& start)
+{
+    auto now = std::chrono::steady_clock::now();
+    double secs = std::chrono::duration<double>(now - start).count();
+    start = now;
+    return secs;
+}
+
+} // unnamed namespace
+
+// Neighborhoods are computed on the fly rather than stored, so memory use
+// is linear in the number of points.  A first pass counts neighbors to
+// find core points.  A second pass joins each core point with its core
+// neighbors in a union-find.  A third pass assigns each border point to
+// the adjacent cluster with the smallest label.  Clusters are labeled in
+// the order of their smallest point ID, which produces the same result as
+// the classic sequential algorithm.
 void DBSCANFilter::filter(PointView& view)
 {
-    // Construct KDFlexIndex for radius search.
-    KDFlexIndex kdfi(view, m_dimIdList);
-    kdfi.build();
-
-    // First pass through point cloud precomputes neighbor indices and
-    // initializes ClusterID to -2.
-    std::vector<PointIdList> neighbors(view.size());
-    for (PointId idx = 0; idx < view.size(); ++idx)
+    const PointId None = (std::numeric_limits<PointId>::max)();
+    const point_count_t size = view.size();
+    auto start = std::chrono::steady_clock::now();
+
+    // Construct KDFlexIndex for radius search.  The coordinates are copied
+    // into the index so that queries don't go through the point table.
+    KDFlexIndex kdfi(view, m_dimIdList, m_kdStorage);
+    kdfi.build(m_threads);
+    double indexTime = elapsed(start);
+
+    // Find core points.
+    std::vector<char> core(size);
+    parallelRange(size, (size_t)m_threads, [&](PointId begin, PointId end)
     {
-        neighbors[idx] = kdfi.radius(idx, m_eps);
-        view.setField(Id::ClusterID, idx, -2);
-    }
-
-    // Second pass through point cloud performs DBSCAN clustering.
-    int64_t cluster_label = 0;
-    for (PointId idx = 0; idx < view.size(); ++idx)
+        for (PointId idx = begin; idx < end; ++idx)
+            core[idx] = kdfi.radius(idx, m_eps).size() >= m_minPoints;
+    });
+    double coreTime = elapsed(start);
+
+    // Join core points with their core neighbors.
+    UnionFind sets(size);
+    parallelRange(size, (size_t)m_threads, [&](PointId begin, PointId end)
     {
-        // Point has already been labeled, so move on to next.
-        if (view.getFieldAs<int64_t>(Id::ClusterID, idx) != -2)
-            continue;
-
-        // Density of the neighborhood does not meet minimum number of points
-        // constraint, label as noise.
-        if (neighbors[idx].size() < m_minPoints)
+        for (PointId idx = begin; idx < end; ++idx)
         {
-            view.setField(Id::ClusterID, idx, -1);
-            continue;
+            if (!core[idx])
+                continue;
+            for (PointId q : kdfi.radius(idx, m_eps))
+                if (q > idx && core[q])
+                    sets.unite(idx, q);
         }
-
-        // Initialize some bookkeeping to track which neighbors have been
-        // considered for addition to the current cluster.
-        std::unordered_set<PointId> neighbors_next(neighbors[idx].begin(),
-                                                   neighbors[idx].end());
-        std::unordered_set<PointId> neighbors_visited;
-        neighbors_visited.insert(idx);
-
-        // Unlabeled point encountered; assign cluster label.
-        view.setField(Id::ClusterID, idx, cluster_label);
-
-        // Consider all neighbors.
-        while (!neighbors_next.empty())
+    });
+    parallelRange(size, (size_t)m_threads, [&](PointId begin, PointId end)
+    {
+        for (PointId idx = begin; idx < end; ++idx)
+            if (core[idx])
+                sets.set(idx, sets.find(idx));
+    });
+
+    // Attach border points to a neighboring cluster.  Points that aren't
+    // near any core point are noise.
+    parallelRange(size, (size_t)m_threads, [&](PointId begin, PointId end)
+    {
+        for (PointId idx = begin; idx < end; ++idx)
         {
-            // Select first neighbor and move it to the visited set.
-            PointId p = *neighbors_next.begin();
-            neighbors_next.erase(neighbors_next.begin());
-            neighbors_visited.insert(p);
-
-            // Reassign cluster label to neighbor previously marked as noise.
-            if (view.getFieldAs<int64_t>(Id::ClusterID, p) == -1)
-                view.setField(Id::ClusterID, p, cluster_label);
-
-            // Neighbor has already been labeled, so move on to next.
-            if (view.getFieldAs<int64_t>(Id::ClusterID, p) != -2)
+            if (core[idx])
                 continue;
-
-            // Assign cluster label to neighbor.
-            view.setField(Id::ClusterID, p, cluster_label);
-
-            // If density of neighbor's neighborhood is sufficient, add it's
-            // neighbors to the set of neighbors to consider if they are not
-            // already.
-            if (neighbors[p].size() >= m_minPoints)
-            {
-                for (PointId q : neighbors[p])
-                {
-                    if (neighbors_visited.count(q) == 0)
-                        neighbors_next.insert(q);
-                }
-            }
+            PointId root = None;
+            for (PointId q : kdfi.radius(idx, m_eps))
+                if (core[q])
+                    root = (std::min)(root, sets.get(q));
+            sets.set(idx, root);
         }
+    });
 
-        cluster_label++;
+    // Label clusters in order of their roots.
+    int64_t cluster_label = 0;
+    for (PointId idx = 0; idx < size; ++idx)
+        if (core[idx] && sets.get(idx) == idx)
+            view.setField(Id::ClusterID, idx, cluster_label++);
+    for (PointId idx = 0; idx < size; ++idx)
+    {
+        PointId root = sets.get(idx);
+        if (root == None)
+            view.setField(Id::ClusterID, idx, -1);
+        else if (root != idx)
+            view.setField(Id::ClusterID, idx,
+                view.getFieldAs<int64_t>(Id::ClusterID, root));
     }
+    double clusterTime = elapsed(start);
+
+    // Working memory: the copied coordinates and the index's point
+    // order, plus the union-find and core flags.
+    const uint64_t memory = size * (m_dimIdList.size() * sizeof(double) +
+        sizeof(size_t) + sizeof(std::atomic<PointId>) + sizeof(char));
+
+    m_clusters += cluster_label;
+    m_memory = (std::max)(m_memory, memory);
+    m_indexTime += indexTime;
+    m_coreTime += coreTime;
+    m_clusterTime += clusterTime;
+}
+
+void DBSCANFilter::done(PointTableRef table)
+{
+    m_metadata.add("clusters", m_clusters, "Number of clusters found");
+    m_metadata.add("estimated_memory", m_memory,
+        "Estimated memory used by the index and clustering (bytes)");
+    m_metadata.add("index_time", m_indexTime,
+        "Time spent building the index (seconds)");
+    m_metadata.add("core_time", m_coreTime,
+        "Time spent finding core points (seconds)");
+    m_metadata.add("cluster_time", m_clusterTime,
+        "Time spent joining and labeling clusters (seconds)");
 }
 
 } // namespace pdal
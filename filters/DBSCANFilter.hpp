@@ -58,11 +58,23 @@ private:
     double m_eps;
     StringList m_dimStringList;
     Dimension::IdList m_dimIdList;
+    int m_threads;
+    KDStorage m_kdStorage;
+
+    // Statistics accumulated over all views and reported in done().
+    int64_t m_clusters;
+    uint64_t m_memory;
+    double m_indexTime;
+    double m_coreTime;
+    double m_clusterTime;
 
     virtual void addArgs(ProgramArgs& args);
     virtual void addDimensions(PointLayoutPtr layout);
+    virtual void initialize();
     virtual void prepared(PointTableRef table);
+    virtual void ready(PointTableRef table);
     virtual void filter(PointView& view);
+    virtual void done(PointTableRef table);
 };
 
 } // namespace pdal
@@ -38,6 +38,7 @@
 #include <vector>
 
 #include <pdal/private/gdal/Raster.hpp>
+#include <pdal/private/gdal/RasterSampler.hpp>
 #include "private/DimRange.hpp"
 
 namespace pdal
@@ -59,6 +60,7 @@ struct DEMArgs
     DimRange m_range;
     std::string m_raster;
     int32_t m_band;
+    size_t m_cacheSize;
 };
 
 
@@ -83,6 +85,8 @@ void DEMFilter::addArgs(ProgramArgs& args)
     args.add("limits", "Dimension limits for filtering", m_args->m_range).setPositional();
     args.add("raster", "GDAL-readable raster to use for DEM", m_args->m_raster).setPositional();
     args.add("band", "Band number to filter (count from 1)", m_args->m_band, 1);
+    args.add("cache_size", "Memory used to cache raster blocks (MB)",
+        m_args->m_cacheSize, (size_t)256);
 
 }
 
@@ -90,6 +94,8 @@ void DEMFilter::ready(PointTableRef table)
 {
     m_raster.reset(new gdal::Raster(m_args->m_raster));
     m_raster->open();
+    m_sampler.reset(new gdal::RasterSampler(*m_raster,
+        m_args->m_cacheSize * 1024 * 1024));
 }
 
 
@@ -108,18 +114,15 @@ void DEMFilter::prepared(PointTableRef table)
 
 bool DEMFilter::processOne(PointRef& point)
 {
-    static std::vector<double> data;
-    static std::array<double, 2> pix;
-
     double x = point.getFieldAs<double>(Dimension::Id::X);
     double y = point.getFieldAs<double>(Dimension::Id::Y);
     double z = point.getFieldAs<double>(m_args->m_dim);
 
     bool passes(false);
 
-    if (m_raster->read(x, y, data, pix) == gdal::GDALError::None)
+    double v;
+    if (m_sampler->sample(x, y, m_args->m_band, v))
     {
-        double v = data[m_args->m_band-1];
         double lb = v - m_args->m_range.m_lower_bound;
         double ub = v + m_args->m_range.m_upper_bound;
 
@@ -46,7 +46,11 @@ namespace pdal
 
 struct DEMArgs;
 
-namespace gdal { class Raster; }
+namespace gdal
+{
+    class Raster;
+    class RasterSampler;
+}
 class Options;
 class PointLayout;
 class PointView;
@@ -63,6 +67,7 @@ private:
 
     std::unique_ptr<DEMArgs> m_args;
     std::unique_ptr<gdal::Raster> m_raster;
+    std::unique_ptr<gdal::RasterSampler> m_sampler;
 
     virtual void ready(PointTableRef table);
     virtual void addArgs(ProgramArgs& args);
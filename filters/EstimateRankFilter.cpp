@@ -34,6 +34,7 @@
 
 #include "EstimateRankFilter.hpp"
 
+#include <algorithm>
 #include <string>
 
 #include <pdal/KDIndex.hpp>
@@ -64,6 +65,17 @@ void EstimateRankFilter::addArgs(ProgramArgs& args)
 {
     args.add("knn", "k-Nearest Neighbors", m_knn, 8);
     args.add("thresh", "Threshold", m_thresh, 0.01);
+    args.add("threads", "Number of threads used to run this filter", m_threads,
+             1);
+    args.add("kd_storage", "Storage of coordinates in the KD index "
+        "(view, double, float)", m_kdStorage, KDStorage::Double);
+}
+
+
+void EstimateRankFilter::initialize()
+{
+    if (m_threads < 1)
+        throwError("Option 'threads' must be greater than 0.");
 }
 
 
@@ -74,12 +86,19 @@ void EstimateRankFilter::addDimensions(PointLayoutPtr layout)
 
 void EstimateRankFilter::filter(PointView& view)
 {
-    const KD3Index& kdi = view.build3dIndex();
+    const KD3Index& kdi = view.build3dIndex(m_kdStorage, m_threads);
 
-    for (PointRef p : view)
+    for (PointId first = 0; first < view.size(); first += KDQueryBatchSize)
     {
-        PointIdList ids = kdi.neighbors(p, m_knn);
-        p.setField(Id::Rank, math::computeRank(view, ids, m_thresh));
+        point_count_t count = (std::min)(KDQueryBatchSize,
+            view.size() - first);
+        KDNeighbors nbrs = kdi.knnBatch(first, count, m_knn, m_threads);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            PointIdList ids(nbrs.ids(i), nbrs.ids(i) + nbrs.count(i));
+            view.setField(Id::Rank, first + i,
+                math::computeRank(view, ids, m_thresh));
+        }
     }
 }
 
@@ -57,9 +57,12 @@ public:
 private:
     int m_knn;
     double m_thresh;
+    int m_threads;
+    KDStorage m_kdStorage;
 
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void addArgs(ProgramArgs& args);
+    virtual void initialize();
     virtual void filter(PointView& view);
 };
 
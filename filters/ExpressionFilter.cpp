@@ -34,6 +34,7 @@
 
 #include "ExpressionFilter.hpp"
 
+#include <pdal/PointSpan.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 #include <pdal/util/Utils.hpp>
 #include "./private/expr/ConditionalExpression.hpp"
@@ -109,6 +110,16 @@ bool ExpressionFilter::processOne(PointRef& point)
 }
 
 
+void ExpressionFilter::processBatch(PointSpan& span)
+{
+    std::vector<char> pass;
+    m_args->m_expression.eval(span, pass);
+    for (point_count_t i = 0; i < span.size(); ++i)
+        if (!pass[i])
+            span.skip(i);
+}
+
+
 PointViewSet ExpressionFilter::run(PointViewPtr inView)
 {
     PointViewSet viewSet;
@@ -117,11 +128,11 @@ PointViewSet ExpressionFilter::run(PointViewPtr inView)
     if (!inView->size())
         return viewSet;
 
-    for (PointRef p : *inView)
-    {
-        if (processOne(p))
-            outView->appendPoint(*inView, p.pointId());
-    }
+    std::vector<char> pass;
+    m_args->m_expression.eval(*inView, pass);
+    for (PointId id = 0; id < inView->size(); ++id)
+        if (pass[id])
+            outView->appendPoint(*inView, id);
 
     viewSet.insert(outView);
     return viewSet;
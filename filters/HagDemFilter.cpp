@@ -34,7 +34,11 @@
 
 #include "HagDemFilter.hpp"
 
+#include <algorithm>
+
+#include <pdal/PointSpan.hpp>
 #include <pdal/private/gdal/Raster.hpp>
+#include <pdal/private/gdal/RasterSampler.hpp>
 
 namespace pdal
 {
@@ -58,6 +62,10 @@ HagDemFilter::HagDemFilter()
 {}
 
 
+HagDemFilter::~HagDemFilter()
+{}
+
+
 void HagDemFilter::addArgs(ProgramArgs& args)
 {
     args.add("raster", "GDAL-readable raster to use for DEM (uses band 1, "
@@ -66,6 +74,8 @@ void HagDemFilter::addArgs(ProgramArgs& args)
     args.add("zero_ground", "If true, set HAG of ground-classified points "
         "to 0 rather than comparing Z value to raster DEM",
         m_zeroGround, true);
+    args.add("cache_size", "Memory used to cache raster blocks (MB)",
+        m_cacheSize, (size_t)256);
 }
 
 
@@ -79,6 +89,8 @@ void HagDemFilter::ready(PointTableRef table)
 {
     m_raster.reset(new gdal::Raster(m_rasterName));
     m_raster->open();
+    m_sampler.reset(new gdal::RasterSampler(*m_raster,
+        m_cacheSize * 1024 * 1024));
 }
 
 void HagDemFilter::prepared(PointTableRef table)
@@ -87,21 +99,59 @@ void HagDemFilter::prepared(PointTableRef table)
         throwError("Band must be greater than 0");
 }
 
+// Sample the raster for blocks of points at once so that each raster
+// block is read once for all the points that fall in it.
 void HagDemFilter::filter(PointView& view)
 {
+    using namespace pdal::Dimension;
+
+    // Points are sampled in blocks to limit the size of the buffers.
+    const point_count_t BlockSize = 1 << 20;
+
+    const std::vector<int> bands { m_band };
+    std::vector<PointId> ids;
+    std::vector<double> x, y, values;
+    std::vector<char> valid;
     PointRef point(view, 0);
-    for (PointId i = 0; i < view.size(); ++i)
+    for (PointId start = 0; start < view.size(); start += BlockSize)
     {
-        point.setPointId(i);
-        processOne(point);
+        const PointId end = (std::min)(start + BlockSize, view.size());
+        ids.clear();
+        x.clear();
+        y.clear();
+        for (PointId i = start; i < end; ++i)
+        {
+            point.setPointId(i);
+            // If "zero_ground" option is set, all ground points get HAG of 0
+            if (m_zeroGround &&
+                point.getFieldAs<uint8_t>(Id::Classification) ==
+                    ClassLabel::Ground)
+            {
+                point.setField(Id::HeightAboveGround, 0);
+                continue;
+            }
+            ids.push_back(i);
+            x.push_back(point.getFieldAs<double>(Id::X));
+            y.push_back(point.getFieldAs<double>(Id::Y));
+        }
+
+        // If raster has a point at X, Y of pointcloud point, use it.
+        // Otherwise the HAG value is not set.
+        m_sampler->sample(x, y, bands, values, valid);
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            if (!valid[i])
+                continue;
+            point.setPointId(ids[i]);
+            double z = point.getFieldAs<double>(Id::Z);
+            point.setField(Id::HeightAboveGround, z - values[i]);
+        }
     }
 }
 
 bool HagDemFilter::processOne(PointRef& point)
 {
     using namespace pdal::Dimension;
-    static std::vector<double> data;
-    static std::array<double, 2> pix;
 
     // If "zero_ground" option is set, all ground points get HAG of 0
     if (m_zeroGround &&
@@ -116,14 +166,37 @@ bool HagDemFilter::processOne(PointRef& point)
 
         // If raster has a point at X, Y of pointcloud point, use it.
         // Otherwise the HAG value is not set.
-        if (m_raster->read(x, y, data, pix ) == gdal::GDALError::None)
+        double v;
+        if (m_sampler->sample(x, y, m_band, v))
         {
             double z = point.getFieldAs<double>(Id::Z);
-            double hag = z - data[m_band - 1];
-            point.setField(Dimension::Id::HeightAboveGround, hag);
+            point.setField(Dimension::Id::HeightAboveGround, z - v);
         }
     }
     return true;
 }
 
+void HagDemFilter::processBatch(PointSpan& span)
+{
+    using namespace pdal::Dimension;
+
+    std::vector<double> x, y, z, values;
+    std::vector<uint8_t> classes;
+    std::vector<char> valid;
+    span.getField(Id::X, x);
+    span.getField(Id::Y, y);
+    span.getField(Id::Z, z);
+    span.getField(Id::Classification, classes);
+
+    m_sampler->sample(x, y, { m_band }, values, valid);
+    for (point_count_t i = 0; i < span.size(); ++i)
+    {
+        PointRef point(span.table(), span.id(i));
+        if (m_zeroGround && classes[i] == ClassLabel::Ground)
+            point.setField(Id::HeightAboveGround, 0);
+        else if (valid[i])
+            point.setField(Id::HeightAboveGround, z[i] - values[i]);
+    }
+}
+
 } // namespace pdal
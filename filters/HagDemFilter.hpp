@@ -40,11 +40,16 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace pdal
 {
 
-namespace gdal { class Raster; }
+namespace gdal
+{
+    class Raster;
+    class RasterSampler;
+}
 class Options;
 class PointLayout;
 class PointView;
@@ -53,6 +58,7 @@ class PDAL_DLL HagDemFilter : public Filter, public Streamable
 {
 public:
     HagDemFilter();
+    ~HagDemFilter();
     HagDemFilter& operator=(const HagDemFilter&) = delete;
     HagDemFilter(const HagDemFilter&) = delete;
 
@@ -65,11 +71,14 @@ private:
     virtual void ready(PointTableRef table);
     virtual void filter(PointView& view);
     virtual bool processOne(PointRef& point);
+    virtual void processBatch(PointSpan& span);
 
     std::unique_ptr<gdal::Raster> m_raster;
+    std::unique_ptr<gdal::RasterSampler> m_sampler;
     std::string m_rasterName;
     bool m_zeroGround;
     int32_t m_band;
+    size_t m_cacheSize;
 };
 
 } // namespace pdal
@@ -102,6 +102,9 @@ void HagNnFilter::addArgs(ProgramArgs& args)
         "[Default: None]", m_maxDistance);
     args.add("allow_extrapolation", "If true and count > 1, allow "
         "extrapolation [Default: true].", m_allowExtrapolation, true);
+    args.add("kd_storage", "Storage of coordinates in the KD index "
+        "(view, double, float) [Default: double].", m_kdStorage,
+        KDStorage::Double);
 }
 
 
@@ -152,7 +155,7 @@ void HagNnFilter::filter(PointView& view)
     }
 
     // Build the 2D KD-tree.
-    const KD2Index& kdi = gView->build2dIndex();
+    const KD2Index& kdi = gView->build2dIndex(m_kdStorage);
 
     double maxDistance2 = std::pow(m_maxDistance, 2.0);
     // Find Z difference between non-ground points and the nearest
@@ -65,6 +65,7 @@ private:
     bool m_allowExtrapolation;
     double m_maxDistance;
     point_count_t m_count;
+    KDStorage m_kdStorage;
 };
 
 } // namespace pdal
@@ -36,6 +36,7 @@
 
 #include <pdal/KDIndex.hpp>
 
+#include <cmath>
 #include <string>
 #include <vector>
 
@@ -61,6 +62,16 @@ std::string LOFFilter::getName() const
 void LOFFilter::addArgs(ProgramArgs& args)
 {
     args.add("minpts", "Minimum number of points", m_minpts, (size_t)10);
+    args.add("threads", "Number of threads used to run this filter", m_threads,
+             1);
+    args.add("kd_storage", "Storage of coordinates in the KD index "
+        "(view, double, float)", m_kdStorage, KDStorage::Double);
+}
+
+void LOFFilter::initialize()
+{
+    if (m_threads < 1)
+        throwError("Option 'threads' must be greater than 0.");
 }
 
 void LOFFilter::addDimensions(PointLayoutPtr layout)
@@ -72,7 +83,7 @@ void LOFFilter::addDimensions(PointLayoutPtr layout)
 
 void LOFFilter::filter(PointView& view)
 {
-    const KD3Index& index = view.build3dIndex();
+    const KD3Index& index = view.build3dIndex(m_kdStorage, m_threads);
 
     // Increment the minimum number of points, as knnSearch will be returning
     // the neighbors along with the query point.
@@ -82,22 +93,11 @@ void LOFFilter::filter(PointView& view)
     // The k-distance is the Euclidean distance to k-th nearest neighbor.
     log()->get(LogLevel::Debug) << "Computing k-distances...\n";
 
-    typedef std::pair<PointId, size_t> PointIdKPair;
-    typedef std::pair<PointId, double> PointIdDistPair;
-    typedef std::map<PointIdKPair, PointIdDistPair> AdjacencyMap;
-    AdjacencyMap mat;
-
+    KDNeighbors nbrs = index.knnBatch(0, view.size(), m_minpts, m_threads);
+    for (double& d : nbrs.m_sqrDists)
+        d = std::sqrt(d);
     for (PointId i = 0; i < view.size(); ++i)
-    {
-        PointIdList indices(m_minpts);
-        std::vector<double> sqr_dists(m_minpts);
-        index.knnSearch(i, m_minpts, &indices, &sqr_dists);
-
-        for (size_t j = 0; j < m_minpts; ++j)
-            mat[std::make_pair(i, j)] = std::make_pair(indices[j], std::sqrt(sqr_dists[j]));
-
-        view.setField(Id::NNDistance, i, std::sqrt(sqr_dists[m_minpts - 1]));
-    }
+        view.setField(Id::NNDistance, i, nbrs.sqrDists(i)[nbrs.count(i) - 1]);
 
     // Second pass: Compute the local reachability distance for each point.
     // For each neighbor point, the reachability distance is the maximum value
@@ -107,13 +107,14 @@ void LOFFilter::filter(PointView& view)
     log()->get(LogLevel::Debug) << "Computing lrd...\n";
     for (PointId i = 0; i < view.size(); ++i)
     {
+        const PointId *ids = nbrs.ids(i);
+        const double *dists = nbrs.sqrDists(i);
         double M1 = 0.0;
         point_count_t n = 0;
-        for (size_t j = 0; j < m_minpts; ++j)
+        for (size_t j = 0; j < nbrs.count(i); ++j)
         {
-            auto val = mat[std::make_pair(i, j)];
-            double k = view.getFieldAs<double>(Id::NNDistance, val.first);
-            double reachdist = (std::max)(k, val.second);
+            double k = view.getFieldAs<double>(Id::NNDistance, ids[j]);
+            double reachdist = (std::max)(k, dists[j]);
             M1 += (reachdist - M1) / ++n;
         }
         view.setField(Id::LocalReachabilityDistance, i, 1.0 / M1);
@@ -124,15 +125,14 @@ void LOFFilter::filter(PointView& view)
     log()->get(LogLevel::Debug) << "Computing LOF...\n";
     for (PointId i = 0; i < view.size(); ++i)
     {
+        const PointId *ids = nbrs.ids(i);
         double lrdp = view.getFieldAs<double>(Id::LocalReachabilityDistance, i);
         double M1 = 0.0;
         point_count_t n = 0;
-        for (size_t j = 0; j < m_minpts; ++j)
+        for (size_t j = 0; j < nbrs.count(i); ++j)
         {
-            auto val = mat[std::make_pair(i, j)];
-            PointRef p = view.point(val.first);
-            double ratio =
-                p.getFieldAs<double>(Id::LocalReachabilityDistance) / lrdp;
+            double ratio = view.getFieldAs<double>(
+                Id::LocalReachabilityDistance, ids[j]) / lrdp;
             M1 += (ratio - M1) / ++n;
         }
         view.setField(Id::LocalOutlierFactor, i, M1);
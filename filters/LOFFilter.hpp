@@ -55,8 +55,11 @@ public:
 
 private:
     size_t m_minpts;
+    int m_threads;
+    KDStorage m_kdStorage;
 
     virtual void addArgs(ProgramArgs& args);
+    virtual void initialize();
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void filter(PointView& view);
 };
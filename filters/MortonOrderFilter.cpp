@@ -33,7 +33,6 @@
 
 #include "MortonOrderFilter.hpp"
 
-#include <climits>
 #include <iostream>
 #include <limits>
 #include <map>
@@ -53,43 +52,55 @@ CREATE_STATIC_STAGE(MortonOrderFilter, s_info)
 
 std::string MortonOrderFilter::getName() const { return s_info.name; }
 
-void MortonOrderFilter::addArgs(ProgramArgs& args)
+std::istream& operator>>(std::istream& in, PointView::SpatialCurve& curve)
 {
-    args.add("reverse", "Reverse Morton", m_reverse, false);
+    std::string s;
+    in >> s;
+
+    s = Utils::tolower(s);
+    if (s == "morton")
+        curve = PointView::SpatialCurve::Morton;
+    else if (s == "hilbert")
+        curve = PointView::SpatialCurve::Hilbert;
+    else
+        in.setstate(std::ios_base::failbit);
+    return in;
 }
 
-//This used to be a lambda, but the VS compiler exploded, I guess.
-typedef std::pair<double, double> Coord;
-namespace
+
+std::ostream& operator<<(std::ostream& out,
+    const PointView::SpatialCurve& curve)
 {
-bool less_msb(const int& x, const int& y)
+    switch (curve)
+    {
+    case PointView::SpatialCurve::Morton:
+        out << "morton";
+        break;
+    case PointView::SpatialCurve::Hilbert:
+        out << "hilbert";
+        break;
+    }
+    return out;
+}
+
+void MortonOrderFilter::addArgs(ProgramArgs& args)
 {
-    return x < y && x < (x ^ y);
+    args.add("reverse", "Reverse Morton", m_reverse, false);
+    args.add("curve", "Space-filling curve along which to order points: "
+        "morton or hilbert", m_curve, PointView::SpatialCurve::Morton);
+    args.add("is3d", "Order points by X, Y and Z rather than X and Y",
+        m_is3d, false);
+    args.add("threads", "Number of threads used to run this filter",
+        m_threads, 1);
 }
 
-class CmpZOrder
+void MortonOrderFilter::initialize()
 {
-public:
-    bool operator()(const Coord& c1, const Coord& c2) const
-    {
-        int a[2] = {(int)(c1.first * INT_MAX), (int)(c1.second * INT_MAX)};
-        int b[2] = {(int)(c2.first * INT_MAX), (int)(c2.second * INT_MAX)};
-
-        int j = 0;
-        int x = 0;
-
-        for (int k = 0; k < 2; k++)
-        {
-            int y = a[k] ^ b[k];
-            if (less_msb(x, y))
-            {
-                j = k;
-                x = y;
-            }
-        }
-        return (a[j] - b[j]) < 0;
-    };
-};
+    if (m_threads < 1)
+        throwError("Option 'threads' must be greater than 0.");
+    if (m_reverse && (m_curve != PointView::SpatialCurve::Morton || m_is3d))
+        throwError("Option 'reverse' can't be used with a 'curve' other "
+            "than 'morton' or with 'is3d'.");
 }
 
 class ReverseZOrder
@@ -185,31 +196,9 @@ PointViewSet MortonOrderFilter::morton(PointViewPtr inView)
     PointViewSet viewSet;
     if (!inView->size())
         return viewSet;
-    CmpZOrder compare;
-    std::multimap<Coord, PointId, CmpZOrder> sorted(compare);
-
-    BOX2D buffer_bounds;
-    inView->calculateBounds(buffer_bounds);
-    double xrange = buffer_bounds.maxx - buffer_bounds.minx;
-    double yrange = buffer_bounds.maxy - buffer_bounds.miny;
-
-    for (PointId idx = 0; idx < inView->size(); idx++)
-    {
-        double xpos = (inView->getFieldAs<double>(Dimension::Id::X, idx) -
-            buffer_bounds.minx) / xrange;
-        double ypos = (inView->getFieldAs<double>(Dimension::Id::Y, idx) -
-            buffer_bounds.miny) / yrange;
-        Coord loc(xpos, ypos);
-        sorted.insert(std::make_pair(loc, idx));
-    }
 
-    PointViewPtr outView = inView->makeNew();
-    std::multimap<Coord, PointId, CmpZOrder>::iterator pos;
-    for (pos = sorted.begin(); pos != sorted.end(); ++pos)
-    {
-        outView->appendPoint(*inView, pos->second);
-    }
-    viewSet.insert(outView);
+    inView->spatialSort(m_curve, m_is3d, (size_t)m_threads);
+    viewSet.insert(inView);
 
     return viewSet;
 }
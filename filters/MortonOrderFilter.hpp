@@ -51,12 +51,16 @@ public:
 
 private:
     virtual void addArgs(ProgramArgs& args);
+    virtual void initialize();
     virtual PointViewSet run(PointViewPtr view);
 
     PointViewSet reverseMorton(PointViewPtr view);
     PointViewSet morton(PointViewPtr view);
 
     bool m_reverse = false;
+    PointView::SpatialCurve m_curve;
+    bool m_is3d;
+    int m_threads;
 };
 
 } // namespace pdal
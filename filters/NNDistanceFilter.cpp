@@ -34,6 +34,7 @@
 
 #include "NNDistanceFilter.hpp"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -94,6 +95,17 @@ void NNDistanceFilter::addArgs(ProgramArgs& args)
 {
     args.add("mode", "Distance computation mode (kth, avg)", m_mode, Mode::Kth);
     args.add("k", "k neighbors", m_k, size_t(10));
+    args.add("threads", "Number of threads used to run this filter", m_threads,
+             1);
+    args.add("kd_storage", "Storage of coordinates in the KD index "
+        "(view, double, float)", m_kdStorage, KDStorage::Double);
+}
+
+
+void NNDistanceFilter::initialize()
+{
+    if (m_threads < 1)
+        throwError("Option 'threads' must be greater than 0.");
 }
 
 
@@ -108,7 +120,7 @@ void NNDistanceFilter::filter(PointView& view)
     using namespace Dimension;
 
     // Build the 3D KD-tree.
-    KD3Index& index = view.build3dIndex();
+    KD3Index& index = view.build3dIndex(m_kdStorage, m_threads);
 
     // Increment the minimum number of points, as knnSearch will be returning
     // the query point along with the neighbors.
@@ -117,24 +129,27 @@ void NNDistanceFilter::filter(PointView& view)
     // Compute the k-distance for each point. The k-distance is the Euclidean
     // distance to k-th nearest neighbor.
     log()->get(LogLevel::Debug) << "Computing k-distances...\n";
-    for (PointId idx = 0; idx < view.size(); ++idx)
+    for (PointId first = 0; first < view.size(); first += KDQueryBatchSize)
     {
-        PointIdList indices(k);
-        std::vector<double> sqr_dists(k);
-        index.knnSearch(idx, k, &indices, &sqr_dists);
-        double val;
-        if (m_mode == Mode::Kth)
-            val = std::sqrt(sqr_dists[k - 1]);
-        else // m_mode == Mode::Average
+        point_count_t count = (std::min)(KDQueryBatchSize,
+            view.size() - first);
+        KDNeighbors nbrs = index.knnBatch(first, count, k, m_threads);
+        for (std::size_t q = 0; q < count; ++q)
         {
-            val = 0;
-
-            // We start at 1 since index 0 is the test point.
-            for (size_t i = 1; i < k; ++i)
-                val += std::sqrt(sqr_dists[i]);
-            val /= (k - 1);
+            const double *sqr_dists = nbrs.sqrDists(q);
+            const size_t found = nbrs.count(q);
+            double val = 0;
+            if (m_mode == Mode::Kth)
+                val = std::sqrt(sqr_dists[found - 1]);
+            else if (found > 1) // m_mode == Mode::Average
+            {
+                // We start at 1 since index 0 is the test point.
+                for (size_t i = 1; i < found; ++i)
+                    val += std::sqrt(sqr_dists[i]);
+                val /= (found - 1);
+            }
+            view.setField(Dimension::Id::NNDistance, first + q, val);
         }
-        view.setField(Dimension::Id::NNDistance, idx, val);
     }
 }
 
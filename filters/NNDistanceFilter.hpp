@@ -62,8 +62,11 @@ private:
 
     size_t m_k;
     Mode m_mode;
+    int m_threads;
+    KDStorage m_kdStorage;
 
     virtual void addArgs(ProgramArgs& args);
+    virtual void initialize();
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void filter(PointView& view);
 
@@ -44,11 +44,13 @@
 #include "private/Point.hpp"
 
 #include <pdal/KDIndex.hpp>
+#include <pdal/util/Executor.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 #include <pdal/private/MathUtils.hpp>
 
 #include <Eigen/Dense>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -70,6 +72,8 @@ struct NormalArgs
     filter::Point m_viewpoint;
     bool m_up;
     bool m_refine;
+    int m_threads;
+    KDStorage m_kdStorage;
 };
 
 NormalFilter::NormalFilter() : m_args(new NormalArgs), m_count(0) {}
@@ -91,6 +95,10 @@ void NormalFilter::addArgs(ProgramArgs& args)
     args.add("refine",
              "Refine normals using minimum spanning tree propagation?",
              m_args->m_refine, false);
+    args.add("threads", "Number of threads used to run this filter",
+             m_args->m_threads, 1);
+    args.add("kd_storage", "Storage of coordinates in the KD index "
+        "(view, double, float)", m_args->m_kdStorage, KDStorage::Double);
 }
 
 void NormalFilter::addDimensions(PointLayoutPtr layout)
@@ -110,6 +118,12 @@ void NormalFilter::doFilter(PointView& view, int knn)
     filter(view);
 }
 
+void NormalFilter::initialize()
+{
+    if (m_args->m_threads < 1)
+        throwError("Option 'threads' must be greater than 0.");
+}
+
 void NormalFilter::prepared(PointTableRef table)
 {
     if (m_args->m_up && m_viewpointArg->set())
@@ -127,53 +141,73 @@ void NormalFilter::prepared(PointTableRef table)
 void NormalFilter::compute(PointView& view, KD3Index& kdi)
 {
     log()->get(LogLevel::Debug) << "Computing normal vectors\n";
-    for (auto&& p : view)
+    for (PointId first = 0; first < view.size(); first += KDQueryBatchSize)
     {
-        // Perform eigen decomposition of covariance matrix computed from
-        // neighborhood composed of k-nearest neighbors.
-        PointIdList neighbors = kdi.neighbors(p.pointId(), m_args->m_knn);
-        auto B = math::computeCovariance(view, neighbors);
-        SelfAdjointEigenSolver<Matrix3d> solver(B);
-        if (solver.info() != Success)
-            throwError("Cannot perform eigen decomposition.");
-
-        // The curvature is computed as the ratio of the first (smallest)
-        // eigenvalue to the sum of all eigenvalues.
-        auto eval = solver.eigenvalues();
-        double sum = eval[0] + eval[1] + eval[2];
-        double curvature = sum ? std::fabs(eval[0] / sum) : 0;
-
-        // The normal is defined by the eigenvector corresponding to the
-        // smallest eigenvalue.
-        Vector3d normal = solver.eigenvectors().col(0);
-
-        if (m_viewpointArg->set())
-        {
-            // If a viewpoint has been specified, orient the normals to face the
-            // viewpoint by taking the dot product of the vector connecting the
-            // point with the viewpoint and the normal. Flip the normal, where
-            // the dot product is negative.
-            double dx = m_args->m_viewpoint.x() - p.getFieldAs<double>(Id::X);
-            double dy = m_args->m_viewpoint.y() - p.getFieldAs<double>(Id::Y);
-            double dz = m_args->m_viewpoint.z() - p.getFieldAs<double>(Id::Z);
-            Vector3d vp(dx, dy, dz);
-            if (vp.dot(normal) < 0)
-                normal *= -1.0;
-        }
-        else if (m_args->m_up)
+        point_count_t count = (std::min)(KDQueryBatchSize,
+            view.size() - first);
+        KDNeighbors nbrs = kdi.knnBatch(first, count, m_args->m_knn,
+            m_args->m_threads);
+        // Each point's normal is written only to that point.
+        parallelRange(count, (std::size_t)m_args->m_threads,
+            [&](std::size_t begin, std::size_t end)
         {
-            // If normals are expected to be upward facing, invert them when the
-            // Z component is negative.
-            if (normal[2] < 0)
-                normal *= -1.0;
-        }
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                PointRef p(view, first + i);
+                PointIdList neighbors(nbrs.ids(i),
+                    nbrs.ids(i) + nbrs.count(i));
+                computeNormal(view, p, neighbors);
+            }
+        });
+    }
+}
 
-        // Set the computed normal and curvature dimensions.
-        p.setField(Id::NormalX, normal[0]);
-        p.setField(Id::NormalY, normal[1]);
-        p.setField(Id::NormalZ, normal[2]);
-        p.setField(Id::Curvature, curvature);
+void NormalFilter::computeNormal(PointView& view, PointRef& p,
+    const PointIdList& neighbors)
+{
+    // Perform eigen decomposition of covariance matrix computed from
+    // neighborhood composed of k-nearest neighbors.
+    auto B = math::computeCovariance(view, neighbors);
+    SelfAdjointEigenSolver<Matrix3d> solver(B);
+    if (solver.info() != Success)
+        throwError("Cannot perform eigen decomposition.");
+
+    // The curvature is computed as the ratio of the first (smallest)
+    // eigenvalue to the sum of all eigenvalues.
+    auto eval = solver.eigenvalues();
+    double sum = eval[0] + eval[1] + eval[2];
+    double curvature = sum ? std::fabs(eval[0] / sum) : 0;
+
+    // The normal is defined by the eigenvector corresponding to the
+    // smallest eigenvalue.
+    Vector3d normal = solver.eigenvectors().col(0);
+
+    if (m_viewpointArg->set())
+    {
+        // If a viewpoint has been specified, orient the normals to face the
+        // viewpoint by taking the dot product of the vector connecting the
+        // point with the viewpoint and the normal. Flip the normal, where
+        // the dot product is negative.
+        double dx = m_args->m_viewpoint.x() - p.getFieldAs<double>(Id::X);
+        double dy = m_args->m_viewpoint.y() - p.getFieldAs<double>(Id::Y);
+        double dz = m_args->m_viewpoint.z() - p.getFieldAs<double>(Id::Z);
+        Vector3d vp(dx, dy, dz);
+        if (vp.dot(normal) < 0)
+            normal *= -1.0;
     }
+    else if (m_args->m_up)
+    {
+        // If normals are expected to be upward facing, invert them when the
+        // Z component is negative.
+        if (normal[2] < 0)
+            normal *= -1.0;
+    }
+
+    // Set the computed normal and curvature dimensions.
+    p.setField(Id::NormalX, normal[0]);
+    p.setField(Id::NormalY, normal[1]);
+    p.setField(Id::NormalZ, normal[2]);
+    p.setField(Id::Curvature, curvature);
 }
 
 void NormalFilter::update(
@@ -277,7 +311,8 @@ void NormalFilter::refine(PointView& view, KD3Index& kdi)
 
 void NormalFilter::filter(PointView& view)
 {
-    KD3Index& kdi = view.build3dIndex();
+    KD3Index& kdi = view.build3dIndex(m_args->m_kdStorage,
+        m_args->m_threads);
 
     // Compute the normal/curvature and optionally orient toward viewpoint or
     // positive Z.
@@ -89,6 +89,8 @@ private:
     Arg* m_viewpointArg;
 
     void compute(PointView& view, KD3Index& kdi);
+    void computeNormal(PointView& view, PointRef& p,
+        const PointIdList& neighbors);
     void refine(PointView& view, KD3Index& kdi);
     void
     update(PointView& view, KD3Index& kdi, std::vector<bool> inMST,
@@ -97,6 +99,7 @@ private:
 
     virtual void addArgs(ProgramArgs& args);
     virtual void addDimensions(PointLayoutPtr layout);
+    virtual void initialize();
     virtual void prepared(PointTableRef table);
     virtual void filter(PointView& view);
 };
@@ -38,6 +38,7 @@
 #include <pdal/util/ProgramArgs.hpp>
 #include <pdal/util/Utils.hpp>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -67,6 +68,16 @@ void OutlierFilter::addArgs(ProgramArgs& args)
     args.add("mean_k", "Mean number of neighbors", m_meanK, 8);
     args.add("multiplier", "Standard deviation threshold", m_multiplier, 2.0);
     args.add("class", "Class to use for noise points", m_class, ClassLabel::LowPoint);
+    args.add("threads", "Number of threads used to run this filter", m_threads,
+             1);
+    args.add("kd_storage", "Storage of coordinates in the KD index "
+        "(view, double, float)", m_kdStorage, KDStorage::Double);
+}
+
+void OutlierFilter::initialize()
+{
+    if (m_threads < 1)
+        throwError("Option 'threads' must be greater than 0.");
 }
 
 void OutlierFilter::addDimensions(PointLayoutPtr layout)
@@ -76,20 +87,25 @@ void OutlierFilter::addDimensions(PointLayoutPtr layout)
 
 Indices OutlierFilter::processRadius(PointViewPtr inView)
 {
-    KD3Index index(*inView);
-    index.build();
+    KD3Index index(*inView, m_kdStorage);
+    index.build(m_threads);
 
     point_count_t np = inView->size();
 
     PointIdList inliers, outliers;
 
-    for (PointId i = 0; i < np; ++i)
+    for (PointId first = 0; first < np; first += KDQueryBatchSize)
     {
-        auto ids = index.radius(i, m_radius);
-        if (ids.size() > size_t(m_minK))
-            inliers.push_back(i);
-        else
-            outliers.push_back(i);
+        point_count_t count = (std::min)(KDQueryBatchSize, np - first);
+        KDNeighbors nbrs = index.radiusBatch(first, count, m_radius,
+            m_threads);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (nbrs.count(i) > size_t(m_minK))
+                inliers.push_back(first + i);
+            else
+                outliers.push_back(first + i);
+        }
     }
 
     return Indices{inliers, outliers};
@@ -97,8 +113,8 @@ Indices OutlierFilter::processRadius(PointViewPtr inView)
 
 Indices OutlierFilter::processStatistical(PointViewPtr inView)
 {
-    KD3Index index(*inView);
-    index.build();
+    KD3Index index(*inView, m_kdStorage);
+    index.build(m_threads);
 
     point_count_t np = inView->size();
 
@@ -108,21 +124,21 @@ Indices OutlierFilter::processStatistical(PointViewPtr inView)
 
     // we increase the count by one because the query point itself will
     // be included with a distance of 0
-    point_count_t count = m_meanK + 1;
-    PointIdList indices(count);
-    std::vector<double> sqr_dists(count);
-    for (PointId i = 0; i < np; ++i)
+    point_count_t k = m_meanK + 1;
+    for (PointId first = 0; first < np; first += KDQueryBatchSize)
     {
-
-        index.knnSearch(i, count, &indices, &sqr_dists);
-
-        for (size_t j = 1; j < count; ++j)
+        point_count_t count = (std::min)(KDQueryBatchSize, np - first);
+        KDNeighbors nbrs = index.knnBatch(first, count, k, m_threads);
+        for (std::size_t q = 0; q < count; ++q)
         {
-            double delta = std::sqrt(sqr_dists[j]) - distances[i];
-            distances[i] += (delta / j);
+            PointId i = first + q;
+            const double *sqr_dists = nbrs.sqrDists(q);
+            for (size_t j = 1; j < nbrs.count(q); ++j)
+            {
+                double delta = std::sqrt(sqr_dists[j]) - distances[i];
+                distances[i] += (delta / j);
+            }
         }
-        indices.clear(); indices.resize(count);
-        sqr_dists.clear(); sqr_dists.resize(count);
     }
 
     size_t n(0);
@@ -67,9 +67,12 @@ private:
     int m_meanK;
     double m_multiplier;
     uint8_t m_class;
+    int m_threads;
+    KDStorage m_kdStorage;
 
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void addArgs(ProgramArgs& args);
+    virtual void initialize();
     Indices processRadius(PointViewPtr inView);
     Indices processStatistical(PointViewPtr inView);
     virtual PointViewSet run(PointViewPtr view);
@@ -33,6 +33,7 @@
 ****************************************************************************/
 
 #include "OverlayFilter.hpp"
+#include "private/BoxIndex.hpp"
 
 #include <vector>
 
@@ -57,6 +58,14 @@ static StaticPluginInfo const s_info
 CREATE_STATIC_STAGE(OverlayFilter, s_info)
 
 
+OverlayFilter::OverlayFilter() : m_ds(0), m_lyr(0), m_index(new BoxIndex)
+{}
+
+
+OverlayFilter::~OverlayFilter()
+{}
+
+
 void OverlayFilter::addArgs(ProgramArgs& args)
 {
     args.add("dimension", "Dimension on which to filter", m_dimName).
@@ -141,6 +150,19 @@ void OverlayFilter::ready(PointTableRef table)
         feature = OGRFeaturePtr(OGR_L_GetNextFeature(m_lyr), featureDeleter);
     }
     while (feature);
+    buildIndex();
+}
+
+
+// Index the bounds of the polygons so that only the polygons whose bounds
+// contain a point need to be tested.
+void OverlayFilter::buildIndex()
+{
+    std::vector<BOX2D> boxes;
+    boxes.reserve(m_polygons.size());
+    for (const PolyVal& poly : m_polygons)
+        boxes.push_back(poly.geom.bounds().to2d());
+    m_index->build(boxes);
 }
 
 
@@ -154,15 +176,21 @@ void OverlayFilter::spatialReferenceChanged(const SpatialReference& srs)
         if (!ok)
             throwError(ok.what());
     }
+    buildIndex();
 }
 
 
 bool OverlayFilter::processOne(PointRef& point)
 {
-    for (const auto& poly : m_polygons)
+    double x = point.getFieldAs<double>(Dimension::Id::X);
+    double y = point.getFieldAs<double>(Dimension::Id::Y);
+
+    // Candidates are in layer order, so the first polygon in the layer
+    // that contains the point sets the value, as with a linear search.
+    m_index->query(x, y, m_candidates);
+    for (uint32_t i : m_candidates)
     {
-        double x = point.getFieldAs<double>(Dimension::Id::X);
-        double y = point.getFieldAs<double>(Dimension::Id::Y);
+        const PolyVal& poly = m_polygons[i];
         if (poly.geom.contains(x, y))
         {
             point.setField(m_dim, poly.val);
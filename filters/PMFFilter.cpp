@@ -65,6 +65,7 @@ struct PMFArgs
     double m_maxDistance;
     double m_maxWindowSize;
     double m_slope;
+    int m_threads;
 };
 
 CREATE_STATIC_STAGE(PMFFilter, s_info)
@@ -92,6 +93,8 @@ void PMFFilter::addArgs(ProgramArgs& args)
     args.add("max_window_size", "Maximum window size", m_args->m_maxWindowSize,
              33.0);
     args.add("slope", "Slope", m_args->m_slope, 1.0);
+    args.add("threads", "Number of threads used to run this filter",
+        m_args->m_threads, 1);
 }
 
 void PMFFilter::addDimensions(PointLayoutPtr layout)
@@ -103,6 +106,9 @@ void PMFFilter::prepared(PointTableRef table)
 {
     const PointLayoutPtr layout(table.layout());
 
+    if (m_args->m_threads < 1)
+        throwError("Option 'threads' must be greater than 0.");
+
     for (auto& r : m_args->m_ignored)
     {
         r.m_id = layout->findDim(r.m_name);
@@ -322,8 +328,8 @@ void PMFFilter::processGround(PointViewPtr view)
             << ", window size = " << wsvec[j] << ")...\n";
 
         int iters = static_cast<int>(0.5 * (wsvec[j] - 1));
-        math::erodeDiamond(ZImin, rows, cols, iters);
-        math::dilateDiamond(ZImin, rows, cols, iters);
+        math::erodeDiamond(ZImin, rows, cols, iters, m_args->m_threads);
+        math::dilateDiamond(ZImin, rows, cols, iters, m_args->m_threads);
 
         PointIdList groundNewIdx;
         for (PointId const& p_idx : groundIdx)
@@ -34,12 +34,13 @@
 
 #include "ProjPipelineFilter.hpp"
 
+#include <algorithm>
+
+#include <pdal/PointSpan.hpp>
 #include <pdal/PointView.hpp>
 #include <pdal/private/SrsTransform.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 
-#include <ogr_spatialref.h>
-
 namespace pdal
 {
 
@@ -54,7 +55,7 @@ CREATE_STATIC_STAGE(ProjPipelineFilter, s_info)
 
 std::string ProjPipelineFilter::getName() const { return s_info.name; }
 
-ProjPipelineFilter::ProjPipelineFilter()
+ProjPipelineFilter::ProjPipelineFilter() : m_threads(1)
 {}
 
 
@@ -69,11 +70,15 @@ void ProjPipelineFilter::addArgs(ProgramArgs& args)
              m_reverseTransfo, false);
     args.add("coord_op", "Coordinate operation (Proj pipeline or WKT2 string or urn definition)",
              m_coordOperation).setPositional();
+    args.add("threads", "Number of threads used to run this filter",
+        m_threads, 1);
 }
 
 
 void ProjPipelineFilter::initialize()
 {
+    if (m_threads < 1)
+        throwError("Option 'threads' must be greater than 0.");
     setSpatialReference(m_outSRS);
     createTransform(m_coordOperation, m_reverseTransfo);
 }
@@ -81,21 +86,53 @@ void ProjPipelineFilter::initialize()
 
 void ProjPipelineFilter::createTransform(const std::string coordOperation, bool reverseTransfo)
 {
-    m_coordTransform.reset(new CoordTransform(coordOperation, reverseTransfo));
+    // Coordinate transformations can't be shared between threads, so
+    // each thread gets its own copy.
+    SrsTransform transform(coordOperation, reverseTransfo);
+    m_transforms = std::vector<SrsTransform>((size_t)m_threads, transform);
 }
 
 
+// Gather the coordinates of a block of points into contiguous buffers,
+// transform them, possibly in parallel, and scatter the results back.
 PointViewSet ProjPipelineFilter::run(PointViewPtr view)
 {
+    // Transform in blocks to limit the size of the coordinate buffers.
+    const point_count_t BlockSize = 1 << 18;
+
     PointViewSet viewSet;
     PointViewPtr outView = view->makeNew();
 
+    std::vector<double> x, y, z;
+    std::vector<int> ok;
     PointRef point(*view, 0);
-    for (PointId id = 0; id < view->size(); ++id)
+    for (PointId start = 0; start < view->size(); start += BlockSize)
     {
-        point.setPointId(id);
-        if (processOne(point))
-            outView->appendPoint(*view, id);
+        const point_count_t count =
+            (std::min)(BlockSize, view->size() - start);
+        x.resize(count);
+        y.resize(count);
+        z.resize(count);
+        for (point_count_t i = 0; i < count; ++i)
+        {
+            point.setPointId(start + i);
+            x[i] = point.getFieldAs<double>(Dimension::Id::X);
+            y[i] = point.getFieldAs<double>(Dimension::Id::Y);
+            z[i] = point.getFieldAs<double>(Dimension::Id::Z);
+        }
+
+        transform(m_transforms, x, y, z, ok);
+
+        for (point_count_t i = 0; i < count; ++i)
+        {
+            if (!ok[i])
+                continue;
+            point.setPointId(start + i);
+            point.setField(Dimension::Id::X, x[i]);
+            point.setField(Dimension::Id::Y, y[i]);
+            point.setField(Dimension::Id::Z, z[i]);
+            outView->appendPoint(*view, start + i);
+        }
     }
 
     viewSet.insert(outView);
@@ -109,7 +146,7 @@ bool ProjPipelineFilter::processOne(PointRef& point)
     double y(point.getFieldAs<double>(Dimension::Id::Y));
     double z(point.getFieldAs<double>(Dimension::Id::Z));
 
-    bool ok = m_coordTransform->transform(x, y, z);
+    bool ok = m_transforms.front().transform(x, y, z);
     if (ok)
     {
         point.setField(Dimension::Id::X, x);
@@ -119,18 +156,27 @@ bool ProjPipelineFilter::processOne(PointRef& point)
     return ok;
 }
 
-ProjPipelineFilter::CoordTransform::CoordTransform(){}
 
-ProjPipelineFilter::CoordTransform::CoordTransform(const std::string coordOperation, bool reverseTransfo){
-    OGRCoordinateTransformationOptions coordTransfoOptions;
-    coordTransfoOptions.SetCoordinateOperation(coordOperation.c_str(), reverseTransfo);
-    OGRSpatialReference nullSrs("");
-    m_transform.reset(OGRCreateCoordinateTransformation(&nullSrs, &nullSrs, coordTransfoOptions));
-}
-
-bool ProjPipelineFilter::CoordTransform::transform(double &x, double &y, double &z){
-
-    return m_transform && m_transform->Transform(1, &x, &y, &z);
+// Transform all the points of the span with a single call.  Large spans
+// are split among the threads.
+void ProjPipelineFilter::processBatch(PointSpan& span)
+{
+    std::vector<double> x, y, z;
+    std::vector<int> ok;
+    span.getField(Dimension::Id::X, x);
+    span.getField(Dimension::Id::Y, y);
+    span.getField(Dimension::Id::Z, z);
+
+    transform(m_transforms, x, y, z, ok);
+    for (point_count_t i = 0; i < span.size(); ++i)
+        if (!ok[i])
+            span.skip(i);
+
+    // Values of points that failed are written as well, but those points
+    // have been skipped.
+    span.setField(Dimension::Id::X, x);
+    span.setField(Dimension::Id::Y, y);
+    span.setField(Dimension::Id::Z, z);
 }
 
 } // namespace pdal
@@ -37,19 +37,16 @@
 #include <pdal/Filter.hpp>
 #include <pdal/Streamable.hpp>
 
-#include <memory>
-
-class OGRCoordinateTransformation;
+#include <vector>
 
 namespace pdal
 {
 
+class SrsTransform;
 
 class PDAL_DLL ProjPipelineFilter : public Filter, public Streamable
 {
 public:
-    class CoordTransform;
-
     ProjPipelineFilter();
     ~ProjPipelineFilter();
 
@@ -63,26 +60,16 @@ private:
     virtual void initialize();
     virtual PointViewSet run(PointViewPtr view);
     virtual bool processOne(PointRef& point);
+    virtual void processBatch(PointSpan& span);
 
     void createTransform(const std::string coordOperation, bool reverseTransfo);
 
     SpatialReference m_outSRS;
     bool m_reverseTransfo;
     std::string m_coordOperation;
-    std::unique_ptr<CoordTransform> m_coordTransform;
-};
-
-
-class ProjPipelineFilter::CoordTransform
-{
-public:
-    CoordTransform();
-    CoordTransform(const std::string coordOperation, bool reverseTransfo);
-
-    bool transform(double& x, double& y, double& z);
-private:
-    std::unique_ptr<OGRCoordinateTransformation> m_transform;
-
+    int m_threads;
+    // One transform per thread.
+    std::vector<SrsTransform> m_transforms;
 };
 
 } // namespace pdal
@@ -34,6 +34,7 @@
 
 #include "RangeFilter.hpp"
 
+#include <pdal/PointSpan.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 #include <pdal/util/Utils.hpp>
 
@@ -102,6 +103,30 @@ bool RangeFilter::processOne(PointRef& point)
 }
 
 
+// Same logic as processOne(), but each dimension is fetched once for all
+// the points of the span.
+void RangeFilter::processBatch(PointSpan& span)
+{
+    std::vector<double> vals;
+    std::vector<char> passes(span.size());
+
+    auto ri = m_ranges.begin();
+    while (ri != m_ranges.end())
+    {
+        Dimension::Id id = ri->m_id;
+        span.getField(id, vals);
+        std::fill(passes.begin(), passes.end(), 0);
+        for (; ri != m_ranges.end() && ri->m_id == id; ++ri)
+            for (point_count_t i = 0; i < span.size(); ++i)
+                if (!passes[i])
+                    passes[i] = ri->valuePasses(vals[i]);
+        for (point_count_t i = 0; i < span.size(); ++i)
+            if (!passes[i])
+                span.skip(i);
+    }
+}
+
+
 PointViewSet RangeFilter::run(PointViewPtr inView)
 {
     PointViewSet viewSet;
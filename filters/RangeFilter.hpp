@@ -60,7 +60,12 @@ private:
     virtual void addArgs(ProgramArgs& args);
     virtual void prepared(PointTableRef table);
     virtual bool processOne(PointRef& point);
+    virtual void processBatch(PointSpan& span);
     virtual PointViewSet run(PointViewPtr view);
+    virtual bool parallelViewSafe() const
+        { return true; }
+    virtual bool parallelPointSafe() const
+        { return true; }
 
     RangeFilter& operator=(const RangeFilter&) = delete;
     RangeFilter(const RangeFilter&) = delete;
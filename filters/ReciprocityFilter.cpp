@@ -42,8 +42,8 @@
 #include <pdal/KDIndex.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 
+#include <algorithm>
 #include <string>
-#include <thread>
 #include <vector>
 
 namespace pdal
@@ -71,61 +71,73 @@ void ReciprocityFilter::addArgs(ProgramArgs& args)
     args.add("knn", "k-Nearest neighbors", m_knn, 8);
     args.add("threads", "Number of threads used to run this filter", m_threads,
              1);
+    args.add("kd_storage", "Storage of coordinates in the KD index "
+        "(view, double, float)", m_kdStorage, KDStorage::Double);
 }
 
-void ReciprocityFilter::addDimensions(PointLayoutPtr layout)
+void ReciprocityFilter::initialize()
 {
-    layout->registerDim(Id::Reciprocity);
+    if (m_threads < 1)
+        throwError("Option 'threads' must be greater than 0.");
 }
 
-void ReciprocityFilter::filter(PointView& view)
+void ReciprocityFilter::addDimensions(PointLayoutPtr layout)
 {
-    point_count_t nloops = view.size();
-    std::vector<std::thread> threadList(m_threads);
-    for (int t = 0; t < m_threads; t++)
-    {
-        threadList[t] = std::thread(std::bind(
-            [&](const PointId start, const PointId end) {
-                for (PointId i = start; i < end; i++)
-                    setReciprocity(view, i);
-            },
-            t * nloops / m_threads,
-            (t + 1) == m_threads ? nloops : (t + 1) * nloops / m_threads));
-    }
-    for (auto& t : threadList)
-        t.join();
+    layout->registerDim(Id::Reciprocity);
 }
 
-void ReciprocityFilter::setReciprocity(PointView& view, const PointId& i)
+void ReciprocityFilter::filter(PointView& view)
 {
-    // Find k-nearest neighbors of i.
-    const KD3Index& kdi = view.build3dIndex();
-    PointIdList ni = kdi.neighbors(i, m_knn + 1);
+    const KD3Index& kdi = view.build3dIndex(m_kdStorage, m_threads);
 
-    // Initialize number of unidirectional neighbors to 0.
-    point_count_t uni(0);
+    // The query point is returned as a neighbor of itself, so we must
+    // increase k by one to get the desired number of neighbors.
+    const point_count_t k = m_knn + 1;
 
-    // Visit each neighbor of i, finding its k-nearest neighbors. If i is
-    // not a nearest neighbor of one of its neighbors, increment uni.
-    for (PointId const& j : ni)
+    // Each query point requires the neighbors of each of its neighbors, so
+    // limit the number of query points accordingly.
+    const point_count_t batchSize = (std::max)(KDQueryBatchSize / k,
+        (point_count_t)1);
+    for (PointId first = 0; first < view.size(); first += batchSize)
     {
-        // The query point itself will always show up as a neighbor and can
-        // be skipped.
-        if (j == i)
-            continue;
-
-        // Find k-nearest neighbors of j.
-        PointIdList nj = kdi.neighbors(j, m_knn + 1);
-
-        // If i is not a neighbor of j, increment uni.
-        if (std::find(nj.begin(), nj.end(), i) == nj.end())
-            ++uni;
+        point_count_t count = (std::min)(batchSize, view.size() - first);
+
+        // Find the k-nearest neighbors of each point, and the k-nearest
+        // neighbors of each of those neighbors.  The neighbors of the
+        // neighbor at some position are found at the same position of
+        // 'nj'.
+        KDNeighbors ni = kdi.knnBatch(first, count, k, m_threads);
+        KDNeighbors nj = kdi.knnBatch(ni.m_ids, k, m_threads);
+
+        for (std::size_t q = 0; q < count; ++q)
+        {
+            PointId i = first + q;
+
+            // Initialize number of unidirectional neighbors to 0.
+            point_count_t uni(0);
+
+            // Visit each neighbor of i. If i is not a nearest neighbor of one
+            // of its neighbors, increment uni.
+            for (std::size_t pos = ni.m_offsets[q]; pos < ni.m_offsets[q + 1];
+                ++pos)
+            {
+                // The query point itself will always show up as a neighbor
+                // and can be skipped.
+                if (ni.m_ids[pos] == i)
+                    continue;
+
+                const PointId *begin = nj.ids(pos);
+                const PointId *end = begin + nj.count(pos);
+                if (std::find(begin, end, i) == end)
+                    ++uni;
+            }
+
+            // Compute reciprocity as percentage of neighbors that do NOT
+            // contain id as a neighbor.
+            double reciprocity = 100.0 * uni / m_knn;
+            view.setField(Id::Reciprocity, i, reciprocity);
+        }
     }
-
-    // Compute reciprocity as percentage of neighbors that do NOT contain
-    // id as a neighbor.
-    double reciprocity = 100.0 * uni / m_knn;
-    view.setField(Id::Reciprocity, i, reciprocity);
 }
 
 } // namespace pdal
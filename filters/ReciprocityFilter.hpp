@@ -57,12 +57,12 @@ public:
 private:
     int m_knn;
     int m_threads;
+    KDStorage m_kdStorage;
 
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void addArgs(ProgramArgs& args);
+    virtual void initialize();
     virtual void filter(PointView& view);
-
-    void setReciprocity(PointView& view, const PointId& i);
 };
 
 } // namespace pdal
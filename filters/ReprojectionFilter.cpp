@@ -34,6 +34,9 @@
 
 #include "ReprojectionFilter.hpp"
 
+#include <algorithm>
+
+#include <pdal/PointSpan.hpp>
 #include <pdal/PointView.hpp>
 #include <pdal/private/SrsTransform.hpp>
 #include <pdal/util/ProgramArgs.hpp>
@@ -54,7 +57,8 @@ CREATE_STATIC_STAGE(ReprojectionFilter, s_info)
 
 std::string ReprojectionFilter::getName() const { return s_info.name; }
 
-ReprojectionFilter::ReprojectionFilter() : m_inferInputSRS(true)
+ReprojectionFilter::ReprojectionFilter() : m_inferInputSRS(true),
+    m_threads(1)
 {}
 
 
@@ -72,11 +76,15 @@ void ReprojectionFilter::addArgs(ProgramArgs& args)
     args.add("out_coord_epoch", "Output coordinate epoch for transformation", m_outCoordEpochArg);
     args.add("error_on_failure", "Throw an exception if we can't reproject any point",
         m_errorOnFailure);
+    args.add("threads", "Number of threads used to run this filter",
+        m_threads, 1);
 }
 
 
 void ReprojectionFilter::initialize()
 {
+    if (m_threads < 1)
+        throwError("Option 'threads' must be greater than 0.");
     m_inferInputSRS = m_inSRS.empty();
     setSpatialReference(m_outSRS);
 }
@@ -151,44 +159,83 @@ void ReprojectionFilter::createTransform(const SpatialReference& srsSRS)
 
 
     // If either vector is empty, GDAL's default ordering is used.
+    SrsTransform transform;
     if (m_inAxisOrdering.size() || m_outAxisOrdering.size())
-    {
-
-        m_transform.reset(new SrsTransform(m_inSRS,
-                                           m_inAxisOrdering,
-                                           m_outSRS,
-                                           m_outAxisOrdering));
-    } else {
-        m_transform.reset(new SrsTransform(m_inSRS, m_outSRS));
-    }
-
+        transform = SrsTransform(m_inSRS, m_inAxisOrdering,
+            m_outSRS, m_outAxisOrdering);
+    else
+        transform = SrsTransform(m_inSRS, m_outSRS);
 
     if (!pdal::Utils::compare_approx(m_inCoordEpochArg, 0.0f, 0.00f))
     {
-        m_transform->setSrcEpoch(m_inCoordEpochArg);
+        transform.setSrcEpoch(m_inCoordEpochArg);
     }
 
     if (!pdal::Utils::compare_approx(m_outCoordEpochArg, 0.0f, 0.00f))
     {
-        m_transform->setDstEpoch(m_outCoordEpochArg);
+        transform.setDstEpoch(m_outCoordEpochArg);
     }
 
+    // Coordinate transformations can't be shared between threads, so
+    // each thread gets its own copy.
+    m_transforms = std::vector<SrsTransform>((size_t)m_threads, transform);
 }
 
 
+void ReprojectionFilter::throwTransformError(PointRef& point)
+{
+    throwError("Couldn't reproject point with X/Y/Z coordinates of (" +
+        std::to_string(point.getFieldAs<double>(Dimension::Id::X)) + ", " +
+        std::to_string(point.getFieldAs<double>(Dimension::Id::Y)) + ", " +
+        std::to_string(point.getFieldAs<double>(Dimension::Id::Z)) + ").");
+}
+
+
+// Gather the coordinates of a block of points into contiguous buffers,
+// transform them, possibly in parallel, and scatter the results back.
 PointViewSet ReprojectionFilter::run(PointViewPtr view)
 {
+    // Transform in blocks to limit the size of the coordinate buffers.
+    const point_count_t BlockSize = 1 << 18;
+
     PointViewSet viewSet;
     PointViewPtr outView = view->makeNew();
 
     createTransform(view->spatialReference());
 
+    std::vector<double> x, y, z;
+    std::vector<int> ok;
     PointRef point(*view, 0);
-    for (PointId id = 0; id < view->size(); ++id)
+    for (PointId start = 0; start < view->size(); start += BlockSize)
     {
-        point.setPointId(id);
-        if (processOne(point))
-            outView->appendPoint(*view, id);
+        const point_count_t count =
+            (std::min)(BlockSize, view->size() - start);
+        x.resize(count);
+        y.resize(count);
+        z.resize(count);
+        for (point_count_t i = 0; i < count; ++i)
+        {
+            point.setPointId(start + i);
+            x[i] = point.getFieldAs<double>(Dimension::Id::X);
+            y[i] = point.getFieldAs<double>(Dimension::Id::Y);
+            z[i] = point.getFieldAs<double>(Dimension::Id::Z);
+        }
+
+        transform(m_transforms, x, y, z, ok);
+
+        for (point_count_t i = 0; i < count; ++i)
+        {
+            point.setPointId(start + i);
+            if (ok[i])
+            {
+                point.setField(Dimension::Id::X, x[i]);
+                point.setField(Dimension::Id::Y, y[i]);
+                point.setField(Dimension::Id::Z, z[i]);
+                outView->appendPoint(*view, start + i);
+            }
+            else if (m_errorOnFailure)
+                throwTransformError(point);
+        }
     }
 
     viewSet.insert(outView);
@@ -202,7 +249,7 @@ bool ReprojectionFilter::processOne(PointRef& point)
     double y(point.getFieldAs<double>(Dimension::Id::Y));
     double z(point.getFieldAs<double>(Dimension::Id::Z));
 
-    bool ok = m_transform->transform(x, y, z);
+    bool ok = m_transforms.front().transform(x, y, z);
     if (ok)
     {
         point.setField(Dimension::Id::X, x);
@@ -210,11 +257,40 @@ bool ReprojectionFilter::processOne(PointRef& point)
         point.setField(Dimension::Id::Z, z);
     }
     else if (m_errorOnFailure)
-        throwError("Couldn't reproject point with X/Y/Z coordinates of (" +
-            std::to_string(point.getFieldAs<double>(Dimension::Id::X)) + ", " +
-            std::to_string(point.getFieldAs<double>(Dimension::Id::Y)) + ", " +
-            std::to_string(point.getFieldAs<double>(Dimension::Id::Z)) + ").");
+        throwTransformError(point);
     return ok;
 }
 
+
+// Transform all the points of the span with a single call so that the
+// per-call overhead of the coordinate transformation is amortized.
+// Large spans are split among the threads.
+void ReprojectionFilter::processBatch(PointSpan& span)
+{
+    std::vector<double> x, y, z;
+    std::vector<int> ok;
+    span.getField(Dimension::Id::X, x);
+    span.getField(Dimension::Id::Y, y);
+    span.getField(Dimension::Id::Z, z);
+
+    transform(m_transforms, x, y, z, ok);
+    for (point_count_t i = 0; i < span.size(); ++i)
+    {
+        if (ok[i])
+            continue;
+        if (m_errorOnFailure)
+        {
+            PointRef point(span.table(), span.id(i));
+            throwTransformError(point);
+        }
+        span.skip(i);
+    }
+
+    // Values of points that failed are written as well, but those points
+    // have been skipped.
+    span.setField(Dimension::Id::X, x);
+    span.setField(Dimension::Id::Y, y);
+    span.setField(Dimension::Id::Z, z);
+}
+
 } // namespace pdal
@@ -60,15 +60,18 @@ private:
     virtual void initialize();
     virtual PointViewSet run(PointViewPtr view);
     virtual bool processOne(PointRef& point);
+    virtual void processBatch(PointSpan& span);
     virtual void spatialReferenceChanged(const SpatialReference& srs);
     virtual void prepared(PointTableRef table);
 
     void createTransform(const SpatialReference& srs);
+    void throwTransformError(PointRef& point);
 
     SpatialReference m_inSRS;
     SpatialReference m_outSRS;
     bool m_inferInputSRS;
-    std::unique_ptr<SrsTransform> m_transform;
+    // One transform per thread.
+    std::vector<SrsTransform> m_transforms;
     std::vector<std::string> m_inAxisOrderingArg;
     std::vector<std::string> m_outAxisOrderingArg;
     std::vector<int> m_inAxisOrdering;
@@ -77,6 +80,7 @@ private:
     double m_outCoordEpochArg;
 
     bool m_errorOnFailure;
+    int m_threads;
 };
 
 } // namespace pdal
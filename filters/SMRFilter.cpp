@@ -92,6 +92,7 @@ struct SMRArgs
     StringList m_returns;
     Segmentation::PointClasses m_classbits;
     Arg *m_windowArg;
+    int m_threads;
 };
 
 SMRFilter::SMRFilter() : m_args(new SMRArgs) {}
@@ -118,6 +119,8 @@ void SMRFilter::addArgs(ProgramArgs& args)
         "classification bits?", m_args->m_classbits);
     m_args->m_windowArg = &args.add("window", "Max window size?",
         m_args->m_window);
+    args.add("threads", "Number of threads used to run this filter",
+        m_args->m_threads, 1);
 }
 
 void SMRFilter::addDimensions(PointLayoutPtr layout)
@@ -129,6 +132,9 @@ void SMRFilter::prepared(PointTableRef table)
 {
     const PointLayoutPtr layout(table.layout());
 
+    if (m_args->m_threads < 1)
+        throwError("Option 'threads' must be greater than 0.");
+
     for (auto& r : m_args->m_ignored)
     {
         r.m_id = layout->findDim(r.m_name);
@@ -522,8 +528,10 @@ std::vector<double> SMRFilter::createZInet(std::vector<double> const& ZImin,
     {
         std::vector<double> dilated = ZImin;
         int v = ceil<int>(m_args->m_cut / m_args->m_cell);
-        math::erodeDiamond(dilated, m_rows, m_cols, 2 * v);
-        math::dilateDiamond(dilated, m_rows, m_cols, 2 * v);
+        math::erodeDiamond(dilated, m_rows, m_cols, 2 * v,
+            m_args->m_threads);
+        math::dilateDiamond(dilated, m_rows, m_cols, 2 * v,
+            m_args->m_threads);
         for (auto c = 0; c < m_cols; ++c)
         {
             for (auto r = 0; r < m_rows; ++r)
@@ -672,9 +680,10 @@ std::vector<int> SMRFilter::progressiveFilter(std::vector<double> const& ZImin,
     {
         // "On the first iteration, the minimum surface (ZImin) is opened using
         // a disk-shaped structuring element with a radius of one pixel."
-        math::erodeDiamond(erosion, m_rows, m_cols, 1);
+        math::erodeDiamond(erosion, m_rows, m_cols, 1, m_args->m_threads);
         std::vector<double> curOpening = erosion;
-        math::dilateDiamond(curOpening, m_rows, m_cols, radius);
+        math::dilateDiamond(curOpening, m_rows, m_cols, radius,
+            m_args->m_threads);
 
         // "An elevation threshold is then calculated, where the value is equal
         // to the supplied slope tolerance parameter multiplied by the product
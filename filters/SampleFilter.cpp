@@ -87,6 +87,10 @@ void SampleFilter::ready(PointTableRef)
 
 PointViewSet SampleFilter::run(PointViewPtr view)
 {
+    BOX3D bounds;
+    view->calculateBounds(bounds);
+    m_populatedVoxels.reserve(voxelEstimate(bounds, m_cell, view->size()));
+
     PointViewPtr output = view->makeNew();
     for (PointRef point : *view)
     {
@@ -115,18 +119,16 @@ bool SampleFilter::voxelize(PointRef& point)
     }
 
     // Get voxel indices for current point.
-    Voxel v = std::make_tuple((int)(std::floor((x - m_originX) / m_cell)),
-                              (int)(std::floor((y - m_originY) / m_cell)),
-                              (int)(std::floor((z - m_originZ) / m_cell)));
+    int vx = (int)(std::floor((x - m_originX) / m_cell));
+    int vy = (int)(std::floor((y - m_originY) / m_cell));
+    int vz = (int)(std::floor((z - m_originZ) / m_cell));
 
-    // Check current voxel before any of the neighbors. We will most often have
-    // points that are too close in the point's enclosing voxel, thus saving
-    // cycles.
-    if (m_populatedVoxels.find(v) != m_populatedVoxels.end())
+    // Check whether any point in a voxel is closer than the minimum radius.
+    auto tooClose = [this, x, y, z](const CoordList *coords)
     {
-        // Get list of coordinates in candidate voxel.
-        CoordList coords = m_populatedVoxels[v];
-        for (Coord const& coord : coords)
+        if (!coords)
+            return false;
+        for (Coord const& coord : *coords)
         {
             // Compute Euclidean distance between current point and
             // candidate voxel.
@@ -135,67 +137,40 @@ bool SampleFilter::voxelize(PointRef& point)
             double zv = std::get<2>(coord);
             double distSqr =
                 (xv - x) * (xv - x) + (yv - y) * (yv - y) + (zv - z) * (zv - z);
-
-            // If any point is closer than the minimum radius, we can
-            // immediately return false, as the minimum distance
-            // criterion is violated.
             if (distSqr < m_radiusSqr)
-                return false;
+                return true;
         }
-    }
+        return false;
+    };
+
+    // Check current voxel before any of the neighbors. We will most often have
+    // points that are too close in the point's enclosing voxel, thus saving
+    // cycles.  If any point is closer than the minimum radius, we can
+    // immediately return false, as the minimum distance criterion is
+    // violated.
+    if (tooClose(m_populatedVoxels.find(vx, vy, vz)))
+        return false;
 
     // Iterate over immediate neighbors of current voxel, computing minimum
     // distance between any already added point and the current point.
-    for (int xi = std::get<0>(v) - 1; xi < std::get<0>(v) + 2; ++xi)
+    for (int xi = vx - 1; xi < vx + 2; ++xi)
     {
-        for (int yi = std::get<1>(v) - 1; yi < std::get<1>(v) + 2; ++yi)
+        for (int yi = vy - 1; yi < vy + 2; ++yi)
         {
-            for (int zi = std::get<2>(v) - 1; zi < std::get<2>(v) + 2; ++zi)
+            for (int zi = vz - 1; zi < vz + 2; ++zi)
             {
-                Voxel candidate = std::make_tuple(xi, yi, zi);
-
                 // We have already visited the center voxel, and can skip it.
-                if (v == candidate)
-                    continue;
-
-                // Check that candidate voxel is occupied.
-                if (m_populatedVoxels.find(candidate) ==
-                    m_populatedVoxels.end())
+                if (xi == vx && yi == vy && zi == vz)
                     continue;
 
-                // Get list of coordinates in candidate voxel.
-                CoordList coords = m_populatedVoxels[candidate];
-                for (Coord const& coord : coords)
-                {
-                    // Compute Euclidean distance between current point and
-                    // candidate voxel.
-                    double xv = std::get<0>(coord);
-                    double yv = std::get<1>(coord);
-                    double zv = std::get<2>(coord);
-                    double distSqr = (xv - x) * (xv - x) + (yv - y) * (yv - y) +
-                                     (zv - z) * (zv - z);
-
-                    // If any point is closer than the minimum radius, we can
-                    // immediately return false, as the minimum distance
-                    // criterion is violated.
-                    if (distSqr < m_radiusSqr)
-                        return false;
-                }
+                if (tooClose(m_populatedVoxels.find(xi, yi, zi)))
+                    return false;
             }
         }
     }
 
-    Coord coord = std::make_tuple(x, y, z);
-    if (m_populatedVoxels.find(v) != m_populatedVoxels.end())
-    {
-        m_populatedVoxels[v].push_back(coord);
-    }
-    else
-    {
-        CoordList coords;
-        coords.push_back(coord);
-        m_populatedVoxels.emplace(v, coords);
-    }
+    m_populatedVoxels.insert(vx, vy, vz).first->push_back(
+        std::make_tuple(x, y, z));
     return true;
 }
 
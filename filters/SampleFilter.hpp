@@ -37,12 +37,13 @@
 #include <pdal/Filter.hpp>
 #include <pdal/Streamable.hpp>
 
+#include "private/VoxelMap.hpp"
+
 namespace pdal
 {
 
 class PDAL_DLL SampleFilter : public Filter, public Streamable
 {
-    using Voxel = std::tuple<int, int, int>;
     using Coord = std::tuple<double, double, double>;
     using CoordList = std::vector<Coord>;
 
@@ -62,7 +63,7 @@ private:
     double m_originX;
     double m_originY;
     double m_originZ;
-    std::map<Voxel, CoordList> m_populatedVoxels;
+    VoxelMap<CoordList> m_populatedVoxels;
 
     virtual void addArgs(ProgramArgs& args);
     virtual void prepared(PointTableRef table);
@@ -50,28 +50,50 @@ std::string SortFilter::getName() const { return s_info.name; }
 
 void SortFilter::addArgs(ProgramArgs& args)
 {
-    args.add("dimension", "Dimension on which to sort", m_dimName).
-        setPositional();
-    args.add("order", "Sort order ASC(ending) or DESC(ending)", m_order,
-        SortOrder::ASC);
+    args.add("dimension", "Dimensions on which to sort, most significant "
+        "first", m_dimNames).setPositional();
+    args.add("order", "Sort order ASC(ending) or DESC(ending), either for "
+        "all dimensions or for each", m_orderNames, {"ASC"});
+    args.add("threads", "Number of threads used to run this filter",
+        m_threads, 1);
 }
 
-void SortFilter::prepared(PointTableRef table)
+void SortFilter::initialize()
 {
-    m_dim = table.layout()->findDim(m_dimName);
-    if (m_dim == Dimension::Id::Unknown)
-        throwError("Dimension '" + m_dimName + "' not found.");
+    if (m_threads < 1)
+        throwError("Option 'threads' must be greater than 0.");
+    if (m_dimNames.empty())
+        throwError("Option 'dimension' must name at least one dimension.");
+    if (m_orderNames.size() != 1 && m_orderNames.size() != m_dimNames.size())
+        throwError("Option 'order' must have a single value or one value "
+            "for each dimension.");
+
+    m_orders.clear();
+    for (const std::string& name : m_orderNames)
+    {
+        SortOrder order;
+        if (!Utils::fromString(name, order))
+            throwError("Invalid sort order '" + name + "'.");
+        m_orders.push_back(order);
+    }
 }
 
-void SortFilter::filter(PointView& view)
+void SortFilter::prepared(PointTableRef table)
 {
-    auto cmp = [this](const PointRef& p1, const PointRef& p2)
+    m_keys.clear();
+    for (size_t i = 0; i < m_dimNames.size(); ++i)
     {
-        bool result = p1.compare(m_dim, p2);
-        return (m_order == SortOrder::ASC) ? result : !result;
-    };
+        Dimension::Id dim = table.layout()->findDim(m_dimNames[i]);
+        if (dim == Dimension::Id::Unknown)
+            throwError("Dimension '" + m_dimNames[i] + "' not found.");
+        SortOrder order = m_orders[m_orders.size() == 1 ? 0 : i];
+        m_keys.push_back({ dim, order == SortOrder::DESC });
+    }
+}
 
-    view.stableSort(cmp);
+void SortFilter::filter(PointView& view)
+{
+    view.stableSort(m_keys, (size_t)m_threads);
 }
 
 std::istream& operator >> (std::istream& in, SortOrder& order)
@@ -95,8 +117,10 @@ std::ostream& operator<<(std::ostream& out, const SortOrder& order)
     {
     case SortOrder::ASC:
         out << "ASC";
+        break;
     case SortOrder::DESC:
         out << "DESC";
+        break;
     }
     return out;
 }
@@ -59,15 +59,20 @@ public:
     std::string getName() const;
 
 private:
-    // Dimension on which to sort.
-    Dimension::Id m_dim;
-    // Dimension name.
-    std::string m_dimName;
+    // Dimensions on which to sort, most significant first.
+    std::vector<PointView::SortKey> m_keys;
+    // Dimension names.
+    StringList m_dimNames;
 
-    // Sort order.
-    SortOrder m_order;
+    // Sort order names, one for all dimensions or one for each.
+    StringList m_orderNames;
+    // Sort order for each dimension.
+    std::vector<SortOrder> m_orders;
+
+    int m_threads;
 
     virtual void addArgs(ProgramArgs& args);
+    virtual void initialize();
     virtual void prepared(PointTableRef table);
     virtual void filter(PointView& view);
 
@@ -52,7 +52,7 @@ static StaticPluginInfo const s_info
 
 CREATE_STATIC_STAGE(SplitterFilter, s_info)
 
-SplitterFilter::SplitterFilter() : m_viewMap(CoordCompare())
+SplitterFilter::SplitterFilter()
 {}
 
 std::string SplitterFilter::getName() const { return s_info.name; }
@@ -60,10 +60,10 @@ std::string SplitterFilter::getName() const { return s_info.name; }
 
 PointViewPtr SplitterFilter::view(const Coord& coord)
 {
-    auto vi = m_viewMap.find(coord);
-    if (vi == m_viewMap.end())
+    PointViewPtr *v = m_viewMap.find(coord.first, coord.second);
+    if (!v)
         return nullptr;
-    return vi->second;
+    return *v;
 }
 
 
@@ -99,11 +99,8 @@ BOX2D SplitterFilter::extent() const
 {
     BOX2D box;
 
-    for (auto& i : m_viewMap)
-    {
-        const Coord& c = i.first;
-        box.grow(c.first, c.second);
-    }
+    m_viewMap.forEach([&box](int x, int y, int, const PointViewPtr&)
+        { box.grow(x, y); });
     return box;
 }
 
@@ -146,8 +143,7 @@ PointViewSet SplitterFilter::run(PointViewPtr inView)
         return viewSet;
 
     auto addPoint = [this, &inView](PointRef& point, int xpos, int ypos) {
-        Coord loc(xpos, ypos);
-        PointViewPtr& outView = m_viewMap[loc];
+        PointViewPtr& outView = *m_viewMap.insert(xpos, ypos).first;
         if (!outView)
             outView = inView->makeNew();
         outView->appendPoint(*inView.get(), point.pointId());
@@ -171,8 +167,8 @@ PointViewSet SplitterFilter::run(PointViewPtr inView)
 
     // Pull the buffers out of the map and stick them in the standard
     // output set.
-    for (auto bi = m_viewMap.begin(); bi != m_viewMap.end(); ++bi)
-        viewSet.insert(bi->second);
+    m_viewMap.forEach([&viewSet](int, int, int, PointViewPtr& v)
+        { viewSet.insert(v); });
     return viewSet;
 }
 
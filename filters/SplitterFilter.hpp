@@ -36,25 +36,15 @@
 
 #include <pdal/Filter.hpp>
 
+#include "private/VoxelMap.hpp"
+
 namespace pdal
 {
 
 class PDAL_DLL SplitterFilter : public pdal::Filter
 {
 private:
-    //This used to be a lambda, but the VS compiler exploded, I guess.
     typedef std::pair<int, int> Coord;
-    class CoordCompare
-    {
-    public:
-        bool operator () (const Coord& c1, const Coord& c2) const
-        {
-            return c1.first < c2.first ? true :
-                c1.first > c2.first ? false :
-                c1.second < c2.second ? true :
-                false;
-        };
-    };
 
 public:
     SplitterFilter();
@@ -78,7 +68,7 @@ private:
     double m_xOrigin;
     double m_yOrigin;
     double m_buffer;
-    std::map<Coord, PointViewPtr, CoordCompare> m_viewMap;
+    VoxelMap<PointViewPtr> m_viewMap;
 
     virtual void addArgs(ProgramArgs& args);
     virtual void initialize();
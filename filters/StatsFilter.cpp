@@ -34,7 +34,9 @@
 
 #include "StatsFilter.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <unordered_map>
 
 #include <pdal/Options.hpp>
@@ -59,6 +61,135 @@ std::string StatsFilter::getName() const { return s_info.name; }
 namespace stats
 {
 
+QuantileSketch::QuantileSketch(uint32_t k) : m_k((std::max)(k, 8u)),
+    m_count(0), m_size(0), m_random(0x9E3779B97F4A7C15), m_levels(1)
+{
+    setCapacity();
+}
+
+
+// Levels below the top shrink geometrically so that most of the space
+// goes to the values with the largest weight.
+uint32_t QuantileSketch::capacity(size_t level) const
+{
+    size_t depth = m_levels.size() - level - 1;
+    double cap = std::ceil(m_k * std::pow(2.0 / 3.0, (double)depth));
+    return (std::max)((uint32_t)cap, 2u);
+}
+
+
+void QuantileSketch::setCapacity()
+{
+    m_capacity = 0;
+    for (size_t level = 0; level < m_levels.size(); ++level)
+        m_capacity += capacity(level);
+}
+
+
+// Compact the lowest level that is full.  If the level has an odd number
+// of values, one is left in place so that the total weight is unchanged.
+void QuantileSketch::compress()
+{
+    for (size_t h = 0; h < m_levels.size(); ++h)
+    {
+        if (m_levels[h].size() < capacity(h))
+            continue;
+        if (h + 1 == m_levels.size())
+        {
+            m_levels.emplace_back();
+            setCapacity();
+        }
+
+        std::vector<double>& level = m_levels[h];
+        std::vector<double>& next = m_levels[h + 1];
+        std::sort(level.begin(), level.end());
+
+        // Promote either the even or odd values at random (xorshift).
+        m_random ^= m_random << 13;
+        m_random ^= m_random >> 7;
+        m_random ^= m_random << 17;
+        size_t keep = level.size() % 2;
+        for (size_t i = keep + (m_random & 1); i < level.size(); i += 2)
+            next.push_back(level[i]);
+        m_size -= (level.size() - keep) / 2;
+        level.resize(keep);
+        break;
+    }
+}
+
+
+void QuantileSketch::merge(const QuantileSketch& s)
+{
+    if (s.m_levels.size() > m_levels.size())
+        m_levels.resize(s.m_levels.size());
+    for (size_t h = 0; h < s.m_levels.size(); ++h)
+        m_levels[h].insert(m_levels[h].end(), s.m_levels[h].begin(),
+            s.m_levels[h].end());
+    m_count += s.m_count;
+    m_size += s.m_size;
+    setCapacity();
+    while (m_size >= m_capacity)
+        compress();
+}
+
+
+QuantileSketch::WeightedValues QuantileSketch::weightedValues() const
+{
+    WeightedValues vals;
+    vals.reserve(m_size);
+    for (size_t h = 0; h < m_levels.size(); ++h)
+        for (double d : m_levels[h])
+            vals.emplace_back(d, point_count_t(1) << h);
+    return vals;
+}
+
+
+namespace
+{
+
+// Find the value at 'rank' of a list of weighted values.
+double rankValue(std::vector<std::pair<double, point_count_t>>& vals,
+    point_count_t rank)
+{
+    std::sort(vals.begin(), vals.end());
+    point_count_t cum = 0;
+    for (auto& v : vals)
+    {
+        cum += v.second;
+        if (cum > rank)
+            return v.first;
+    }
+    return vals.back().first;
+}
+
+point_count_t quantileRank(double q, point_count_t count)
+{
+    q = Utils::clamp(q, 0.0, 1.0);
+    return (std::min)((point_count_t)(q * count), count - 1);
+}
+
+} // unnamed namespace
+
+
+double QuantileSketch::quantile(double q) const
+{
+    if (m_count == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    WeightedValues vals = weightedValues();
+    return rankValue(vals, quantileRank(q, m_count));
+}
+
+
+double QuantileSketch::mad(double median) const
+{
+    if (m_count == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    WeightedValues vals = weightedValues();
+    for (auto& v : vals)
+        v.first = std::fabs(v.first - median);
+    return rankValue(vals, quantileRank(.5, m_count));
+}
+
 
 void Summary::extractMetadata(MetadataNode &m)
 {
@@ -112,24 +243,49 @@ void Summary::extractMetadata(MetadataNode &m)
 
 void Summary::computeGlobalStats()
 {
+    if (!m_exact)
+    {
+        m_median = m_sketch.quantile(.5);
+        m_mad = m_sketch.mad(m_median);
+        return;
+    }
+
+    if (m_data.empty())
+        return;
+
     auto compute_median = [](std::vector<double> vals)
     {
         std::nth_element(vals.begin(), vals.begin() + vals.size() / 2, vals.end());
         return *(vals.begin() + vals.size() / 2);
     };
 
-    // TODO add quantiles
     m_median = compute_median(m_data);
-    std::transform(m_data.begin(), m_data.end(), m_data.begin(),
+    std::vector<double> deviations(m_data.size());
+    std::transform(m_data.begin(), m_data.end(), deviations.begin(),
        [this](double v) { return std::fabs(v - this->m_median); });
-    m_mad = compute_median(m_data);
+    m_mad = compute_median(std::move(deviations));
+}
+
+
+double Summary::quantile(double q) const
+{
+    if (!m_exact)
+        return m_sketch.quantile(q);
+
+    if (m_data.empty())
+        return std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> vals(m_data);
+    auto it = vals.begin() + quantileRank(q, vals.size());
+    std::nth_element(vals.begin(), it, vals.end());
+    return *it;
 }
 
 // Math comes from https://prod.sandia.gov/techlib-noauth/access-control.cgi/2008/086212.pdf
 // (Pebay paper from Sandia labs, 2008)
 bool Summary::merge(const Summary& s)
 {
-    if ((m_name != s.m_name) || (m_enumerate != s.m_enumerate) || (m_advanced != s.m_advanced))
+    if ((m_name != s.m_name) || (m_enumerate != s.m_enumerate) ||
+        (m_advanced != s.m_advanced) || (m_exact != s.m_exact))
         return false;
 
     double n1 = (double)m_cnt;
@@ -162,6 +318,7 @@ bool Summary::merge(const Summary& s)
     m_max = (std::max)(m_max, s.m_max);
     m_cnt = s.m_cnt + m_cnt;
     m_data.insert(m_data.begin(), s.m_data.begin(), s.m_data.end());
+    m_sketch.merge(s.m_sketch);
     for (auto p : s.m_values)
         m_values[p.first] += p.second;
 
@@ -207,8 +364,15 @@ void StatsFilter::addArgs(ProgramArgs& args)
         m_dimNames);
     args.add("enumerate", "Dimensions whose values should be enumerated",
         m_enums);
-    args.add("global", "Dimensions to compute global stats (median, mad, mode)",
-        m_global);
+    args.add("global", "Dimensions to compute global stats (median, mad, "
+        "quantiles)", m_global);
+    args.add("quantiles", "Quantiles to compute for 'global' dimensions",
+        m_quantiles);
+    args.add("exact", "Compute global stats exactly by keeping all values",
+        m_exact);
+    args.add("sketch_size", "Size of the sketch used to estimate global "
+        "stats.  Larger values are more accurate", m_sketchSize,
+        QuantileSketch::DefaultSize);
     args.add("count", "Dimensions whose values should be counted", m_counts);
     args.add("advanced", "Calculate skewness and kurtosis", m_advanced);
     args.add("commonsrs", "Common SRS to use for normalizing bounding boxes", m_commonSrs, "EPSG:4326");
@@ -220,6 +384,12 @@ void StatsFilter::prepared(PointTableRef table)
     PointLayoutPtr layout(table.layout());
     std::unordered_map<std::string, Summary::EnumType> dims;
 
+    for (double q : m_quantiles)
+        if (q < 0 || q > 1)
+            throwError("Option 'quantiles' values must be between 0 and 1.");
+    if (m_sketchSize < 8)
+        throwError("Option 'sketch_size' must be at least 8.");
+
     auto getWarn([this]()->std::ostream&
     {
         return log()->get(LogLevel::Warning);
@@ -275,7 +445,7 @@ void StatsFilter::prepared(PointTableRef table)
     // Create the summary objects.
     for (auto& dv : dims)
         m_stats.insert(std::make_pair(layout->findDim(dv.first),
-            Summary(dv.first, dv.second, m_advanced)));
+            Summary(dv.first, dv.second, m_advanced, m_exact, m_sketchSize)));
 }
 
 
@@ -293,6 +463,13 @@ void StatsFilter::extractMetadata(PointTableRef table)
         MetadataNode t = m_metadata.addList("statistic");
         t.add("position", position++);
         s.extractMetadata(t);
+        if (s.enumerate() == Summary::Global && s.count())
+            for (double q : m_quantiles)
+            {
+                MetadataNode qn = t.addList("quantiles");
+                qn.add("quantile", q);
+                qn.add("value", s.quantile(q));
+            }
     }
 
     // If we have X, Y, & Z dims, output bboxes
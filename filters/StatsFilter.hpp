@@ -34,6 +34,9 @@
 
 #pragma once
 
+#include <cmath>
+#include <vector>
+
 #include <pdal/Filter.hpp>
 #include <pdal/Streamable.hpp>
 
@@ -42,6 +45,57 @@ namespace pdal
 namespace stats
 {
 
+// Mergeable sketch of a stream of values that answers quantile queries
+// in bounded memory (a KLL sketch).  Values are kept in levels, where a
+// value at level 'h' stands for 2^h inserted values.  When a level fills,
+// it is sorted and every other value is promoted to the next level.  The
+// error in the rank of a returned quantile is roughly 1.7 / 'k' of the
+// number of values.  Results are exact for fewer than 'k' values.
+class PDAL_DLL QuantileSketch
+{
+public:
+    static const uint32_t DefaultSize = 200;
+
+    QuantileSketch(uint32_t k = DefaultSize);
+
+    void insert(double value)
+    {
+        // NaN can't be ordered.
+        if (std::isnan(value))
+            return;
+        m_levels[0].push_back(value);
+        m_count++;
+        if (++m_size >= m_capacity)
+            compress();
+    }
+
+    // Merge another sketch with this one.
+    void merge(const QuantileSketch& s);
+    // Approximate value at rank 'q' * count() of the sorted values.
+    double quantile(double q) const;
+    // Approximate median of the absolute deviations from 'median'.
+    double mad(double median) const;
+    point_count_t count() const
+        { return m_count; }
+    uint32_t size() const
+        { return m_k; }
+
+private:
+    typedef std::vector<std::pair<double, point_count_t>> WeightedValues;
+
+    uint32_t m_k;
+    point_count_t m_count;
+    size_t m_size;
+    size_t m_capacity;
+    uint64_t m_random;
+    std::vector<std::vector<double>> m_levels;
+
+    uint32_t capacity(size_t level) const;
+    void setCapacity();
+    void compress();
+    WeightedValues weightedValues() const;
+};
+
 class PDAL_DLL Summary
 {
 public:
@@ -57,12 +111,19 @@ typedef std::map<double, point_count_t> EnumMap;
 typedef std::vector<double> DataVector;
 
 public:
-    Summary(std::string name, EnumType enumerate, bool advanced = true) :
-        m_name(name), m_enumerate(enumerate), m_advanced(advanced)
+    // Global statistics are estimated from a quantile sketch of size
+    // 'sketchSize' unless 'exact' is true, in which case all values are
+    // kept.
+    Summary(std::string name, EnumType enumerate, bool advanced = true,
+            bool exact = false,
+            uint32_t sketchSize = QuantileSketch::DefaultSize) :
+        m_name(name), m_enumerate(enumerate), m_advanced(advanced),
+        m_exact(exact), m_sketch(sketchSize)
     { reset(); }
 
-    // Merge another summary with this one. 'name', 'enumerate' and 'advanced' must match
-    // or false is returned and no merge occurs.
+    // Merge another summary with this one. 'name', 'enumerate', 'advanced'
+    // and the global statistics mode must match or false is returned and
+    // no merge occurs.
     bool merge(const Summary& s);
     double minimum() const
         { return m_min; }
@@ -139,6 +200,11 @@ public:
         { return m_name; }
     const EnumMap& values() const
         { return m_values; }
+    EnumType enumerate() const
+        { return m_enumerate; }
+    // Value at rank 'q' * count() of the sorted values.  Only available
+    // for global summaries.
+    double quantile(double q) const;
 
     void extractMetadata(MetadataNode &m);
     void computeGlobalStats();
@@ -159,13 +225,18 @@ public:
         m_min = (std::min)(m_min, value);
         m_max = (std::max)(m_max, value);
 
-        if (m_enumerate != NoEnum)
+        if (m_enumerate == Enumerate || m_enumerate == Count)
             m_values[value]++;
-        if (m_enumerate == Global)
+        else if (m_enumerate == Global)
         {
-            if (m_data.capacity() - m_data.size() < 10000)
-                m_data.reserve(m_data.capacity() + m_cnt);
-            m_data.push_back(value);
+            if (!m_exact)
+                m_sketch.insert(value);
+            else
+            {
+                if (m_data.capacity() - m_data.size() < 10000)
+                    m_data.reserve(m_data.capacity() + m_cnt);
+                m_data.push_back(value);
+            }
         }
 
         // stolen from http://www.johndcook.com/blog/skewness_kurtosis/
@@ -199,12 +270,14 @@ private:
     std::string m_name;
     EnumType m_enumerate;
     bool m_advanced;
+    bool m_exact;
     double m_max;
     double m_min;
     double m_mad;
     double m_median;
     EnumMap m_values;
     DataVector m_data;
+    QuantileSketch m_sketch;
     point_count_t m_cnt;
     double M1, M2, M3, M4;
 };
@@ -238,6 +311,9 @@ private:
     StringList m_enums;
     StringList m_counts;
     StringList m_global;
+    std::vector<double> m_quantiles;
+    bool m_exact;
+    uint32_t m_sketchSize;
     std::string m_commonSrs;
     bool m_advanced;
     std::map<Dimension::Id, stats::Summary> m_stats;
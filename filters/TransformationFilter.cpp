@@ -33,6 +33,7 @@
 ****************************************************************************/
 
 #include "TransformationFilter.hpp"
+#include <pdal/PointSpan.hpp>
 #include <pdal/util/FileUtils.hpp>
 
 #include <Eigen/Dense>
@@ -203,6 +204,35 @@ bool TransformationFilter::processOne(PointRef& point)
     return true;
 }
 
+
+void TransformationFilter::processBatch(PointSpan& span)
+{
+    const Transform& matrix = *m_matrix;
+
+    std::vector<double> x, y, z;
+    span.getField(Dimension::Id::X, x);
+    span.getField(Dimension::Id::Y, y);
+    span.getField(Dimension::Id::Z, z);
+    for (point_count_t i = 0; i < span.size(); ++i)
+    {
+        double xi = x[i];
+        double yi = y[i];
+        double zi = z[i];
+        double s = xi * matrix[12] + yi * matrix[13] + zi * matrix[14] +
+            matrix[15];
+
+        x[i] = (xi * matrix[0] + yi * matrix[1] + zi * matrix[2] +
+            matrix[3]) / s;
+        y[i] = (xi * matrix[4] + yi * matrix[5] + zi * matrix[6] +
+            matrix[7]) / s;
+        z[i] = (xi * matrix[8] + yi * matrix[9] + zi * matrix[10] +
+            matrix[11]) / s;
+    }
+    span.setField(Dimension::Id::X, x);
+    span.setField(Dimension::Id::Y, y);
+    span.setField(Dimension::Id::Z, z);
+}
+
 void TransformationFilter::spatialReferenceChanged(const SpatialReference& srs)
 {
     if (!srs.empty() && !m_overrideSrs.empty())
@@ -61,7 +61,12 @@ private:
     virtual void addArgs(ProgramArgs& args) override;
     virtual void initialize() override;
     virtual bool processOne(PointRef& point) override;
+    virtual void processBatch(PointSpan& span) override;
     virtual void filter(PointView& view) override;
+    virtual bool parallelViewSafe() const override
+        { return true; }
+    virtual bool parallelPointSafe() const override
+        { return true; }
     virtual void spatialReferenceChanged(const SpatialReference& srs) override;
 
     std::unique_ptr<Transform> m_matrix;
@@ -104,6 +104,10 @@ void VoxelDownsizeFilter::ready(PointTableRef)
 
 PointViewSet VoxelDownsizeFilter::run(PointViewPtr view)
 {
+    BOX3D bounds;
+    view->calculateBounds(bounds);
+    m_populatedVoxels.reserve(voxelEstimate(bounds, m_cell, view->size()));
+
     PointViewPtr output = view->makeNew();
     PointRef point(*view);
     for (PointId id = 0; id < view->size(); ++id)
@@ -140,18 +144,16 @@ bool VoxelDownsizeFilter::voxelize(PointRef& point)
     y -= m_originY;
     z -= m_originZ;
 
-    Voxel v = std::make_tuple((int)(std::floor(x / m_cell)),
-        (int)(std::floor(y / m_cell)), (int)(std::floor(z / m_cell)));
+    int vx = (int)(std::floor(x / m_cell));
+    int vy = (int)(std::floor(y / m_cell));
+    int vz = (int)(std::floor(z / m_cell));
 
-    auto inserted = m_populatedVoxels.insert(v).second;
+    auto inserted = m_populatedVoxels.insert(vx, vy, vz).second;
     if ((m_mode == Mode::Center) && inserted)
     {
-        point.setField(Dimension::Id::X,
-            (std::get<0>(v) + 0.5) * m_cell + m_originX);
-        point.setField(Dimension::Id::Y,
-            (std::get<1>(v) + 0.5) * m_cell + m_originY);
-        point.setField(Dimension::Id::Z,
-            (std::get<2>(v) + 0.5) * m_cell + m_originZ);
+        point.setField(Dimension::Id::X, (vx + 0.5) * m_cell + m_originX);
+        point.setField(Dimension::Id::Y, (vy + 0.5) * m_cell + m_originY);
+        point.setField(Dimension::Id::Z, (vz + 0.5) * m_cell + m_originZ);
     }
     return inserted;
 }
@@ -0,0 +1,148 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "BoxIndex.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace pdal
+{
+
+BoxIndex::BoxIndex()
+{}
+
+
+void BoxIndex::build(const std::vector<BOX2D>& boxes)
+{
+    m_boxes.clear();
+    m_ids.clear();
+    m_levels.clear();
+
+    std::vector<uint32_t> order;
+    for (uint32_t i = 0; i < boxes.size(); ++i)
+        if (boxes[i].valid())
+            order.push_back(i);
+    if (order.empty())
+        return;
+
+    auto centerX = [&boxes](uint32_t i)
+        { return boxes[i].minx + boxes[i].maxx; };
+    auto centerY = [&boxes](uint32_t i)
+        { return boxes[i].miny + boxes[i].maxy; };
+
+    // Sort-tile-recursive: sort by X center, cut into vertical slices of
+    // about sqrt(leaves) leaves each, and sort each slice by Y center.
+    const size_t count = order.size();
+    const size_t leaves = (count + NodeSize - 1) / NodeSize;
+    const size_t sliceSize = NodeSize *
+        (size_t)std::ceil(std::sqrt((double)leaves));
+    std::sort(order.begin(), order.end(),
+        [&centerX](uint32_t a, uint32_t b){ return centerX(a) < centerX(b); });
+    for (size_t start = 0; start < count; start += sliceSize)
+    {
+        auto end = order.begin() + (std::min)(start + sliceSize, count);
+        std::sort(order.begin() + start, end,
+            [&centerY](uint32_t a, uint32_t b)
+                { return centerY(a) < centerY(b); });
+    }
+
+    m_ids = order;
+    for (uint32_t i : order)
+        m_boxes.push_back(boxes[i]);
+
+    // Group consecutive entries into nodes, level by level, until a single
+    // root remains.  The STR order keeps consecutive nodes close together.
+    std::vector<BOX2D> childBounds(m_boxes);
+    do
+    {
+        std::vector<Node> level;
+        for (size_t first = 0; first < childBounds.size(); first += NodeSize)
+        {
+            Node node;
+            node.m_first = (uint32_t)first;
+            node.m_count = (uint32_t)(std::min)((size_t)NodeSize,
+                childBounds.size() - first);
+            for (uint32_t i = 0; i < node.m_count; ++i)
+                node.m_bounds.grow(childBounds[first + i]);
+            level.push_back(node);
+        }
+
+        childBounds.clear();
+        for (const Node& node : level)
+            childBounds.push_back(node.m_bounds);
+        m_levels.push_back(std::move(level));
+    } while (m_levels.back().size() > 1);
+}
+
+
+void BoxIndex::query(double x, double y, std::vector<uint32_t>& ids) const
+{
+    ids.clear();
+    if (m_levels.empty())
+        return;
+
+    struct Entry
+    {
+        size_t m_level;
+        uint32_t m_node;
+    };
+
+    std::vector<Entry> stack;
+    stack.push_back({ m_levels.size() - 1, 0 });
+    while (stack.size())
+    {
+        Entry e = stack.back();
+        stack.pop_back();
+
+        const Node& node = m_levels[e.m_level][e.m_node];
+        if (!node.m_bounds.contains(x, y))
+            continue;
+
+        const uint32_t end = node.m_first + node.m_count;
+        if (e.m_level == 0)
+        {
+            for (uint32_t i = node.m_first; i < end; ++i)
+                if (m_boxes[i].contains(x, y))
+                    ids.push_back(m_ids[i]);
+        }
+        else
+            for (uint32_t i = node.m_first; i < end; ++i)
+                stack.push_back({ e.m_level - 1, i });
+    }
+    std::sort(ids.begin(), ids.end());
+}
+
+} // namespace pdal
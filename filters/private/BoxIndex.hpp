@@ -0,0 +1,84 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <pdal/pdal_export.hpp>
+#include <pdal/util/Bounds.hpp>
+
+namespace pdal
+{
+
+// A static R-tree of 2D boxes, packed with the sort-tile-recursive
+// algorithm.  Queries return the positions of the boxes in the list from
+// which the index was built.
+class PDAL_DLL BoxIndex
+{
+public:
+    BoxIndex();
+
+    // Build the index.  Empty boxes are never returned by a query.
+    void build(const std::vector<BOX2D>& boxes);
+
+    // Find the boxes that contain a point.
+    // \param x  X coordinate of the point.
+    // \param y  Y coordinate of the point.
+    // \param ids  Positions of the containing boxes, in increasing order.
+    void query(double x, double y, std::vector<uint32_t>& ids) const;
+
+    bool empty() const
+        { return m_levels.empty(); }
+
+private:
+    struct Node
+    {
+        BOX2D m_bounds;
+        uint32_t m_first;  // First child in the level below.
+        uint32_t m_count;
+    };
+
+    // Boxes and their original positions, in tree order.
+    std::vector<BOX2D> m_boxes;
+    std::vector<uint32_t> m_ids;
+    // Nodes of each level of the tree.  The children of the nodes of level
+    // zero are entries of m_boxes.  The last level holds only the root.
+    std::vector<std::vector<Node>> m_levels;
+
+    static const uint32_t NodeSize = 16;
+};
+
+} // namespace pdal
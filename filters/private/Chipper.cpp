@@ -0,0 +1,191 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "Chipper.hpp"
+
+#include <pdal/PointColumn.hpp>
+#include <pdal/util/Executor.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace pdal
+{
+namespace chipper
+{
+
+namespace
+{
+
+struct Ref
+{
+    double x;
+    double y;
+    PointId id;
+};
+
+// Points are ordered by position, then by index, so that the chips don't
+// depend on the order in which the points are moved around.
+bool lessX(const Ref& a, const Ref& b)
+{
+    return a.x < b.x || (a.x == b.x && a.id < b.id);
+}
+
+bool lessY(const Ref& a, const Ref& b)
+{
+    return a.y < b.y || (a.y == b.y && a.id < b.id);
+}
+
+// Blocks with fewer points than this are split in the calling task.
+const point_count_t MinTaskSize = 1 << 16;
+
+class Splitter
+{
+public:
+    Splitter(std::vector<Ref>& refs, const std::vector<PointId>& offsets,
+            TaskGroup *group) :
+        m_refs(refs), m_offsets(offsets), m_group(group)
+    {}
+
+    // Split the points of chips [first, last) in the wider direction.  Ties
+    // go to the direction that isn't the one the parent block was split in.
+    void split(std::size_t first, std::size_t last, bool parentX)
+    {
+        Ref *begin = m_refs.data() + m_offsets[first];
+        Ref *end = m_refs.data() + m_offsets[last];
+
+        double minx = begin->x;
+        double maxx = begin->x;
+        double miny = begin->y;
+        double maxy = begin->y;
+        for (Ref *r = begin; r != end; ++r)
+        {
+            minx = (std::min)(minx, r->x);
+            maxx = (std::max)(maxx, r->x);
+            miny = (std::min)(miny, r->y);
+            maxy = (std::max)(maxy, r->y);
+        }
+        const double xrange = maxx - minx;
+        const double yrange = maxy - miny;
+        const bool splitX = parentX ? (xrange > yrange) : !(yrange > xrange);
+        auto less = splitX ? lessX : lessY;
+
+        // Blocks of one or two chips are done.  Order the points of each
+        // chip in the split direction.
+        if (last - first <= 2)
+        {
+            if (last - first == 2)
+                std::nth_element(begin, chipBegin(first + 1), end, less);
+            for (std::size_t c = first; c < last; ++c)
+                std::sort(chipBegin(c), chipBegin(c + 1), less);
+            return;
+        }
+
+        const std::size_t center = (first + last) / 2;
+        std::nth_element(begin, chipBegin(center), end, less);
+        if (m_group && (point_count_t)(end - begin) >= MinTaskSize)
+        {
+            m_group->add([this, first, center, splitX]()
+                { split(first, center, splitX); });
+            split(center, last, splitX);
+        }
+        else
+        {
+            split(first, center, splitX);
+            split(center, last, splitX);
+        }
+    }
+
+private:
+    std::vector<Ref>& m_refs;
+    const std::vector<PointId>& m_offsets;
+    TaskGroup *m_group;
+
+    Ref *chipBegin(std::size_t chip)
+        { return m_refs.data() + m_offsets[chip]; }
+};
+
+} // unnamed namespace
+
+Chips chip(const PointView& view, point_count_t capacity, std::size_t threads)
+{
+    Chips chips;
+    const point_count_t count = view.size();
+    if (count == 0 || capacity == 0)
+        return chips;
+
+    // This is a standard statistics cumulate and round.  It distributes
+    // the points into chips such that the "extra" points are reasonably
+    // distributed among the chips.
+    point_count_t numChips = count / capacity;
+    if (count % capacity)
+        numChips++;
+    const double chipSize = static_cast<double>(count) / numChips;
+    double total = 0.0;
+    chips.offsets.push_back(0);
+    for (point_count_t i = 0; i < numChips; ++i)
+    {
+        total += chipSize;
+        chips.offsets.push_back((PointId)std::llround(total));
+    }
+
+    std::vector<Ref> refs(count);
+    PointColumn<double> xcol = view.column<double>(Dimension::Id::X);
+    PointColumn<double> ycol = view.column<double>(Dimension::Id::Y);
+    parallelRange(count, threads, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            refs[i] = { xcol[i], ycol[i], i };
+    });
+
+    if (threads > 1)
+    {
+        TaskGroup group(threads);
+        Splitter(refs, chips.offsets, &group).split(0, numChips, true);
+        group.wait();
+    }
+    else
+        Splitter(refs, chips.offsets, nullptr).split(0, numChips, true);
+
+    chips.ids.resize(count);
+    parallelRange(count, threads, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            chips.ids[i] = refs[i].id;
+    });
+    return chips;
+}
+
+} // namespace chipper
+} // namespace pdal
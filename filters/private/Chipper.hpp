@@ -0,0 +1,78 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <pdal/PointView.hpp>
+
+#include <vector>
+
+namespace pdal
+{
+namespace chipper
+{
+
+// Chips of a point view.  The view's point indices are ordered chip by
+// chip, so each chip is a contiguous range of 'ids'.
+struct Chips
+{
+    // Indices of the points of the view, chip by chip.
+    std::vector<PointId> ids;
+    // Chip 'i' is ids[offsets[i]] up to (not including) ids[offsets[i + 1]].
+    std::vector<PointId> offsets;
+
+    // Number of chips.
+    std::size_t size() const
+        { return offsets.empty() ? 0 : offsets.size() - 1; }
+};
+
+/**
+  Split the points of a view into non-overlapping, squarish chips of
+  approximately the same number of points.
+
+  Chip sizes are fixed up front so that the points are spread evenly over
+  the chips.  Blocks of chips are then split in half recursively, in the X
+  or Y direction, whichever is wider.  Each split is an in-place selection
+  of the points of the block, and the halves are split in parallel.
+
+  \param view  View whose points are chipped.
+  \param capacity  Maximum number of points in a chip.
+  \param threads  Number of threads used to chip.
+  \return  Chips of the view.
+*/
+Chips chip(const PointView& view, point_count_t capacity,
+    std::size_t threads = 1);
+
+} // namespace chipper
+} // namespace pdal
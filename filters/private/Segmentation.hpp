@@ -34,10 +34,14 @@
 
 #pragma once
 
+#include <pdal/KDIndex.hpp>
 #include <pdal/pdal_export.hpp>
 #include <pdal/pdal_types.hpp>
 
+#include <pdal/util/Executor.hpp>
+
 #include "DimRange.hpp"
+#include "UnionFind.hpp"
 
 #include <vector>
 
@@ -83,75 +87,70 @@ std::ostream& operator<<(std::ostream& out, const PointClasses& classes);
 /**
   Extract clusters of points from input PointView.
 
-  For each point, find neighbors within a given tolerance (Euclidean distance).
-  If a neighbor already belongs to another cluster, skip it. Otherwise, add it
-  to the current cluster. Recursively visit newly added cluster points, looking
-  for neighbors to add to the cluster.
+  Points are in the same cluster if they are connected by a chain of
+  points, each within a given tolerance (Euclidean distance) of the next.
+  Neighborhoods are searched in parallel and joined with a union-find.
+  Clusters are ordered by their smallest point ID and the points of a
+  cluster are in increasing order.
 
   \param[in] view the input PointView.
   \param[in] min_points the minimum number of points in a cluster.
   \param[in] max_points the maximum number of points in a cluster.
   \param[in] tolerance the tolerance for adding points to a cluster.
+  \param[in] threads the number of threads to use.
+  \param[in] storage the storage of coordinates in the KD index.
   \returns a deque of clusters (themselves vectors of PointIds).
 */
 template <class KDINDEX>
 PDAL_DLL std::deque<PointIdList> extractClusters(PointView& view, uint64_t min_points,
-                                                 uint64_t max_points, double tolerance)
+                                                 uint64_t max_points, double tolerance,
+                                                 size_t threads = 1,
+                                                 KDStorage storage = KDStorage::Double)
 {
     // Index the incoming PointView for subsequent radius searches.
-    KDINDEX kdi(view);
-    kdi.build();
-
-    // Create variables to track PointIds that have already been added to
-    // clusters and to build the list of cluster indices.
-    PointIdList processed(view.size(), 0);
+    KDINDEX kdi(view, storage);
+    kdi.build(threads);
+
+    // Join each point with its neighbors.  Neighborhoods are symmetric,
+    // so only neighbors with larger IDs need to be joined.
+    const point_count_t size = view.size();
+    UnionFind sets(size);
+    parallelRange(size, threads, [&](PointId begin, PointId end)
+    {
+        for (PointId i = begin; i < end; ++i)
+            for (PointId k : kdi.radius(i, tolerance))
+                if (k > i)
+                    sets.unite(i, k);
+    });
+
+    // Count the points in each cluster.  The root of a cluster is its
+    // smallest point ID.
+    std::vector<point_count_t> counts(size, 0);
+    for (PointId i = 0; i < size; ++i)
+        counts[sets.find(i)]++;
+
+    // Keep clusters that are within the min/max number of points, mapping
+    // each kept root to its position in the output, offset by one.
     std::deque<PointIdList> clusters;
-
-    for (PointId i = 0; i < view.size(); ++i)
+    for (PointId i = 0; i < size; ++i)
     {
-        // Points can only belong to a single cluster.
-        if (processed[i])
+        if (sets.get(i) != i)
             continue;
-
-        // Initialize list of indices belonging to current cluster, marking the
-        // seed point as processed.
-        PointIdList seed_queue;
-        size_t sq_idx = 0;
-        seed_queue.push_back(i);
-        processed[i] = 1;
-
-        // Check each point in the cluster for additional neighbors within the
-        // given tolerance, remembering that the list can grow if we add points
-        // to the cluster.
-        while (sq_idx < seed_queue.size())
+        if (counts[i] >= min_points && counts[i] <= max_points)
         {
-            // Find neighbors of the next cluster point.
-            PointId j = seed_queue[sq_idx];
-            PointIdList ids = kdi.radius(j, tolerance);
-
-            // The case where the only neighbor is the query point.
-            if (ids.size() == 1)
-            {
-                sq_idx++;
-                continue;
-            }
-
-            // Skip neighbors that already belong to a cluster and add the rest
-            // to this cluster.
-            for (auto const& k : ids)
-            {
-                if (processed[k])
-                    continue;
-                seed_queue.push_back(k);
-                processed[k] = 1;
-            }
-
-            sq_idx++;
+            clusters.emplace_back();
+            clusters.back().reserve(counts[i]);
+            counts[i] = clusters.size();
         }
+        else
+            counts[i] = 0;
+    }
 
-        // Keep clusters that are within the min/max number of points.
-        if (seed_queue.size() >= min_points && seed_queue.size() <= max_points)
-            clusters.push_back(seed_queue);
+    for (PointId i = 0; i < size; ++i)
+    {
+        point_count_t cluster = counts[sets.find(i)];
+        if (cluster)
+            clusters[cluster - 1].push_back(i);
     }
 
     return clusters;
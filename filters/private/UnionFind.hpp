@@ -0,0 +1,111 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include <pdal/pdal_types.hpp>
+
+namespace pdal
+{
+
+// Union-find (disjoint sets) over point IDs that can be updated from
+// several threads at once without locks.  The root of a set is always its
+// smallest member, so the final sets and roots don't depend on the order
+// in which unions are made.
+class UnionFind
+{
+public:
+    UnionFind(point_count_t size) : m_parent(size)
+    {
+        for (PointId i = 0; i < size; ++i)
+            m_parent[i].store(i, std::memory_order_relaxed);
+    }
+
+    // Find the root of the set containing 'x'.
+    PointId find(PointId x)
+    {
+        while (true)
+        {
+            PointId p = m_parent[x].load(std::memory_order_relaxed);
+            if (p == x)
+                return x;
+            PointId gp = m_parent[p].load(std::memory_order_relaxed);
+            // Path halving.
+            if (p != gp)
+                m_parent[x].compare_exchange_weak(p, gp,
+                    std::memory_order_relaxed);
+            x = gp;
+        }
+    }
+
+    // Merge the sets containing 'a' and 'b'.
+    void unite(PointId a, PointId b)
+    {
+        while (true)
+        {
+            a = find(a);
+            b = find(b);
+            if (a == b)
+                return;
+            if (a < b)
+                std::swap(a, b);
+            // Link the larger root below the smaller one.  Fails if 'a'
+            // was linked elsewhere in the meantime.
+            PointId expected = a;
+            if (m_parent[a].compare_exchange_strong(expected, b,
+                    std::memory_order_relaxed))
+                return;
+        }
+    }
+
+    // Raw access to the parent of a point.  Once all unions are done and
+    // each point's parent has been set to its root, the parent array can
+    // be reused to hold other per-point IDs.
+    PointId get(PointId x) const
+        { return m_parent[x].load(std::memory_order_relaxed); }
+    void set(PointId x, PointId p)
+        { m_parent[x].store(p, std::memory_order_relaxed); }
+
+    point_count_t size() const
+        { return m_parent.size(); }
+
+private:
+    std::vector<std::atomic<PointId>> m_parent;
+};
+
+} // namespace pdal
@@ -0,0 +1,205 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <pdal/pdal_types.hpp>
+#include <pdal/util/Bounds.hpp>
+
+namespace pdal
+{
+
+// Map from integer voxel (or 2D cell) coordinates to values, stored as an
+// open-addressing hash table with linear probing.  Keys are packed next to
+// their values in a single flat array, so a lookup touches one or two cache
+// lines and inserts don't allocate except when the table grows.  Pointers
+// to values are invalidated when the table grows.
+template<typename T>
+class VoxelMap
+{
+    struct Slot
+    {
+        int32_t x;
+        int32_t y;
+        int32_t z;
+        bool used;
+        T value;
+    };
+
+public:
+    VoxelMap() : m_size(0), m_mask(0)
+    {}
+
+    // Make room for 'count' voxels without growing the table.
+    void reserve(std::size_t count)
+    {
+        std::size_t capacity = 16;
+        while (capacity * MaxLoad / 8 < count)
+            capacity *= 2;
+        if (capacity > m_slots.size())
+            rehash(capacity);
+    }
+
+    // Find the value for a voxel.  Returns nullptr if the voxel isn't
+    // in the map.
+    T *find(int x, int y, int z = 0)
+    {
+        if (m_slots.empty())
+            return nullptr;
+        for (std::size_t i = hash(x, y, z) & m_mask;; i = (i + 1) & m_mask)
+        {
+            Slot& s = m_slots[i];
+            if (!s.used)
+                return nullptr;
+            if (s.x == x && s.y == y && s.z == z)
+                return &s.value;
+        }
+    }
+
+    // Find the value for a voxel, adding a default-constructed value if the
+    // voxel isn't in the map.  The flag is true if the voxel was added.
+    std::pair<T *, bool> insert(int x, int y, int z = 0)
+    {
+        if ((m_size + 1) * 8 > m_slots.size() * MaxLoad)
+            rehash(m_slots.empty() ? 16 : m_slots.size() * 2);
+        for (std::size_t i = hash(x, y, z) & m_mask;; i = (i + 1) & m_mask)
+        {
+            Slot& s = m_slots[i];
+            if (!s.used)
+            {
+                s.x = x;
+                s.y = y;
+                s.z = z;
+                s.used = true;
+                m_size++;
+                return { &s.value, true };
+            }
+            if (s.x == x && s.y == y && s.z == z)
+                return { &s.value, false };
+        }
+    }
+
+    // Call func(x, y, z, value) for each voxel, in no particular order.
+    template<typename FUNC>
+    void forEach(FUNC func)
+    {
+        for (Slot& s : m_slots)
+            if (s.used)
+                func(s.x, s.y, s.z, s.value);
+    }
+
+    template<typename FUNC>
+    void forEach(FUNC func) const
+    {
+        for (const Slot& s : m_slots)
+            if (s.used)
+                func(s.x, s.y, s.z, s.value);
+    }
+
+    std::size_t size() const
+        { return m_size; }
+    bool empty() const
+        { return m_size == 0; }
+    void clear()
+    {
+        m_slots.clear();
+        m_slots.shrink_to_fit();
+        m_size = 0;
+        m_mask = 0;
+    }
+
+private:
+    // Maximum load factor, in eighths.
+    static const std::size_t MaxLoad = 5;
+
+    std::vector<Slot> m_slots;
+    std::size_t m_size;
+    std::size_t m_mask;
+
+    static std::size_t hash(int x, int y, int z)
+    {
+        uint64_t h = (uint64_t)(uint32_t)x * 0x9E3779B97F4A7C15ULL;
+        h ^= (uint64_t)(uint32_t)y * 0xC2B2AE3D27D4EB4FULL;
+        h ^= (uint64_t)(uint32_t)z * 0x165667B19E3779F9ULL;
+        return (std::size_t)(h ^ (h >> 29));
+    }
+
+    // Move the voxels to a table with 'capacity' slots (a power of two).
+    void rehash(std::size_t capacity)
+    {
+        std::vector<Slot> old(capacity);
+        old.swap(m_slots);
+        m_mask = capacity - 1;
+        for (Slot& s : old)
+        {
+            if (!s.used)
+                continue;
+            std::size_t i = hash(s.x, s.y, s.z) & m_mask;
+            while (m_slots[i].used)
+                i = (i + 1) & m_mask;
+            m_slots[i] = std::move(s);
+        }
+    }
+};
+
+// Estimate the number of voxels with edge length 'cell' occupied by 'count'
+// points within 'bounds'.  Point clouds are mostly surfaces, so this is the
+// number of voxels covering the two longest sides of the bounds rather than
+// its volume.  The estimate is no more than the number of points and is
+// capped at MaxVoxelEstimate; the map grows on demand beyond it.
+static const std::size_t MaxVoxelEstimate = (std::size_t)1 << 22;
+
+inline std::size_t voxelEstimate(const BOX3D& bounds, double cell,
+    point_count_t count)
+{
+    if (bounds.empty() || !(cell > 0))
+        return 0;
+    double sides[] = {
+        std::floor((bounds.maxx - bounds.minx) / cell) + 2,
+        std::floor((bounds.maxy - bounds.miny) / cell) + 2,
+        std::floor((bounds.maxz - bounds.minz) / cell) + 2 };
+    std::sort(std::begin(sides), std::end(sides));
+    double voxels = sides[1] * sides[2];
+    voxels = (std::min)(voxels, (double)count);
+    return (std::size_t)(std::min)(voxels, (double)MaxVoxelEstimate);
+}
+
+} // namespace pdal
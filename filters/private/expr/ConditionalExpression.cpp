@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "ConditionalExpression.hpp"
 
 namespace pdal
@@ -28,8 +30,11 @@ Utils::StatusWithReason ConditionalExpression::prepare(PointLayoutPtr layout)
                 }
             }
         }
+        if (status)
+            m_program.compile(top, true);
         return status;
     }
+    m_program.compile(nullptr, true);
     return true;
 }
 
@@ -39,6 +44,37 @@ bool ConditionalExpression::eval(PointRef& p) const
     return n ? n->eval(p).m_bval : true;
 }
 
+void ConditionalExpression::eval(const PointView& view,
+    std::vector<char>& pass) const
+{
+    pass.resize(view.size());
+    ViewEvaluator evaluator(m_program, view);
+    for (PointId begin = 0; begin < view.size();
+        begin += ViewEvaluator::BlockSize)
+    {
+        point_count_t count =
+            (std::min)(ViewEvaluator::BlockSize, view.size() - begin);
+        const double *vals = evaluator.eval(begin, count);
+        for (point_count_t i = 0; i < count; ++i)
+            pass[begin + i] = (vals[i] != 0);
+    }
+}
+
+void ConditionalExpression::eval(const PointSpan& span,
+    std::vector<char>& pass) const
+{
+    std::vector<double> vals;
+    m_program.eval(span, vals);
+    pass.resize(span.size());
+    for (point_count_t i = 0; i < span.size(); ++i)
+        pass[i] = (vals[i] != 0);
+}
+
+const Program& ConditionalExpression::program() const
+{
+    return m_program;
+}
+
 } // namespace expr
 } // namespace pdal
 
@@ -3,6 +3,7 @@
 #include "Expression.hpp"
 #include "Lexer.hpp"
 #include "ConditionalParser.hpp"
+#include "Program.hpp"
 
 namespace pdal
 {
@@ -14,6 +15,14 @@ class ConditionalExpression : public Expression
 public:
     Utils::StatusWithReason prepare(PointLayoutPtr layout);
     bool eval(PointRef& p) const;
+    // Evaluate the expression for all points of a view or span.
+    // \param pass  Filled with 1 for each point that passes, 0 otherwise.
+    void eval(const PointView& view, std::vector<char>& pass) const;
+    void eval(const PointSpan& span, std::vector<char>& pass) const;
+    const Program& program() const;
+
+private:
+    Program m_program;
 };
 
 } // namespace expr
@@ -1,4 +1,5 @@
 #include "Expression.hpp"
+#include "Program.hpp"
 
 namespace pdal
 {
@@ -37,6 +38,11 @@ Result NotNode::eval(PointRef& p) const
     return !(m_sub->eval(p).m_bval);
 }
 
+int NotNode::compile(Program& prog) const
+{
+    return prog.op(type(), prog.logical(*m_sub));
+}
+
 
 //
 // UnMathNode
@@ -60,6 +66,11 @@ Result UnMathNode::eval(PointRef& p) const
     return -(m_sub->eval(p).m_dval);
 }
 
+int UnMathNode::compile(Program& prog) const
+{
+    return prog.op(type(), prog.value(*m_sub));
+}
+
 
 //
 // BinMathNode
@@ -125,6 +136,11 @@ Result BinMathNode::eval(PointRef& p) const
     return 0.0;
 }
 
+int BinMathNode::compile(Program& prog) const
+{
+    return prog.op(type(), prog.value(*m_left), prog.value(*m_right));
+}
+
 //
 // Bool node
 //
@@ -175,6 +191,12 @@ Result BoolNode::eval(PointRef& p) const
     return false;
 }
 
+int BoolNode::compile(Program& prog) const
+{
+    return prog.op(type(), prog.logical(*m_left),
+        prog.logical(*m_right));
+}
+
 //
 // FuncNode
 //
@@ -192,6 +214,11 @@ Result FuncNode::eval(PointRef& p) const
     return m_func.function(m_sub->eval(p).m_dval);
 }
 
+int FuncNode::compile(Program& prog) const
+{
+    return prog.func(m_func.function, prog.value(*m_sub));
+}
+
 std::string FuncNode::print() const
 {
     return m_func.name + "(" + m_sub->print() + ")";
@@ -266,6 +293,11 @@ Result CompareNode::eval(PointRef& p) const
     return false;
 }
 
+int CompareNode::compile(Program& prog) const
+{
+    return prog.op(type(), prog.value(*m_left), prog.value(*m_right));
+}
+
 //
 // ConstValueNode
 //
@@ -288,6 +320,11 @@ Result ConstValueNode::eval(PointRef&) const
     return m_val;
 }
 
+int ConstValueNode::compile(Program& prog) const
+{
+    return prog.constant(m_val);
+}
+
 double ConstValueNode::value() const
 {
     return m_val;
@@ -316,6 +353,11 @@ Result ConstLogicalNode::eval(PointRef&) const
     return m_val;
 }
 
+int ConstLogicalNode::compile(Program& prog) const
+{
+    return prog.constant(m_val ? 1.0 : 0.0);
+}
+
 bool ConstLogicalNode::value() const
 {
     return m_val;
@@ -338,6 +380,11 @@ Result VarNode::eval(PointRef& p) const
     return p.getFieldAs<double>(m_id);
 }
 
+int VarNode::compile(Program& prog) const
+{
+    return prog.load(m_id);
+}
+
 Dimension::Id VarNode::eval() const
 {
     return m_id;
@@ -15,6 +15,8 @@ namespace pdal
 namespace expr
 {
 
+class Program;
+
 enum class NodeType
 {
     And,
@@ -79,6 +81,9 @@ public:
     virtual std::string print() const = 0;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l) = 0;
     virtual Result eval(PointRef& p) const = 0;
+    // Add the operations that evaluate the node to a program.  Returns
+    // the register holding the result.
+    virtual int compile(Program& prog) const = 0;
     virtual bool isBool() const = 0;
     virtual bool isValue() const
     { return !isBool(); }
@@ -120,6 +125,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef& p) const;
+    virtual int compile(Program& prog) const;
 
 private:
     NodePtr m_left;
@@ -135,6 +141,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef& p) const;
+    virtual int compile(Program& prog) const;
 
 private:
     Func1 m_func;
@@ -149,6 +156,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef& p) const;
+    virtual int compile(Program& prog) const;
 
 private:
     NodePtr m_sub;
@@ -162,6 +170,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef& p) const;
+    virtual int compile(Program& prog) const;
 
 private:
     NodePtr m_sub;
@@ -175,6 +184,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef& p) const;
+    virtual int compile(Program& prog) const;
 
 private:
     NodePtr m_left;
@@ -189,6 +199,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef& p) const;
+    virtual int compile(Program& prog) const;
 
 private:
     NodePtr m_left;
@@ -203,6 +214,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef&) const;
+    virtual int compile(Program& prog) const;
 
     double value() const;
 
@@ -218,6 +230,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef&) const;
+    virtual int compile(Program& prog) const;
 
     bool value() const;
 
@@ -233,6 +246,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef& p) const;
+    virtual int compile(Program& prog) const;
     Dimension::Id eval() const;
     inline std::string const& name() const { return m_name; }
 
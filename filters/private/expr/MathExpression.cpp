@@ -16,8 +16,11 @@ Utils::StatusWithReason MathExpression::prepare(PointLayoutPtr layout)
             if (!top->isValue())
                 status = { -1, "Expression doesn't evaluate to a value." };
         }
+        if (status)
+            m_program.compile(top, false);
         return status;
     }
+    m_program.compile(nullptr, false);
     return true;
 }
 
@@ -27,6 +30,11 @@ double MathExpression::eval(PointRef& p) const
     return n ? n->eval(p).m_dval : 0;
 }
 
+const Program& MathExpression::program() const
+{
+    return m_program;
+}
+
 } // namespace expr
 } // namespace pdal
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Expression.hpp"
+#include "Program.hpp"
 
 namespace pdal
 {
@@ -12,6 +13,10 @@ class MathExpression : public Expression
 public:
     Utils::StatusWithReason prepare(PointLayoutPtr layout);
     double eval(PointRef& p) const;
+    const Program& program() const;
+
+private:
+    Program m_program;
 };
 
 } // namespace expr
@@ -0,0 +1,188 @@
+#include "Program.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace pdal
+{
+namespace expr
+{
+
+Program::Program() : m_numRegs(0), m_result(-1)
+{}
+
+
+void Program::compile(const Node *root, bool condition)
+{
+    m_ops.clear();
+    m_dims.clear();
+    m_numRegs = 0;
+    if (!root)
+        m_result = constant(condition ? 1.0 : 0.0);
+    else
+        m_result = condition ? logical(*root) : value(*root);
+}
+
+
+int Program::load(Dimension::Id dim)
+{
+    // Fetch each dimension once.
+    for (const Op& op : m_ops)
+        if (op.m_type == NodeType::Identifier && m_dims[op.m_left] == dim)
+            return op.m_dst;
+
+    m_dims.push_back(dim);
+    m_ops.push_back({ NodeType::Identifier, m_numRegs,
+        (int)m_dims.size() - 1, -1, 0.0, nullptr });
+    return m_numRegs++;
+}
+
+
+int Program::constant(double val)
+{
+    m_ops.push_back({ NodeType::Value, m_numRegs, -1, -1, val, nullptr });
+    return m_numRegs++;
+}
+
+
+int Program::op(NodeType type, int left, int right)
+{
+    m_ops.push_back({ type, m_numRegs, left, right, 0.0, nullptr });
+    return m_numRegs++;
+}
+
+
+int Program::func(Func1::Ptr f, int sub)
+{
+    m_ops.push_back({ NodeType::Function, m_numRegs, sub, -1, 0.0, f });
+    return m_numRegs++;
+}
+
+
+int Program::logical(const Node& node)
+{
+    return node.isBool() ? node.compile(*this) : constant(0.0);
+}
+
+
+int Program::value(const Node& node)
+{
+    return node.isValue() ? node.compile(*this) : constant(0.0);
+}
+
+
+// Run the operations for a block of 'count' points.  fetch(dim, vals)
+// fills 'vals' with the values of the dimension at position 'dim' in
+// m_dims for the points of the block.
+template<typename FETCH>
+const double *Program::run(point_count_t count, std::vector<double>& regs,
+    FETCH fetch) const
+{
+    regs.resize(m_numRegs * count);
+    for (const Op& op : m_ops)
+    {
+        double *d = regs.data() + op.m_dst * count;
+        const double *l = regs.data() + op.m_left * count;
+        const double *r = regs.data() + op.m_right * count;
+        switch (op.m_type)
+        {
+        case NodeType::Identifier:
+            fetch(op.m_left, d);
+            break;
+        case NodeType::Value:
+            std::fill(d, d + count, op.m_val);
+            break;
+        case NodeType::Function:
+            for (point_count_t i = 0; i < count; ++i)
+                d[i] = op.m_func(l[i]);
+            break;
+        case NodeType::Negative:
+            for (point_count_t i = 0; i < count; ++i)
+                d[i] = -l[i];
+            break;
+        case NodeType::Add:
+            for (point_count_t i = 0; i < count; ++i)
+                d[i] = l[i] + r[i];
+            break;
+        case NodeType::Subtract:
+            for (point_count_t i = 0; i < count; ++i)
+                d[i] = l[i] - r[i];
+            break;
+        case NodeType::Multiply:
+            for (point_count_t i = 0; i < count; ++i)
+                d[i] = l[i] * r[i];
+            break;
+        case NodeType::Divide:
+            for (point_count_t i = 0; i < count; ++i)
+                d[i] = (r[i] == 0) ?
+                    std::numeric_limits<double>::quiet_NaN() : l[i] / r[i];
+            break;
+        case NodeType::Equal:
+            for (point_count_t i = 0; i < count; ++i)
+                d[i] = l[i] == r[i];
+            break;
+        case NodeType::NotEqual:
+            for (point_count_t i = 0; i < count; ++i)
+                d[i] = l[i] != r[i];
+            break;
+        case NodeType::Less:
+            for (point_count_t i = 0; i < count; ++i)
+                d[i] = l[i] < r[i];
+            break;
+        case NodeType::LessEqual:
+            for (point_count_t i = 0; i < count; ++i)
+                d[i] = l[i] <= r[i];
+            break;
+        case NodeType::Greater:
+            for (point_count_t i = 0; i < count; ++i)
+                d[i] = l[i] > r[i];
+            break;
+        case NodeType::GreaterEqual:
+            for (point_count_t i = 0; i < count; ++i)
+                d[i] = l[i] >= r[i];
+            break;
+        case NodeType::And:
+            for (point_count_t i = 0; i < count; ++i)
+                d[i] = (l[i] != 0) & (r[i] != 0);
+            break;
+        case NodeType::Or:
+            for (point_count_t i = 0; i < count; ++i)
+                d[i] = (l[i] != 0) | (r[i] != 0);
+            break;
+        case NodeType::Not:
+            for (point_count_t i = 0; i < count; ++i)
+                d[i] = l[i] == 0;
+            break;
+        default:
+            break;
+        }
+    }
+    return regs.data() + m_result * count;
+}
+
+
+void Program::eval(const PointSpan& span, std::vector<double>& vals) const
+{
+    std::vector<double> regs;
+    const double *result = run(span.size(), regs, [&](int dim, double *d)
+        { span.getField(m_dims[dim], d); });
+    vals.assign(result, result + span.size());
+}
+
+
+ViewEvaluator::ViewEvaluator(const Program& program, const PointView& view) :
+    m_program(program)
+{
+    for (Dimension::Id dim : program.m_dims)
+        m_columns.push_back(view.column<double>(dim));
+}
+
+
+const double *ViewEvaluator::eval(PointId begin, point_count_t count)
+{
+    return m_program.run(count, m_regs, [&](int dim, double *d)
+        { m_columns[dim].get(begin, count, d); });
+}
+
+} // namespace expr
+} // namespace pdal
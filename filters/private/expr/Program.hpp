@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+
+#include <pdal/PointColumn.hpp>
+#include <pdal/PointSpan.hpp>
+
+#include "Expression.hpp"
+
+namespace pdal
+{
+namespace expr
+{
+
+// An expression tree lowered to a flat list of operations on registers.
+// Each register holds one value for each point of a block, so each
+// operation is a simple loop over the block that the compiler can
+// vectorize, and dimension values are fetched a column at a time.  Logical
+// values are stored as 1.0 (true) and 0.0 (false).
+class Program
+{
+public:
+    Program();
+
+    // Lower a prepared expression tree.  A program compiled as a
+    // condition evaluates to 'true' if there is no tree.  Otherwise it
+    // evaluates to 0.
+    void compile(const Node *root, bool condition);
+
+    // Evaluate the program for all points of a span.
+    // \param span  Points on which to evaluate the program.
+    // \param vals  Filled with the value for each point.
+    void eval(const PointSpan& span, std::vector<double>& vals) const;
+
+    // Add operations to the program.  Each returns the register holding
+    // the result.  Used by Node::compile().
+    int load(Dimension::Id dim);
+    int constant(double val);
+    int op(NodeType type, int left, int right = -1);
+    int func(Func1::Ptr f, int sub);
+    // Compile a node used where a logical value is needed.  As with
+    // Node::eval(), a value used as a logical value is false.
+    int logical(const Node& node);
+    // Compile a node used where a value is needed.  As with Node::eval(),
+    // a logical value used as a value is 0.
+    int value(const Node& node);
+
+private:
+    struct Op
+    {
+        NodeType m_type;
+        int m_dst;
+        int m_left;
+        int m_right;
+        double m_val;
+        Func1::Ptr m_func;
+    };
+
+    std::vector<Op> m_ops;
+    // Dimensions fetched by the program.  Fetch operations refer to them
+    // by position.
+    std::vector<Dimension::Id> m_dims;
+    int m_numRegs;
+    int m_result;
+
+    template<typename FETCH>
+    const double *run(point_count_t count, std::vector<double>& regs,
+        FETCH fetch) const;
+
+    friend class ViewEvaluator;
+};
+
+// Evaluates a program for blocks of consecutive points of a view.  The
+// columns of the dimensions used by the program are set up once for the
+// view.  Values written to the view are seen by later evaluations.
+class ViewEvaluator
+{
+public:
+    // Maximum number of points in a block.
+    static const point_count_t BlockSize = 4096;
+
+    ViewEvaluator(const Program& program, const PointView& view);
+
+    // Evaluate the program for points [begin, begin + count) of the view.
+    // \param begin  First point.
+    // \param count  Number of points, no more than BlockSize.
+    // \return  Value for each point, valid until the next call.
+    const double *eval(PointId begin, point_count_t count);
+
+private:
+    const Program& m_program;
+    std::vector<PointColumn<double>> m_columns;
+    std::vector<double> m_regs;
+};
+
+} // namespace expr
+} // namespace pdal
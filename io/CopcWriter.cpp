@@ -47,6 +47,7 @@
 #include "private/las/Utils.hpp"
 #include "private/copcwriter/BuPyramid.hpp"
 #include "private/copcwriter/CellManager.hpp"
+#include "private/copcwriter/CellStore.hpp"
 #include "private/copcwriter/Grid.hpp"
 #include "private/copcwriter/Reprocessor.hpp"
 
@@ -68,7 +69,7 @@ const StaticPluginInfo s_info
 
 CREATE_STATIC_STAGE(CopcWriter, s_info);
 
-CopcWriter::CopcWriter() : b(new copcwriter::BaseInfo), isRemote(false)
+CopcWriter::CopcWriter() : b(new copcwriter::BaseInfo), layout(nullptr), isRemote(false)
 {}
 
 CopcWriter::~CopcWriter()
@@ -79,6 +80,8 @@ std::string CopcWriter::getName() const { return s_info.name; }
 void CopcWriter::initialize(PointTableRef table)
 {
     fillForwardList();
+    if (b->opts.memoryLimit == 0)
+        throwError("Option 'memory_limit' must be greater than 0.");
 }
 
 void CopcWriter::addArgs(ProgramArgs& args)
@@ -123,6 +126,8 @@ void CopcWriter::addArgs(ProgramArgs& args)
     args.add("threads", "", b->opts.threadCount).setHidden();
     args.add("enhanced_srs_vlrs", "Write WKT2 and PROJJSON as VLR?", b->opts.enhancedSrsVlrs,
         decltype(b->opts.enhancedSrsVlrs)(false));
+    args.add("memory_limit", "Approximate memory (MB) used to buffer points when streaming",
+        b->opts.memoryLimit, decltype(b->opts.memoryLimit)(1024));
 }
 
 void CopcWriter::fillForwardList()
@@ -228,7 +233,7 @@ void CopcWriter::handleForwardVlrs(MetadataNode& forwards)
 void CopcWriter::prepared(PointTableRef table)
 {
     // Set the pointFormatId based on whether or not colors exist in the output.
-    PointLayoutPtr layout = table.layout();
+    layout = table.layout();
     if (layout->hasDim(Dimension::Id::Infrared))
         b->pointFormatId = 8;
     else if (layout->hasDim(Dimension::Id::Red) ||
@@ -334,17 +339,11 @@ void CopcWriter::write(const PointViewPtr v)
 
     for (PointRef p : *v)
     {
+        addStats(p);
+
         double x = p.getFieldAs<double>(Dimension::Id::X);
         double y = p.getFieldAs<double>(Dimension::Id::Y);
         double z = p.getFieldAs<double>(Dimension::Id::Z);
-        double t = p.getFieldAs<double>(Dimension::Id::GpsTime);
-        double r = p.getFieldAs<double>(Dimension::Id::ReturnNumber);
-        b->stats[(int)stats::Index::X].insert(x);
-        b->stats[(int)stats::Index::Y].insert(y);
-        b->stats[(int)stats::Index::Z].insert(z);
-        b->stats[(int)stats::Index::GpsTime].insert(t);
-        b->stats[(int)stats::Index::ReturnNumber].insert(r);
-
         VoxelKey key = grid.key(x, y, z);
         PointViewPtr& cell = mgr.get(key);
         cell->appendPoint(*v, p.pointId());
@@ -372,12 +371,34 @@ void CopcWriter::write(const PointViewPtr v)
     }
     mgr.merge(reprocessMgr);
 
+    setHeader(grid, v->spatialReference());
+
+    BuPyramid bu(*b);
+    bu.run(mgr);
+}
+
+void CopcWriter::addStats(PointRef& p)
+{
+    double x = p.getFieldAs<double>(Dimension::Id::X);
+    double y = p.getFieldAs<double>(Dimension::Id::Y);
+    double z = p.getFieldAs<double>(Dimension::Id::Z);
+    double t = p.getFieldAs<double>(Dimension::Id::GpsTime);
+    double r = p.getFieldAs<double>(Dimension::Id::ReturnNumber);
+    b->stats[(int)stats::Index::X].insert(x);
+    b->stats[(int)stats::Index::Y].insert(y);
+    b->stats[(int)stats::Index::Z].insert(z);
+    b->stats[(int)stats::Index::GpsTime].insert(t);
+    b->stats[(int)stats::Index::ReturnNumber].insert(r);
+}
+
+void CopcWriter::setHeader(copcwriter::Grid& grid, const SpatialReference& srs)
+{
     b->bounds = grid.processingBounds();
     b->trueBounds = grid.conformingBounds();
     if (!b->opts.aSrs.empty())
        b->srs = b->opts.aSrs;
     else
-       b->srs = v->spatialReference();
+       b->srs = srs;
 
     if (b->opts.enhancedSrsVlrs) {
         auto addVlr = [&](const std::string& userId, uint16_t recordId, const std::string& desc, const std::string& str)
@@ -418,14 +439,58 @@ void CopcWriter::write(const PointViewPtr v)
         b->scaling.m_yXform.m_offset = XForm::XFormComponent(t[1]);
     if (b->scaling.m_zXform.m_offset.m_auto)
         b->scaling.m_zXform.m_offset = XForm::XFormComponent(t[2]);
+}
+
+// When streaming, points are held in a CellStore in a directory next to the output file
+// and the file is written once all points have been seen.
+bool CopcWriter::processOne(PointRef& point)
+{
+    if (!store)
+    {
+        store.reset(new copcwriter::CellStore(b->opts.filename, *layout,
+            b->opts.memoryLimit * 1024 * 1024));
+        log()->get(LogLevel::Debug) << "writers.copc spilling points to '" <<
+            store->directory() << "'.\n";
+    }
 
+    addStats(point);
+    store->append(point);
+    return true;
+}
+
+void CopcWriter::spatialReferenceChanged(const SpatialReference& srs)
+{
+    streamSrs = srs;
+}
+
+void CopcWriter::writeStore()
+{
+    using namespace copcwriter;
+
+    Grid grid(store->bounds(), store->size());
+    store->bin(grid);
+
+    setHeader(grid, streamSrs);
+
+    b->store = store.get();
     BuPyramid bu(*b);
-    bu.run(mgr);
+    bu.run(*store);
+    b->store = nullptr;
+    store.reset();
 }
 
 void CopcWriter::done(PointTableRef table)
 {
-
+    // The store is created with the first streamed point, so there's no store when
+    // no points were streamed.  As with an empty point view, no file is written.
+    if (store)
+        writeStore();
+    else if (b->viewCount == 0)
+    {
+        log()->get(LogLevel::Warning) << "writers.copc received no points. "
+            "No output file was written.\n";
+        return;
+    }
 
     if (isRemote)
     {
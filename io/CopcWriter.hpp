@@ -34,6 +34,7 @@
 
 #pragma once
 
+#include <pdal/Streamable.hpp>
 #include <pdal/Writer.hpp>
 
 namespace pdal
@@ -41,9 +42,11 @@ namespace pdal
 namespace copcwriter
 {
     struct BaseInfo;
+    class CellStore;
+    class Grid;
 }
 
-class PDAL_DLL CopcWriter : public Writer
+class PDAL_DLL CopcWriter : public Writer, public Streamable
 {
 public:
     CopcWriter();
@@ -56,6 +59,8 @@ private:
     virtual void prepared(PointTableRef table) override;
     virtual void ready(PointTableRef table) override;
     virtual void write(const PointViewPtr view) override;
+    virtual bool processOne(PointRef& point) override;
+    virtual void spatialReferenceChanged(const SpatialReference& srs) override;
     virtual void done(PointTableRef table) override;
 
     void fillForwardList();
@@ -65,8 +70,14 @@ private:
     void handleForwardVlrs(MetadataNode& forward);
     void handleUserVlrs(MetadataNode m);
     void handlePipelineVlr();
+    void addStats(PointRef& point);
+    void setHeader(copcwriter::Grid& grid, const SpatialReference& srs);
+    void writeStore();
 
     std::unique_ptr<copcwriter::BaseInfo> b;
+    std::unique_ptr<copcwriter::CellStore> store;
+    PointLayoutPtr layout;
+    SpatialReference streamSrs;
     bool isRemote;
     std::string remoteFilename;
 };
@@ -50,6 +50,7 @@
 #include <pdal/Metadata.hpp>
 #include <pdal/PointView.hpp>
 #include <pdal/QuickInfo.hpp>
+#include <pdal/util/Executor.hpp>
 #include <pdal/util/Extractor.hpp>
 #include <pdal/util/IStream.hpp>
 #include <pdal/util/ProgramArgs.hpp>
@@ -156,7 +157,6 @@ struct LasReader::Private
     las::ChunkInfo chunkInfo;
     std::vector<las::TilePtr> tiles;
     std::vector<las::ExtraDim> extraDims;
-    ThreadPool pool;
     // One past the Index of the last point we want to fetch.
     PointId end;
     // The index of the chunk we want to fetch next.
@@ -170,8 +170,11 @@ struct LasReader::Private
     std::mutex mutex;
     std::condition_variable processedCv;
     bool isRemote;
+    // Declared last so that running tasks finish before the state they use
+    // is destroyed.
+    std::unique_ptr<TaskGroup> tasks;
 
-    Private() : apiHeader(header, srs, vlrs), index(0), pool(DefaultNumThreads), isRemote(false)
+    Private() : apiHeader(header, srs, vlrs), index(0), isRemote(false)
     {}
 };
 
@@ -472,7 +475,7 @@ void LasReader::initializeLocal(PointTableRef table, MetadataNode& m)
 
 void LasReader::ready(PointTableRef table)
 {
-    d->pool.resize(d->opts.numThreads);
+    d->tasks.reset(new TaskGroup(d->opts.numThreads));
     LasStreamPtr lasStream(createStream());
     std::istream& stream(*lasStream);
 
@@ -528,7 +531,7 @@ void LasReader::queueNextCompressedChunk()
     uint32_t chunk = d->nextFetchChunk;
     uint32_t start = d->nextFetchPoint;
 
-    d->pool.add([this, chunk, start]()
+    d->tasks->add([this, chunk, start]()
     {
         uint32_t chunkpoints = d->chunkInfo.chunkPoints(chunk);
         uint64_t chunkoffset = d->chunkInfo.chunkOffset(chunk);
@@ -587,7 +590,7 @@ void LasReader::queueNextStandardChunk()
     int chunk = d->nextFetchChunk;
     uint64_t start = d->nextFetchPoint;
     uint64_t count = (std::min)(chunkSize, d->end - start);
-    d->pool.add([this, chunk, count, start]()
+    d->tasks->add([this, chunk, count, start]()
     {
         LasStreamPtr lasStream = createStream();
         std::istream& in(*lasStream);
@@ -693,13 +696,11 @@ bool LasReader::processOne(PointRef& point)
     {
         {
             std::unique_lock<std::mutex> l(d->mutex);
-            while (true)
+            Executor::global().wait(l, d->processedCv, [this, &getTile]()
             {
                 d->currentTile = getTile(d->nextReadChunk);
-                if (d->currentTile)
-                    break;
-                d->processedCv.wait(l);
-            }
+                return (bool)d->currentTile;
+            });
         }
 
         // Found the tile we wanted. Queue the next file read.
@@ -917,7 +918,7 @@ void LasReader::loadExtraDims(LeExtractor& istream, PointRef& point)
 
 void LasReader::done(PointTableRef)
 {
-    d->pool.join();
+    d->tasks.reset();
     if (d->isRemote)
         FileUtils::deleteFile(m_filename);
 }
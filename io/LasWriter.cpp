@@ -71,6 +71,8 @@ static StaticPluginInfo const s_info
 
 CREATE_STATIC_STAGE(LasWriter, s_info)
 
+constexpr int DefaultNumThreads = 7;
+
 std::string LasWriter::getName() const { return s_info.name; }
 
 struct LasWriter::Options
@@ -99,6 +101,7 @@ struct LasWriter::Options
     StringHeaderVal<0> offsetZ;
     std::vector<las::Evlr> userVlrs;
     bool enhancedSrsVlrs;
+    int numThreads;
 };
 
 struct LasWriter::Private
@@ -175,6 +178,8 @@ void LasWriter::addArgs(ProgramArgs& args)
     args.add("vlrs", "List of VLRs to set", d->opts.userVlrs);
     args.add("enhanced_srs_vlrs", "Write WKT2 and PROJJSON as VLR?", d->opts.enhancedSrsVlrs,
         decltype(d->opts.enhancedSrsVlrs)(false));
+    args.add("threads", "Number of threads used to compress LAZ data", d->opts.numThreads,
+        DefaultNumThreads);
 }
 
 void LasWriter::initialize()
@@ -188,6 +193,8 @@ void LasWriter::initialize()
         setSpatialReference(d->opts.aSrs);
     if (d->opts.compression == las::Compression::True)
         d->header.setDataCompressed();
+    if (d->opts.numThreads < 1)
+        throwError("Option 'threads' must be greater than 0.");
 
     try
     {
@@ -748,7 +755,7 @@ void LasWriter::readyCompression()
 {
     deleteVlr(las::LaszipUserId, las::LaszipRecordId);
     m_compressor = new LazPerfVlrCompressor(*m_ostream, d->header.pointFormat(),
-        d->header.ebCount());
+        d->header.ebCount(), LazPerfVlrCompressor::DefaultChunkSize, d->opts.numThreads);
     std::vector<char> lazVlrData = m_compressor->vlrData();
     std::vector<char> vlrdata(lazVlrData.begin(), lazVlrData.end());
     addVlr(las::LaszipUserId, las::LaszipRecordId, "http://laszip.org", vlrdata);
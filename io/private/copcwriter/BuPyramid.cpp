@@ -32,6 +32,7 @@
 * OF SUCH DAMAGE.
 ****************************************************************************/
 
+#include <algorithm>
 #include <iomanip>
 #include <set>
 #include <string>
@@ -54,30 +55,82 @@ BuPyramid::BuPyramid(const BaseInfo& common) : m_manager(common)
 {}
 
 
+namespace
+{
+
+// Whether 'k1' is visited before 'k2' in a depth-first walk of the octree.
+bool depthFirstLess(VoxelKey k1, VoxelKey k2)
+{
+    // Compare the keys at the level of the shallower key.  If one key is an ancestor of
+    // the other, the ancestor comes first.
+    int level = (std::min)(k1.level(), k2.level());
+    int s1 = k1.level() - level;
+    int s2 = k2.level() - level;
+    VoxelKey a(k1.x() >> s1, k1.y() >> s1, k1.z() >> s1, level);
+    VoxelKey b(k2.x() >> s2, k2.y() >> s2, k2.z() >> s2, level);
+    if (a == b)
+        return k1.level() < k2.level();
+
+    // Order by the highest bit at which the keys differ. At a bit position, Z is more
+    // significant than Y, which is more significant than X, as in VoxelKey::child().
+    auto lessMsb = [](int i, int j) { return i < j && i < (i ^ j); };
+    int x = a.x() ^ b.x();
+    int y = a.y() ^ b.y();
+    int z = a.z() ^ b.z();
+    if (!lessMsb(z, y) && !lessMsb(z, x))
+        return a.z() < b.z();
+    if (!lessMsb(y, x))
+        return a.y() < b.y();
+    return a.x() < b.x();
+}
+
+} // unnamed namespace
+
+
 void BuPyramid::run(CellManager& cells)
 {
-    queueWork(cells);
+    std::vector<OctantInfo> have;
+    for (auto& kv : cells)
+    {
+        // Stick an OctantInfo for this cell in the 'have' list.
+        OctantInfo o(kv.first);
+        o.source() = kv.second;
+        have.push_back(o);
+    }
+    run(have);
+}
+
+
+void BuPyramid::run(const CellStore& store)
+{
+    std::vector<OctantInfo> have;
+    for (auto& kv : store.cells())
+    {
+        OctantInfo o(kv.first);
+        o.setStored(kv.second);
+        have.push_back(o);
+    }
+    run(have);
+}
+
+
+void BuPyramid::run(std::vector<OctantInfo>& have)
+{
+    queueWork(have);
     std::thread runner(&PyramidManager::run, &m_manager);
     runner.join();
 }
 
 
-size_t BuPyramid::queueWork(CellManager& cells)
+size_t BuPyramid::queueWork(std::vector<OctantInfo>& have)
 {
     std::set<VoxelKey> needed;
     std::set<VoxelKey> parentsToProcess;
-    std::vector<OctantInfo> have;
     const VoxelKey root;
 
-    for (auto& kv : cells)
+    for (const OctantInfo& o : have)
     {
-        VoxelKey k = kv.first;
-        PointViewPtr v = kv.second;
-
-        // Stick an OctantInfo for this cell in the 'have' list.
-        OctantInfo o(k);
-        o.source() = v;
-        have.push_back(o);
+        VoxelKey k = o.key();
 
         // Walk up the tree and make sure that we're populated for all children necessary
         // to process to the top level.  We do this in order to facilitate processing --
@@ -103,13 +156,18 @@ size_t BuPyramid::queueWork(CellManager& cells)
         }
     }
 
-    // Queue what we have.
-    for (const OctantInfo& o : have)
-        m_manager.queue(o);
-
     // Queue what we need but have no data for.
     for (const VoxelKey& k : needed)
         m_manager.queue(OctantInfo(k));
+
+    // Queue what we have in depth-first order.  Since the empty octants are already
+    // queued, the children of a voxel are complete soon after one another and
+    // voxels are processed as soon as their children are, which limits the number
+    // of processed voxels waiting for their siblings.
+    std::sort(have.begin(), have.end(), [](const OctantInfo& o1, const OctantInfo& o2)
+        { return depthFirstLess(o1.key(), o2.key()); });
+    for (const OctantInfo& o : have)
+        m_manager.queue(o);
     return parentsToProcess.size();
 }
 
@@ -40,6 +40,7 @@
 #include <vector>
 
 #include "CellManager.hpp"
+#include "CellStore.hpp"
 #include "Common.hpp"
 #include "PyramidManager.hpp"
 
@@ -56,9 +57,11 @@ class BuPyramid
 public:
     BuPyramid(const BaseInfo& common);
     void run(CellManager& cells);
+    void run(const CellStore& store);
 
 private:
-    size_t queueWork(CellManager& cells);
+    void run(std::vector<OctantInfo>& have);
+    size_t queueWork(std::vector<OctantInfo>& have);
     void writeInfo();
 
     PyramidManager m_manager;
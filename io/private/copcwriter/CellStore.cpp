@@ -0,0 +1,277 @@
+/******************************************************************************
+* Copyright (c) 2021, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstring>
+#include <random>
+#include <sstream>
+
+#include <pdal/PDALUtils.hpp>
+#include <pdal/util/FileUtils.hpp>
+
+#include "CellStore.hpp"
+#include "Common.hpp"
+#include "Grid.hpp"
+#include "Reprocessor.hpp"
+
+namespace pdal
+{
+namespace copcwriter
+{
+
+namespace
+{
+
+// Number of points read from a file at once.
+const size_t ReadPoints = 65536;
+
+} // unnamed namespace
+
+CellStore::CellStore(const std::string& path, const PointLayout& layout, size_t memoryLimit) :
+    m_layout(layout), m_dimTypes(layout.dimTypes()),
+    m_pointSize(layout.pointSize()), m_memoryLimit(memoryLimit), m_count(0)
+{
+    size_t offset = 0;
+    for (const DimType& dt : m_dimTypes)
+    {
+        if (dt.m_id == Dimension::Id::X)
+            m_xyz[0] = { offset, dt.m_type };
+        else if (dt.m_id == Dimension::Id::Y)
+            m_xyz[1] = { offset, dt.m_type };
+        else if (dt.m_id == Dimension::Id::Z)
+            m_xyz[2] = { offset, dt.m_type };
+        offset += Dimension::size(dt.m_type);
+    }
+
+    // The spill files go in a new directory of our own.  An existing path is
+    // never reused, so files that the store didn't create aren't touched.
+    std::random_device rd;
+    std::ostringstream oss;
+    oss << path << ".spill-" << std::hex << rd() << rd();
+    m_dir = oss.str();
+    if (FileUtils::fileExists(m_dir) || !FileUtils::createDirectory(m_dir))
+        throw pdal_error("Unable to create spill directory '" + m_dir +
+            "'. The path already exists or can't be created.");
+    m_out.open(rawFilename(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_out)
+        throw pdal_error("Unable to open spill file '" + rawFilename() + "'.");
+}
+
+
+// Remove only the files that the store creates, then the directory, which
+// is empty unless something else has put a file there.
+CellStore::~CellStore()
+{
+    m_out.close();
+    try
+    {
+        FileUtils::deleteFile(rawFilename());
+        for (auto& kv : m_cells)
+            FileUtils::deleteFile(filename(kv.first));
+        FileUtils::deleteFile(m_dir);
+    }
+    catch (...)
+    {}
+}
+
+
+std::string CellStore::rawFilename() const
+{
+    return m_dir + "/points.bin";
+}
+
+
+std::string CellStore::filename(const VoxelKey& key) const
+{
+    return m_dir + "/" + key.toString() + ".bin";
+}
+
+
+double CellStore::coord(const char *point, int i) const
+{
+    Everything e;
+    std::memcpy(&e, point + m_xyz[i].first, Dimension::size(m_xyz[i].second));
+    return Utils::toDouble(e, m_xyz[i].second);
+}
+
+
+void CellStore::append(PointRef& point)
+{
+    size_t pos = m_buf.size();
+    m_buf.resize(pos + m_pointSize);
+    point.getPackedData(m_dimTypes, m_buf.data() + pos);
+    m_bounds.grow(coord(m_buf.data() + pos, 0), coord(m_buf.data() + pos, 1),
+        coord(m_buf.data() + pos, 2));
+    m_count++;
+    if (m_buf.size() >= m_memoryLimit)
+        flush();
+}
+
+
+void CellStore::flush()
+{
+    m_out.write(m_buf.data(), m_buf.size());
+    if (!m_out)
+        throw pdal_error("Failure writing spill file '" + rawFilename() + "'.");
+    m_buf.clear();
+}
+
+
+// Append the buffered points of each voxel to the voxel's file.
+void CellStore::flush(Buffers& buffers)
+{
+    for (auto& kv : buffers)
+    {
+        const std::string name(filename(kv.first));
+        std::ofstream out(name, std::ios::out | std::ios::binary | std::ios::app);
+        out.write(kv.second.data(), kv.second.size());
+        out.close();
+        if (!out)
+            throw pdal_error("Failure writing spill file '" + name + "'.");
+    }
+    buffers.clear();
+}
+
+
+void CellStore::bin(Grid& grid)
+{
+    flush();
+    m_out.close();
+    std::vector<char>().swap(m_buf);
+    distribute(rawFilename(), m_count, grid);
+
+    // Split voxels with too many points into voxels at a deeper level, as is done when
+    // points are held in memory.
+    std::vector<std::pair<VoxelKey, point_count_t>> large;
+    for (auto& kv : m_cells)
+        if (kv.second >= MaxPointsPerNode)
+            large.push_back(kv);
+    for (auto& kv : large)
+    {
+        m_cells.erase(kv.first);
+        FileUtils::renameFile(rawFilename(), filename(kv.first));
+
+        Grid splitGrid(grid);
+        splitGrid.resetLevel(grid.maxLevel() + Reprocessor::levels(kv.second));
+        distribute(rawFilename(), kv.second, splitGrid);
+    }
+}
+
+
+// Append the points of a file to the files of their voxels in the grid and remove it.
+void CellStore::distribute(const std::string& src, point_count_t count, Grid& grid)
+{
+    std::ifstream in(src, std::ios::in | std::ios::binary);
+    std::vector<char> block(ReadPoints * m_pointSize);
+    Buffers buffers;
+    size_t buffered = 0;
+    while (count)
+    {
+        point_count_t blockCount = (std::min)((point_count_t)ReadPoints, count);
+        in.read(block.data(), blockCount * m_pointSize);
+        if (!in)
+            throw pdal_error("Failure reading spill file '" + src + "'.");
+        count -= blockCount;
+
+        for (const char *p = block.data(); p < block.data() + blockCount * m_pointSize;
+                p += m_pointSize)
+        {
+            VoxelKey key = grid.key(coord(p, 0), coord(p, 1), coord(p, 2));
+            std::vector<char>& buf = buffers[key];
+            buf.insert(buf.end(), p, p + m_pointSize);
+            m_cells[key]++;
+            buffered += m_pointSize;
+        }
+        if (buffered >= m_memoryLimit)
+        {
+            flush(buffers);
+            buffered = 0;
+        }
+    }
+    flush(buffers);
+    in.close();
+    FileUtils::deleteFile(src);
+}
+
+
+std::shared_ptr<PointTable> CellStore::makeTable() const
+{
+    return std::make_shared<PointTable>(m_layout);
+}
+
+
+PointViewPtr CellStore::load(const VoxelKey& key, PointTable& table) const
+{
+    const std::string name(filename(key));
+    auto it = m_cells.find(key);
+    point_count_t remaining = (it == m_cells.end()) ? 0 : it->second;
+
+    PointViewPtr v(new PointView(table));
+    std::ifstream in(name, std::ios::in | std::ios::binary);
+    std::vector<char> block(ReadPoints * m_pointSize);
+    while (remaining)
+    {
+        point_count_t count = (std::min)((point_count_t)ReadPoints, remaining);
+        in.read(block.data(), count * m_pointSize);
+        if (!in)
+            throw pdal_error("Failure reading spill file '" + name + "'.");
+        remaining -= count;
+        for (const char *p = block.data(); p < block.data() + count * m_pointSize;
+                p += m_pointSize)
+            v->setPackedPoint(m_dimTypes, v->size(), p);
+    }
+    in.close();
+    FileUtils::deleteFile(name);
+    return v;
+}
+
+
+void CellStore::pack(PointView& view, std::vector<char>& buf) const
+{
+    buf.resize(view.size() * m_pointSize);
+    char *p = buf.data();
+    for (PointId idx = 0; idx < view.size(); ++idx, p += m_pointSize)
+        view.getPackedPoint(m_dimTypes, idx, p);
+}
+
+
+PointViewPtr CellStore::unpack(const std::vector<char>& buf, PointTable& table) const
+{
+    PointViewPtr v(new PointView(table));
+    for (const char *p = buf.data(); p < buf.data() + buf.size(); p += m_pointSize)
+        v->setPackedPoint(m_dimTypes, v->size(), p);
+    return v;
+}
+
+} // namespace copcwriter
+} // namespace pdal
@@ -0,0 +1,121 @@
+/******************************************************************************
+* Copyright (c) 2021, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <pdal/PointTable.hpp>
+#include <pdal/PointView.hpp>
+#include <pdal/util/Bounds.hpp>
+
+#include "VoxelKey.hpp"
+
+namespace pdal
+{
+namespace copcwriter
+{
+
+class Grid;
+
+// Holds streamed points on disk.  The voxel of a point can't be determined
+// until the bounds of all the points are known, so points are first appended
+// to a single file.  They are then binned into a file for each leaf voxel
+// from which they're loaded as the voxel is processed.  No more than the
+// memory limit is used to buffer points.  The files are kept in a new,
+// uniquely named directory that is removed when the store is destroyed.
+class CellStore
+{
+public:
+    // Number of points in each leaf voxel.
+    using Cells = std::map<VoxelKey, point_count_t>;
+
+    // The name of the spill directory starts with 'path'.  Throws if the
+    // directory can't be created or already exists.
+    CellStore(const std::string& path, const PointLayout& layout, size_t memoryLimit);
+    ~CellStore();
+
+    // Add a point to the store.
+    void append(PointRef& point);
+    // Bin the points into the voxels of the grid.
+    void bin(Grid& grid);
+    // Make a table to hold points loaded from the store.
+    std::shared_ptr<PointTable> makeTable() const;
+    // Load the points of a leaf voxel.  The voxel's file is removed.
+    PointViewPtr load(const VoxelKey& key, PointTable& table) const;
+    // Pack the points of a view.
+    void pack(PointView& view, std::vector<char>& buf) const;
+    // Make a view of packed points.
+    PointViewPtr unpack(const std::vector<char>& buf, PointTable& table) const;
+
+    const Cells& cells() const
+        { return m_cells; }
+    point_count_t size() const
+        { return m_count; }
+    const BOX3D& bounds() const
+        { return m_bounds; }
+    const std::string& directory() const
+        { return m_dir; }
+
+private:
+    using Buffers = std::map<VoxelKey, std::vector<char>>;
+
+    std::string m_dir;
+    PointLayout m_layout;
+    DimTypeList m_dimTypes;
+    size_t m_pointSize;
+    // Offset and type of X, Y and Z in a packed point.
+    std::array<std::pair<size_t, Dimension::Type>, 3> m_xyz;
+    size_t m_memoryLimit;
+    std::vector<char> m_buf;
+    std::ofstream m_out;
+    point_count_t m_count;
+    BOX3D m_bounds;
+    Cells m_cells;
+
+    double coord(const char *point, int i) const;
+    std::string filename(const VoxelKey& key) const;
+    std::string rawFilename() const;
+    void flush();
+    void flush(Buffers& buffers);
+    void distribute(const std::string& src, point_count_t count, Grid& grid);
+};
+
+} // namespace copcwriter
+} // namespace pdal
@@ -74,6 +74,8 @@ enum class Index
 namespace copcwriter
 {
 
+class CellStore;
+
 // These are hopes, not absolutes.
 const int MaxPointsPerNode = 100000;
 const int MinimumPoints = 100;
@@ -110,6 +112,7 @@ struct Options
     pdal::SpatialReference aSrs;
     int threadCount = 10;
     bool enhancedSrsVlrs = false;
+    size_t memoryLimit = 1024;
 };
 
 struct BaseInfo
@@ -128,6 +131,8 @@ struct BaseInfo
     bool forwardVlrs = false;
     int viewCount = 0;
     std::vector<las::Evlr> vlrs;
+    // Points when streaming.  Null if points are held in memory.
+    CellStore *store = nullptr;
 
     std::array<stats::Summary, 5> stats
     {
@@ -35,6 +35,9 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "VoxelKey.hpp"
 #include <pdal/PointView.hpp>
 
@@ -46,10 +49,10 @@ namespace copcwriter
 class OctantInfo
 {
 public:
-    OctantInfo() : m_mustWrite(false)
+    OctantInfo() : m_stored(0), m_mustWrite(false)
     {}
 
-    OctantInfo(const VoxelKey& key) : m_mustWrite(false)
+    OctantInfo(const VoxelKey& key) : m_stored(0), m_mustWrite(false)
         { m_key = key; }
 
     void movePoints(OctantInfo& oi)
@@ -69,9 +72,22 @@ public:
         return m_source;
     }
 
+    // Points packed by a CellStore when they aren't in a view.  Null if the points are
+    // in a view or in the CellStore's file for the octant.
+    std::shared_ptr<std::vector<char>>& packed()
+    {
+        return m_packed;
+    }
+
+    // Set the number of points of an octant whose points aren't in a view.
+    void setStored(point_count_t count)
+    {
+        m_stored = count;
+    }
+
     size_t numPoints() const
     {
-        return m_source ? m_source->size() : 0;
+        return m_source ? m_source->size() : m_stored;
     }
 
     VoxelKey key() const
@@ -85,6 +101,8 @@ public:
 
 private:
     PointViewPtr m_source;
+    std::shared_ptr<std::vector<char>> m_packed;
+    point_count_t m_stored;
     VoxelKey m_key;
     bool m_mustWrite;
 };
@@ -41,6 +41,7 @@
 
 #include <lazperf/writers.hpp>
 
+#include "CellStore.hpp"
 #include "GridKey.hpp"
 #include "Processor.hpp"
 #include "PyramidManager.hpp"
@@ -58,6 +59,8 @@ Processor::Processor(PyramidManager& manager, const VoxelInfo& v, const BaseInfo
 void Processor::run()
 {
     m_loader.init(b.pointFormatId, b.scaling, b.extraDims);
+    if (b.store)
+        gather();
     m_vi.initParentOctant();
 
     size_t totalPoints = 0;
@@ -79,9 +82,42 @@ void Processor::run()
 
     sample();
     write();
-    m_manager.queue(m_vi.octant());
+    if (b.store)
+        compact();
+    m_manager.queueProcessed(m_vi.octant());
 }
 
+
+// Put the points of the children in a table for this voxel.
+void Processor::gather()
+{
+    m_table = b.store->makeTable();
+    for (int i = 0; i < 8; ++i)
+    {
+        OctantInfo& child = m_vi.child(i);
+        if (child.packed())
+        {
+            child.source() = b.store->unpack(*child.packed(), *m_table);
+            child.packed().reset();
+        }
+        else if (child.numPoints())
+            child.source() = b.store->load(child.key(), *m_table);
+    }
+}
+
+
+// Pack the points accepted into this voxel so that only they are held once the
+// voxel is processed.
+void Processor::compact()
+{
+    OctantInfo& parent = m_vi.octant();
+    parent.packed() = std::make_shared<std::vector<char>>();
+    b.store->pack(*parent.source(), *parent.packed());
+    parent.setStored(parent.source()->size());
+    parent.source().reset();
+}
+
+
 void Processor::write()
 {
     OctantInfo& parent = m_vi.octant();
@@ -178,10 +214,7 @@ void Processor::writeCompressed(VoxelKey k, PointViewPtr v)
     lazperf::writer::chunk_compressor compressor(b.pointFormatId, b.numExtraBytes);
 
     // Sort by GPS time - no-op if there's no GPS time.
-    v->stableSort([](const PointRef& p1, const PointRef& p2)
-    {
-        return p1.compare(Dimension::Id::GpsTime, p2);
-    });
+    v->stableSort({ { Dimension::Id::GpsTime, false } });
 
     for (PointId idx = 0; idx < v->size(); ++idx)
     {
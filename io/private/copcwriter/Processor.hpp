@@ -34,6 +34,9 @@
 
 #pragma once
 
+#include <memory>
+
+#include <pdal/PointTable.hpp>
 #include <pdal/PointView.hpp>
 
 #include "Common.hpp"
@@ -56,11 +59,16 @@ public:
     void run();
 
 private:
+    void gather();
+    void compact();
     void sample();
     void write();
     bool acceptable(GridKey key);
     void writeCompressed(VoxelKey k, PointViewPtr v);
 
+    // Holds the points of the voxel when points are streamed.  Declared before
+    // m_vi so that it outlives the views on it.
+    std::shared_ptr<PointTable> m_table;
     VoxelInfo m_vi;
     const BaseInfo& b;
     PyramidManager& m_manager;
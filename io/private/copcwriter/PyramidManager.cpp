@@ -32,6 +32,7 @@
 * OF SUCH DAMAGE.
 ****************************************************************************/
 
+#include <algorithm>
 #include <regex>
 #include <string>
 #include <vector>
@@ -48,8 +49,8 @@ namespace pdal
 namespace copcwriter
 {
 
-PyramidManager::PyramidManager(const BaseInfo& b) : m_b(b), m_pool(b.opts.threadCount), m_totalPoints(0),
-    m_output(b)
+PyramidManager::PyramidManager(const BaseInfo& b) : m_b(b), m_tasks(b.opts.threadCount),
+    m_running(0), m_totalPoints(0), m_output(b)
 {}
 
 
@@ -61,7 +62,21 @@ void PyramidManager::queue(const OctantInfo& o)
 {
     {
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_queue.push(o);
+        m_queue.push_back(o);
+    }
+    m_cv.notify_one();
+}
+
+
+// Octants that have been processed are handled ahead of the octants queued initially so
+// that a voxel is processed soon after its children, rather than after all the leaves.
+// Along with the limit on the number of running processors, this bounds the number of
+// processed octants waiting for their siblings.
+void PyramidManager::queueProcessed(const OctantInfo& o)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_front(o);
     }
     m_cv.notify_one();
 }
@@ -76,9 +91,17 @@ void PyramidManager::run()
         {
             std::unique_lock<std::mutex> lock(m_mutex);
 
-            m_cv.wait(lock, [this](){return m_queue.size();});
+            Executor::global().wait(lock, m_cv, [this]()
+                {return (m_queue.size() && m_running < (std::max)(m_b.opts.threadCount, 1)) ||
+                    m_error;});
+            if (m_error)
+            {
+                lock.unlock();
+                m_tasks.wait();
+                std::rethrow_exception(m_error);
+            }
             o = m_queue.front();
-            m_queue.pop();
+            m_queue.pop_front();
         }
 
         // We're done if we have processed the root key.
@@ -136,13 +159,31 @@ void PyramidManager::process(const OctantInfo& o)
 
     // If there are no points in this voxel, just queue it as a child.
     if (!vi.hasPoints())
-        queue(vi.octant());
+        queueProcessed(vi.octant());
     else
     {
-        m_pool.add([vi, this]()
         {
-            Processor p(*this, vi, m_b);
-            p.run();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running++;
+        }
+        m_tasks.add([vi, this]()
+        {
+            try
+            {
+                Processor p(*this, vi, m_b);
+                p.run();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_error)
+                    m_error = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_running--;
+            }
+            m_cv.notify_one();
         });
     }
 }
@@ -34,12 +34,13 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <vector>
 
-#include <pdal/util/ThreadPool.hpp>
+#include <pdal/util/Executor.hpp>
 
 #include "Common.hpp"
 #include "OctantInfo.hpp"
@@ -61,6 +62,7 @@ public:
     ~PyramidManager();
 
     void queue(const OctantInfo& o);
+    void queueProcessed(const OctantInfo& o);
     void run();
     uint64_t newChunk(const VoxelKey& key, uint32_t size, uint32_t count);
     uint64_t totalPoints() const
@@ -71,8 +73,10 @@ private:
     std::mutex m_mutex;
     std::condition_variable m_cv;
     std::unordered_map<VoxelKey, OctantInfo> m_completes;
-    std::queue<OctantInfo> m_queue;
-    ThreadPool m_pool;
+    std::deque<OctantInfo> m_queue;
+    std::exception_ptr m_error;
+    TaskGroup m_tasks;
+    int m_running;
     uint64_t m_totalPoints;
     Output m_output;
     //
@@ -57,7 +57,7 @@ Reprocessor::Reprocessor(CellManager& mgr, PointViewPtr srcView, Grid grid) :
     //  =>
     // log2(numPoints / MaxPointsPerNode) = 2n
 
-    m_levels = (int)std::ceil(log2((double)srcView->size() / MaxPointsPerNode) / 2);
+    m_levels = levels(srcView->size());
 
     // We're going to steal points from the leaf nodes for sampling, so unless the
     // spatial distribution is really off, this should be fine and pretty conservative.
@@ -65,6 +65,11 @@ Reprocessor::Reprocessor(CellManager& mgr, PointViewPtr srcView, Grid grid) :
     m_grid.resetLevel(m_grid.maxLevel() + m_levels);
 }
 
+int Reprocessor::levels(point_count_t numPoints)
+{
+    return (int)std::ceil(log2((double)numPoints / MaxPointsPerNode) / 2);
+}
+
 void Reprocessor::run()
 {
     // Remove the reprocessed cell from th4e map as its
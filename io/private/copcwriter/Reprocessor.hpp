@@ -50,6 +50,8 @@ class Reprocessor
 public:
     Reprocessor(CellManager& mgr, PointViewPtr srcView, Grid grid);
 
+    // Number of levels below its cell into which the points of a cell are split.
+    static int levels(point_count_t numPoints);
     void run();
 
 private:
@@ -105,6 +105,8 @@ void PipelineKernel::addSwitches(ProgramArgs& args)
     args.add("stream", "Run in stream mode.  Error if not streamable.",
         m_stream);
     args.add("nostream", "Run in standard mode.", m_noStream);
+    args.add("threads", "Number of threads used to run the pipeline",
+        m_threads, (std::size_t)1);
     args.add("metadata", "Metadata filename", m_metadataFile);
     args.add("dims", "Dimensions to be stored", m_dimNames);
 }
@@ -150,6 +152,7 @@ int PipelineKernel::execute()
     if (!m_manager.hasReader())
         throw pdal_error("Pipeline does not start with a reader.");
     m_manager.pointTable().layout()->setAllowedDims(m_dimNames);
+    m_manager.setThreads(m_threads);
     if (m_manager.execute(m_mode).m_mode == ExecMode::None)
         throw pdal_error("Couldn't run pipeline in requested execution mode.");
 
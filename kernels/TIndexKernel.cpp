@@ -34,6 +34,7 @@
 
 #include "TIndexKernel.hpp"
 
+#include <future>
 #include <memory>
 #include <vector>
 
@@ -42,6 +43,7 @@
 #include <pdal/PDALUtils.hpp>
 #include <pdal/Polygon.hpp>
 #include <pdal/StageFactory.hpp>
+#include <pdal/util/Executor.hpp>
 #include <pdal/util/FileUtils.hpp>
 #include <pdal/private/gdal/GDALUtils.hpp>
 #include <pdal/private/gdal/SpatialRef.hpp>
@@ -118,6 +120,8 @@ void TIndexKernel::addSubSwitches(ProgramArgs& args,
             "Write absolute rather than relative file paths", m_absPath);
         args.add("stdin,s", "Read filespec pattern from standard input",
             m_usestdin);
+        args.add("threads", "Number of files to read at once", m_threads,
+            (size_t)1);
     }
     else if (subcommand == "merge")
     {
@@ -158,6 +162,8 @@ void TIndexKernel::validateSwitches(ProgramArgs& args)
                 "options.");
         if (args.set("a_srs"))
             m_overrideASrs = true;
+        if (m_threads == 0)
+            throw pdal_error("Option 'threads' must be greater than 0.");
     }
 }
 
@@ -275,23 +281,71 @@ void TIndexKernel::createFile()
 
     size_t filecount(0);
     StageFactory factory(false);
-    for (auto f : m_files)
+    auto addFile = [this, &indexes, &filecount](const std::string& f,
+        bool ok, FileInfo& info)
     {
-        //ABELL - Not sure why we need to get absolute path here.
+        if (!ok)
+        {
+            m_log->get(LogLevel::Error) << "Skipping file '" << f <<
+                "': can't compute boundary." << std::endl;
+            return;
+        }
+        filecount++;
+        if (!isFileIndexed(indexes, info))
+        {
+            if (createFeature(indexes, info))
+                m_log->get(LogLevel::Info) << "Indexed file " << f <<
+                std::endl;
+            else
+                m_log->get(LogLevel::Error) << "Failed to create feature "
+                    "for file '" << f << "'" << std::endl;
+        }
+    };
+
+    //ABELL - Not sure why we need to get absolute path here.
+    for (auto& f : m_files)
         f = FileUtils::toAbsolutePath(f);
-        FileInfo info;
-        if (getFileInfo(factory, f, info))
+
+    if (m_threads == 1)
+    {
+        for (auto& f : m_files)
         {
-            filecount++;
-            if (!isFileIndexed(indexes, info))
+            FileInfo info;
+            bool ok = getFileInfo(factory, f, info);
+            addFile(f, ok, info);
+        }
+    }
+    else
+    {
+        // File information is gathered on up to 'threads' workers.  The
+        // features are written here, in file order, as the information
+        // becomes available.
+        std::vector<FileInfo> infos(m_files.size());
+        std::vector<std::promise<bool>> results(m_files.size());
+        std::vector<std::future<bool>> futures;
+        for (auto& r : results)
+            futures.push_back(r.get_future());
+
+        TaskGroup group(m_threads);
+        for (size_t i = 0; i < m_files.size(); ++i)
+            group.add([this, &factory, &infos, &results, i]()
             {
-                if (createFeature(indexes, info))
-                    m_log->get(LogLevel::Info) << "Indexed file " << f <<
-                    std::endl;
-                else
-                    m_log->get(LogLevel::Error) << "Failed to create feature "
-                        "for file '" << f << "'" << std::endl;
-            }
+                try
+                {
+                    results[i].set_value(
+                        getFileInfo(factory, m_files[i], infos[i]));
+                }
+                catch (...)
+                {
+                    results[i].set_exception(std::current_exception());
+                }
+            });
+
+        for (size_t i = 0; i < m_files.size(); ++i)
+        {
+            bool ok = futures[i].get();
+            addFile(m_files[i], ok, infos[i]);
+            infos[i] = FileInfo();
         }
     }
     if (!filecount)
@@ -519,11 +573,7 @@ bool TIndexKernel::getFileInfo(StageFactory& factory,
         fast = true;
     }
     if (fast && !fastBoundary(reader, fileInfo))
-    {
-        m_log->get(LogLevel::Error) << "Skipping file '" << filename <<
-            "': can't compute boundary." << std::endl;
         return false;
-    }
     FileUtils::fileTimes(filename, &fileInfo.m_ctime, &fileInfo.m_mtime);
     fileInfo.m_filename = filename;
 
@@ -112,6 +112,7 @@ private:
     std::string m_tgtSrsString;
     std::string m_assignSrsString;
     bool m_fastBoundary;
+    size_t m_threads;
     bool m_usestdin;
     bool m_overrideASrs;
 };
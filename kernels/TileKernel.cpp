@@ -34,6 +34,14 @@
 
 #include "TileKernel.hpp"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include <pdal/StageFactory.hpp>
 #include <pdal/StageWrapper.hpp>
 #include <pdal/Writer.hpp>
@@ -42,6 +50,82 @@
 namespace pdal
 {
 
+namespace
+{
+
+// A stream table with a copy of the layout of another table, so that
+// stages prepared with the other table can run with it.  Used to read
+// several files at once with the readers prepared with the kernel's table.
+class LayoutCopyTable : public StreamPointTable
+{
+public:
+    LayoutCopyTable(const PointLayout& layout, point_count_t capacity) :
+        StreamPointTable(m_layout, capacity), m_layout(layout)
+    {
+        m_buf.resize(pointsToBytes(capacity + 1));
+    }
+
+protected:
+    virtual void reset()
+        { std::fill(m_buf.begin(), m_buf.end(), 0); }
+
+    virtual char *getPoint(PointId idx)
+        { return m_buf.data() + pointsToBytes(idx); }
+
+private:
+    std::vector<char> m_buf;
+    PointLayout m_layout;
+};
+
+} // unnamed namespace
+
+
+// Points read by a worker, packed, and the tiles to which they're added.
+struct TileKernel::Batch
+{
+    struct Add
+    {
+        PointId m_idx;
+        Coord m_loc;
+    };
+
+    std::vector<char> m_points;
+    std::vector<Add> m_adds;
+    SpatialReference m_srs;
+};
+
+
+// State shared by the workers reading files and the thread passing their
+// points to the writers.
+struct TileKernel::Shared
+{
+    Shared(size_t numFiles) : m_first(numFiles, Unknown), m_firstX(numFiles),
+        m_firstY(numFiles), m_haveOrigin(false), m_running(numFiles),
+        m_abort(false)
+    {}
+
+    enum FirstPoint
+    {
+        Unknown,
+        Empty,
+        Found
+    };
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    // First point of each file, used to set the default origin.
+    std::vector<FirstPoint> m_first;
+    std::vector<double> m_firstX;
+    std::vector<double> m_firstY;
+    bool m_haveOrigin;
+    std::deque<Batch> m_batches;
+    size_t m_maxBatches;
+    size_t m_running;
+    std::vector<Streamable *> m_freeRepros;
+    bool m_abort;
+    std::exception_ptr m_error;
+};
+
 static StaticPluginInfo const s_info
 {
     "kernels.tile",
@@ -51,7 +135,8 @@ static StaticPluginInfo const s_info
 
 CREATE_STATIC_KERNEL(TileKernel, s_info)
 
-TileKernel::TileKernel() : m_table(10000), m_repro(nullptr)
+TileKernel::TileKernel() : m_numWriters(0), m_threads(1), m_table(10000),
+    m_repro(nullptr)
 {}
 
 
@@ -75,6 +160,11 @@ void TileKernel::addSwitches(ProgramArgs& args)
         m_buffer);
     args.add("out_srs", "Output SRS to which points will be reprojected",
         m_outSrs);
+    args.add("max_writers", "Maximum number of tile writers open at once. "
+        "Points of other tiles are spilled to temporary files and written "
+        "at the end", m_maxWriters, point_count_t(256));
+    args.add("threads", "Number of threads used to read input files",
+        m_threads, (size_t)1);
 }
 
 
@@ -84,6 +174,10 @@ void TileKernel::validateSwitches(ProgramArgs& args)
     if (m_hashPos == std::string::npos)
         throw pdal_error("Output filename must contain a single '#' "
             "template placeholder.");
+    if (m_maxWriters == 0)
+        throw pdal_error("Option 'max_writers' must be greater than 0.");
+    if (m_threads == 0)
+        throw pdal_error("Option 'threads' must be greater than 0.");
 }
 
 
@@ -98,8 +192,27 @@ int TileKernel::execute()
     for (auto&& file : files)
         readers[file] = prepareReader(file);
     checkReaders(readers);
+    if (m_threads > readers.size())
+        m_threads = readers.size();
     if (m_repro)
+    {
         m_repro->prepare(m_table);
+
+        // Each worker reading files in parallel needs its own filter.
+        if (m_threads > 1)
+        {
+            m_repros.push_back(m_repro);
+            for (size_t i = 1; i < m_threads; ++i)
+            {
+                Options opts;
+                opts.add("out_srs", m_outSrs);
+                Streamable *repro = dynamic_cast<Streamable *>(
+                    &m_manager.makeFilter("filters.reprojection", opts));
+                repro->prepare(m_table);
+                m_repros.push_back(repro);
+            }
+        }
+    }
     Options opts;
     opts.add("length", m_length);
     opts.add("buffer", m_buffer);
@@ -107,10 +220,17 @@ int TileKernel::execute()
     m_splitter.prepare(m_table);
 
     m_table.finalize();
-    process(readers);
+    m_dimTypes = m_table.layout()->dimTypes();
+    m_spillBuf.resize(m_table.layout()->pointSize());
+    if (m_threads > 1)
+        processParallel(readers);
+    else
+        process(readers);
     StageWrapper::done(m_splitter, m_table);
-    for (auto&& wp : m_writers)
-        StageWrapper::done(*wp.second, m_table);
+    for (auto&& tp : m_tiles)
+        if (tp.second.m_writer)
+            StageWrapper::done(*tp.second.m_writer, m_table);
+    writeSpills();
     return 0;
 }
 
@@ -284,38 +404,372 @@ void TileKernel::process(const Readers& readers)
 }
 
 
+// Read files on up to 'threads' workers.  Each worker splits its points
+// into tiles and queues them in batches.  The calling thread passes the
+// queued points to the tile writers, so writing isn't done concurrently.
+//
+// The workers are threads of their own rather than tasks of the executor.
+// A worker blocks while it waits for the origin or for room in the queue,
+// and readers may wait on the executor themselves, which would run another
+// file's worker nested on the stack of the blocked one.
+void TileKernel::processParallel(const Readers& readers)
+{
+    Shared shared(readers.size());
+    shared.m_maxBatches = 2 * m_threads;
+    shared.m_freeRepros = m_repros;
+    if (!std::isnan(m_xOrigin) && !std::isnan(m_yOrigin))
+    {
+        m_splitter.setOrigin(m_xOrigin, m_yOrigin);
+        shared.m_haveOrigin = true;
+    }
+
+    std::vector<Streamable *> files;
+    for (auto&& rp : readers)
+        files.push_back(rp.second);
+
+    // Files are started in order, which the workers rely on when waiting
+    // for the origin.  'next' is protected by the shared mutex.
+    size_t next = 0;
+    auto work = [this, &files, &next, &shared]()
+    {
+        while (true)
+        {
+            size_t index;
+            bool abort;
+            {
+                std::lock_guard<std::mutex> lock(shared.m_mutex);
+                if (next == files.size())
+                    break;
+                index = next++;
+                abort = shared.m_abort;
+            }
+
+            try
+            {
+                if (!abort)
+                    readFile(*files[index], index, shared);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(shared.m_mutex);
+                if (!shared.m_error)
+                    shared.m_error = std::current_exception();
+                shared.m_abort = true;
+            }
+            std::lock_guard<std::mutex> lock(shared.m_mutex);
+            shared.m_running--;
+            shared.m_cv.notify_all();
+        }
+    };
+
+    StageWrapper::ready(m_splitter, m_table);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < m_threads; ++i)
+        workers.emplace_back(work);
+    auto join = [&workers]()
+    {
+        for (std::thread& t : workers)
+            t.join();
+    };
+
+    PointRef point(m_table, 0);
+    const size_t pointSize = m_spillBuf.size();
+    try
+    {
+        while (true)
+        {
+            Batch batch;
+            {
+                std::unique_lock<std::mutex> lock(shared.m_mutex);
+                shared.m_cv.wait(lock, [&shared]()
+                    { return shared.m_batches.size() ||
+                        !shared.m_running || shared.m_abort; });
+                if (shared.m_abort || shared.m_batches.empty())
+                    break;
+                batch = std::move(shared.m_batches.front());
+                shared.m_batches.pop_front();
+                shared.m_cv.notify_all();
+            }
+
+            if (!batch.m_srs.empty())
+                m_table.setSpatialReference(batch.m_srs);
+            point_count_t count = batch.m_points.size() / pointSize;
+            for (PointId idx = 0; idx < count; ++idx)
+            {
+                point.setPointId(idx);
+                point.setPackedData(m_dimTypes,
+                    batch.m_points.data() + idx * pointSize);
+            }
+            for (const Batch::Add& add : batch.m_adds)
+            {
+                point.setPointId(add.m_idx);
+                adder(point, add.m_loc.first, add.m_loc.second);
+            }
+        }
+    }
+    catch (...)
+    {
+        {
+            std::lock_guard<std::mutex> lock(shared.m_mutex);
+            shared.m_abort = true;
+            shared.m_cv.notify_all();
+        }
+        join();
+        throw;
+    }
+    join();
+    if (shared.m_error)
+        std::rethrow_exception(shared.m_error);
+}
+
+
+// Read a file with a table of its own, split the points into tiles and
+// queue them for writing.  'index' is the position of the file in the list
+// of input files.
+void TileKernel::readFile(Streamable& r, size_t index, Shared& shared)
+{
+    LayoutCopyTable table(*m_table.layout(), m_table.capacity());
+    PointRef point(table, 0);
+    const size_t pointSize = m_spillBuf.size();
+
+    Streamable *repro = nullptr;
+    if (m_repros.size())
+    {
+        std::lock_guard<std::mutex> lock(shared.m_mutex);
+        repro = shared.m_freeRepros.back();
+        shared.m_freeRepros.pop_back();
+    }
+
+    StreamableWrapper::ready(r, table);
+    if (repro)
+        StreamableWrapper::spatialReferenceChanged(*repro,
+            r.getSpatialReference());
+
+    // Record the first point and wait until the origin is known.  The
+    // origin is the first point of the first file that has one.
+    bool finished = !StreamableWrapper::processOne(r, point);
+    {
+        std::unique_lock<std::mutex> lock(shared.m_mutex);
+        if (finished)
+            shared.m_first[index] = Shared::Empty;
+        else
+        {
+            shared.m_first[index] = Shared::Found;
+            shared.m_firstX[index] = point.getFieldAs<double>(Dimension::Id::X);
+            shared.m_firstY[index] = point.getFieldAs<double>(Dimension::Id::Y);
+        }
+        for (size_t i = 0; !shared.m_haveOrigin && i < shared.m_first.size();
+            ++i)
+        {
+            if (shared.m_first[i] == Shared::Unknown)
+                break;
+            if (shared.m_first[i] == Shared::Found)
+            {
+                if (std::isnan(m_xOrigin))
+                    m_xOrigin = shared.m_firstX[i];
+                if (std::isnan(m_yOrigin))
+                    m_yOrigin = shared.m_firstY[i];
+                m_splitter.setOrigin(m_xOrigin, m_yOrigin);
+                shared.m_haveOrigin = true;
+            }
+        }
+        shared.m_cv.notify_all();
+        shared.m_cv.wait(lock, [&shared, finished]()
+            { return finished || shared.m_haveOrigin || shared.m_abort; });
+        if (shared.m_abort)
+            finished = true;
+    }
+
+    PointId idx = 1;
+    while (!finished)
+    {
+        while (idx < table.capacity())
+        {
+            point.setPointId(idx);
+            finished = !StreamableWrapper::processOne(r, point);
+            if (finished)
+                break;
+            idx++;
+        }
+        PointId end = idx;
+
+        Batch batch;
+        batch.m_srs = r.getSpatialReference();
+        batch.m_points.resize(end * pointSize);
+        for (idx = 0; idx < end; ++idx)
+        {
+            point.setPointId(idx);
+            if (repro && !StreamableWrapper::processOne(*repro, point))
+                continue;
+            point.getPackedData(m_dimTypes,
+                batch.m_points.data() + idx * pointSize);
+            m_splitter.processPoint(point,
+                [&batch](PointRef& p, int xpos, int ypos)
+                { batch.m_adds.push_back({ p.pointId(), { xpos, ypos } }); });
+        }
+
+        std::unique_lock<std::mutex> lock(shared.m_mutex);
+        shared.m_cv.wait(lock, [&shared]()
+            { return shared.m_batches.size() < shared.m_maxBatches ||
+                shared.m_abort; });
+        if (shared.m_abort)
+            break;
+        shared.m_batches.push_back(std::move(batch));
+        shared.m_cv.notify_all();
+        idx = 0;
+    }
+
+    StreamableWrapper::done(r, table);
+    if (repro)
+    {
+        StreamableWrapper::done(*repro, table);
+        std::lock_guard<std::mutex> lock(shared.m_mutex);
+        shared.m_freeRepros.push_back(repro);
+    }
+}
+
+
+// Points go to the tile's writer if there is one.  Once 'max_writers'
+// writers are open, points for new tiles are spilled.
 void TileKernel::adder(PointRef& point, int xpos, int ypos)
 {
     Coord loc(xpos, ypos);
 
-    Stage *w;
-    Streamable *sw;
+    auto ti = m_tiles.find(loc);
+    if (ti == m_tiles.end())
+    {
+        Tile tile;
+        if (m_numWriters < m_maxWriters)
+        {
+            tile.m_writer = makeWriter(loc);
+            m_numWriters++;
+        }
+        ti = m_tiles.insert({ loc, tile }).first;
+    }
+
+    Tile& tile = ti->second;
+    if (tile.m_writer)
+        StreamableWrapper::processOne(*tile.m_writer, point);
+    else
+        spill(loc, tile, point);
+}
+
+
+Streamable *TileKernel::makeWriter(const Coord& loc)
+{
+    std::string filename(m_outputFile);
+    std::string xname(std::to_string(loc.first));
+    std::string yname(std::to_string(loc.second));
+    filename.replace(m_hashPos, 1, (xname + "_" + yname));
+
+    Stage *w = &m_manager.makeWriter(filename, "");
+    if (!w)
+        throw pdal_error("Couldn't create writer for output file '" +
+            m_outputFile + "'.");
+    Streamable *sw = dynamic_cast<Streamable *>(w);
+    if (!sw)
+        throw pdal_error("Driver '" + w->getName() + "' for output file '" +
+            m_outputFile + "' is not streamable.");
+
+    sw->prepare(m_table);
+    StreamableWrapper::spatialReferenceChanged(*sw, m_outSrs);
+    StreamableWrapper::ready(*sw, m_table);
+    return sw;
+}
+
 
-    auto wi = m_writers.find(loc);
-    if (wi == m_writers.end())
+// Append a point to a tile's spill file.  At most 'max_writers' spill
+// files are kept open.  The least recently used one is closed to make
+// room for another.
+void TileKernel::spill(const Coord& loc, Tile& tile, PointRef& point)
+{
+    if (!tile.m_spill)
     {
-        std::string filename(m_outputFile);
-        std::string xname(std::to_string(xpos));
-        std::string yname(std::to_string(ypos));
-        filename.replace(m_hashPos, 1, (xname + "_" + yname));
-
-        w = &m_manager.makeWriter(filename, "");
-        if (!w)
-            throw pdal_error("Couldn't create writer for output file '" +
-                m_outputFile + "'.");
-        sw = dynamic_cast<Streamable *>(w);
-        if (!sw)
-            throw pdal_error("Driver '" + w->getName() + "' for output file '" +
-                m_outputFile + "' is not streamable.");
-        m_writers[loc] = sw;
-
-        sw->prepare(m_table);
-        StreamableWrapper::spatialReferenceChanged(*sw, m_outSrs);
-        StreamableWrapper::ready(*sw, m_table);
+        if (m_openSpills.size() >= m_maxWriters)
+        {
+            Tile& lru = m_tiles[m_openSpills.back()];
+            FileUtils::closeFile(lru.m_spill);
+            lru.m_spill = nullptr;
+            m_openSpills.pop_back();
+        }
+
+        if (tile.m_spillFilename.empty())
+        {
+            tile.m_spillFilename = m_outputFile;
+            tile.m_spillFilename.replace(m_hashPos, 1,
+                std::to_string(loc.first) + "_" +
+                std::to_string(loc.second));
+            tile.m_spillFilename += ".spill";
+            tile.m_spill = FileUtils::createFile(tile.m_spillFilename);
+        }
+        else
+        {
+            tile.m_spill = FileUtils::openExisting(tile.m_spillFilename);
+            if (tile.m_spill)
+                tile.m_spill->seekp(0, std::ios::end);
+        }
+        if (!tile.m_spill)
+            throw pdal_error("Couldn't open spill file '" +
+                tile.m_spillFilename + "'.");
+        m_openSpills.push_front(loc);
+        tile.m_spillPos = m_openSpills.begin();
     }
     else
-        sw = wi->second;
-    StreamableWrapper::processOne(*sw, point);
+        m_openSpills.splice(m_openSpills.begin(), m_openSpills,
+            tile.m_spillPos);
+
+    point.getPackedData(m_dimTypes, m_spillBuf.data());
+    tile.m_spill->write(m_spillBuf.data(), m_spillBuf.size());
+    tile.m_spillCount++;
+}
+
+
+// Write the spilled tiles one at a time, reading the points back into the
+// point table.
+void TileKernel::writeSpills()
+{
+    const size_t pointSize = m_spillBuf.size();
+    std::vector<char> buf(pointSize * m_table.capacity());
+    PointRef point(m_table, 0);
+
+    for (auto&& tp : m_tiles)
+    {
+        Tile& tile = tp.second;
+        if (tile.m_spillFilename.empty())
+            continue;
+        if (tile.m_spill)
+        {
+            FileUtils::closeFile(tile.m_spill);
+            tile.m_spill = nullptr;
+        }
+
+        std::istream *in = FileUtils::openFile(tile.m_spillFilename);
+        if (!in)
+            throw pdal_error("Couldn't open spill file '" +
+                tile.m_spillFilename + "'.");
+
+        Streamable *sw = makeWriter(tp.first);
+        point_count_t remaining = tile.m_spillCount;
+        while (remaining)
+        {
+            point_count_t count = (std::min)(remaining, m_table.capacity());
+            in->read(buf.data(), count * pointSize);
+            if (!in->good())
+                throw pdal_error("Couldn't read spill file '" +
+                    tile.m_spillFilename + "'.");
+            for (PointId idx = 0; idx < count; ++idx)
+            {
+                point.setPointId(idx);
+                point.setPackedData(m_dimTypes, buf.data() + idx * pointSize);
+                StreamableWrapper::processOne(*sw, point);
+            }
+            remaining -= count;
+        }
+        StreamableWrapper::done(*sw, m_table);
+        FileUtils::closeFile(in);
+        FileUtils::deleteFile(tile.m_spillFilename);
+    }
+    m_openSpills.clear();
 }
 
 } // namespace pdal
@@ -34,6 +34,7 @@
 
 #pragma once
 
+#include <list>
 #include <map>
 
 #include <pdal/Kernel.hpp>
@@ -47,6 +48,23 @@ class PDAL_DLL TileKernel : public Kernel
     using Coord = std::pair<int, int>;
     using Readers = std::map<std::string, Streamable *>;
 
+    // Output of a tile.  Points are passed to the tile's writer if it
+    // has one.  Otherwise they are appended to a spill file that is
+    // written to the tile's output when all points have been read.
+    struct Tile
+    {
+        Tile() : m_writer(nullptr), m_spill(nullptr), m_spillCount(0)
+        {}
+
+        Streamable *m_writer;
+        std::string m_spillFilename;
+        // Open spill file, if any.
+        std::ostream *m_spill;
+        point_count_t m_spillCount;
+        // Position of the tile in the list of open spill files.
+        std::list<Coord>::iterator m_spillPos;
+    };
+
 public:
     TileKernel();
     std::string getName() const;
@@ -57,8 +75,16 @@ private:
     void validateSwitches(ProgramArgs& args);
     Streamable *prepareReader(const std::string& filename);
     void process(const Readers& readers);
+    void processParallel(const Readers& readers);
     void checkReaders(const Readers& readers);
     void adder(PointRef& point, int xpos, int ypos);
+    Streamable *makeWriter(const Coord& loc);
+    void spill(const Coord& loc, Tile& tile, PointRef& point);
+    void writeSpills();
+
+    struct Batch;
+    struct Shared;
+    void readFile(Streamable& r, size_t index, Shared& shared);
 
     std::string m_inputFile;
     std::string m_outputFile;
@@ -66,10 +92,19 @@ private:
     double m_xOrigin;
     double m_yOrigin;
     double m_buffer;
-    std::map<Coord, Streamable *> m_writers;
+    point_count_t m_maxWriters;
+    point_count_t m_numWriters;
+    size_t m_threads;
+    std::map<Coord, Tile> m_tiles;
+    // Tiles with open spill files, most recently used first.
+    std::list<Coord> m_openSpills;
+    DimTypeList m_dimTypes;
+    std::vector<char> m_spillBuf;
     FixedPointTable m_table;
     SplitterFilter m_splitter;
     Streamable *m_repro;
+    // Reprojection filter for each input file when reading in parallel.
+    std::vector<Streamable *> m_repros;
     SpatialReference m_outSrs;
     std::string::size_type m_hashPos;
 };
@@ -39,23 +39,40 @@ namespace pdal
 
 ColumnPointTable::~ColumnPointTable()
 {
-    for (DimBlockList& l : m_blocks)
-        for (auto ptr : l)
-            delete [] ptr;
+    const size_t numBlocks = m_pageBlockCnt * m_layoutRef.dims().size();
+    for (BlockPage& page : m_pages)
+        if (page)
+            for (size_t i = 0; i < numBlocks; ++i)
+                delete [] page[i];
 }
 
 
 void ColumnPointTable::finalize()
 {
     m_layoutRef.orderDimensions();
-    m_blocks.resize(m_layoutRef.dims().size());
+    if (m_pages.empty())
+        m_pages.resize(m_maxPages);
 }
 
 
 PointId ColumnPointTable::addPoint()
 {
+    std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+    if (m_concurrent)
+        lock.lock();
+
     if (m_numPts % m_blockPtCnt == 0)
     {
+        const point_count_t blockNum = m_numPts / m_blockPtCnt;
+        const point_count_t pageNum = blockNum / m_pageBlockCnt;
+        if (pageNum >= m_pages.size())
+            throw pdal_error("Point table capacity exceeded.");
+
+        BlockPage& page = m_pages[pageNum];
+        if (!page)
+            page.reset(new char *[m_pageBlockCnt *
+                m_layoutRef.dims().size()]());
+
         for (Dimension::Id id : m_layoutRef.dims())
         {
             const Dimension::Detail *detail = m_layoutRef.dimDetail(id);
@@ -64,8 +81,8 @@ PointId ColumnPointTable::addPoint()
             size_t size = m_blockPtCnt * Dimension::size(detail->type());
             char *buf = new char[size];
             memset(buf, 0, size);
-            DimBlockList& dimBlocks = m_blocks[detail->order()];
-            dimBlocks.push_back(buf);
+            page[detail->order() * m_pageBlockCnt +
+                blockNum % m_pageBlockCnt] = buf;
         }
     }
     return m_numPts++;
@@ -131,11 +148,8 @@ void ColumnPointTable::setFieldInternal(Dimension::Id dim,
     PointId idx, const void *src)
 {
     const Dimension::Detail *d = m_layoutRef.dimDetail(dim);
-    const DimBlockList& dimBlocks = m_blocks[d->order()];
-    char *buf = dimBlocks[idx / m_blockPtCnt];
-    char *dst = buf + (Dimension::size(d->type()) * (idx % m_blockPtCnt));
 
-    copy (reinterpret_cast<const char *>(src), dst, d->type());
+    copy(reinterpret_cast<const char *>(src), getDimension(d, idx), d->type());
 }
 
 
@@ -143,17 +157,15 @@ void ColumnPointTable::getFieldInternal(Dimension::Id dim,
     PointId idx, void *dst) const
 {
     const Dimension::Detail *d = m_layoutRef.dimDetail(dim);
-    const DimBlockList& dimBlocks = m_blocks[d->order()];
-    const char *buf = dimBlocks[idx / m_blockPtCnt];
-    const char *src = buf + (Dimension::size(d->type()) * (idx % m_blockPtCnt));
 
-    copy(src, reinterpret_cast<char *>(dst), d->type());
+    copy(getDimension(d, idx), reinterpret_cast<char *>(dst), d->type());
 }
 
 char *ColumnPointTable::getDimension(const Dimension::Detail *d, PointId idx)
 {
-    DimBlockList& dimBlocks = m_blocks[d->order()];
-    char *buf = dimBlocks[idx / m_blockPtCnt];
+    const point_count_t blockNum = idx / m_blockPtCnt;
+    const BlockPage& page = m_pages[blockNum / m_pageBlockCnt];
+    char *buf = page[d->order() * m_pageBlockCnt + blockNum % m_pageBlockCnt];
     return buf + (Dimension::size(d->type()) * (idx % m_blockPtCnt));
 }
 
@@ -165,5 +177,29 @@ const char *ColumnPointTable::getDimension(const Dimension::Detail *d,
     return ncThis->getDimension(d, idx);
 }
 
+
+bool ColumnPointTable::dimBlocks(const Dimension::Detail *d,
+    DimBlocks& blocks) const
+{
+    // Points may be added from other threads while the blocks are read.
+    std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+    if (m_concurrent)
+        lock.lock();
+
+    const point_count_t numBlocks =
+        (m_numPts + m_blockPtCnt - 1) / m_blockPtCnt;
+
+    blocks.m_blocks.resize(numBlocks);
+    for (point_count_t blockNum = 0; blockNum < numBlocks; ++blockNum)
+    {
+        const BlockPage& page = m_pages[blockNum / m_pageBlockCnt];
+        blocks.m_blocks[blockNum] =
+            page[d->order() * m_pageBlockCnt + blockNum % m_pageBlockCnt];
+    }
+    blocks.m_blockPtCnt = m_blockPtCnt;
+    blocks.m_stride = Dimension::size(d->type());
+    return true;
+}
+
 } // namespace pdal
 
@@ -44,6 +44,7 @@ struct Filter::Args
     Arg *m_whereArg;
     Filter::WhereMergeMode m_whereMerge;
     Arg *m_whereMergeArg;
+    std::size_t m_viewThreads;
 };
 
 Filter::Filter() : m_args(new Args)
@@ -74,6 +75,9 @@ void Filter::l_addArgs(ProgramArgs& args)
     m_args->m_whereMergeArg = &args.add("where_merge", "If 'where' option is set, describes "
         "how skipped points should be merged with kept points in standard mode.",
         m_args->m_whereMerge, WhereMergeMode::Auto);
+    args.add("view_threads", "Number of threads used to run point views "
+        "through this filter concurrently in standard mode.",
+        m_args->m_viewThreads, (std::size_t)1);
 }
 
 void Filter::l_prepared(PointTableRef table)
@@ -84,6 +88,11 @@ void Filter::l_prepared(PointTableRef table)
         throwError("Invalid 'where': " + status.what());
     if (m_args->m_whereMergeArg->set() && !m_args->m_whereArg->set())
         throwError("Can't set 'where_merge' options without also setting 'where' option.");
+    if (m_args->m_viewThreads == 0)
+        throwError("Option 'view_threads' must be greater than 0.");
+    if (m_args->m_viewThreads > 1 && !parallelViewSafe())
+        log()->get(LogLevel::Warning) << "Filter doesn't support running "
+            "point views concurrently. Ignoring 'view_threads'." << std::endl;
 }
 
 
@@ -101,5 +110,11 @@ Stage::WhereMergeMode Filter::mergeMode() const
 }
 
 
+std::size_t Filter::viewThreads() const
+{
+    return parallelViewSafe() ? m_args->m_viewThreads : 1;
+}
+
+
 } // namespace pdal
 
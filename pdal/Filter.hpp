@@ -64,6 +64,7 @@ private:
     virtual void l_prepared(PointTableRef table) final;
     virtual const expr::ConditionalExpression *whereExpr() const;
     virtual WhereMergeMode mergeMode() const;
+    virtual std::size_t viewThreads() const;
     virtual PointViewSet run(PointViewPtr view);
     virtual void filter(PointView& /*view*/)
     {}
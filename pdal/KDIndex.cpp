@@ -35,15 +35,138 @@
 #include "KDIndex.hpp"
 #include "private/KDImpl.hpp"
 
+#include <array>
+
+#include <pdal/util/Executor.hpp>
+#include <pdal/util/Utils.hpp>
+
 namespace pdal
 {
 
+namespace
+{
+
+// Run a batch of queries, splitting them among threads.  'query' appends
+// the neighbors of the query at a position in the batch to the provided
+// lists.
+template<typename QUERY>
+KDNeighbors runBatch(std::size_t numQueries, std::size_t threads, QUERY query)
+{
+    const std::size_t numParts = (threads <= 1 || numQueries < 2) ? 1 :
+        (std::min)(numQueries, threads * 4);
+
+    std::vector<KDNeighbors> parts(numParts);
+    auto runPart = [&](std::size_t part)
+    {
+        KDNeighbors& n = parts[part];
+        const std::size_t begin = numQueries * part / numParts;
+        const std::size_t end = numQueries * (part + 1) / numParts;
+
+        n.m_offsets.reserve(end - begin + 1);
+        n.m_offsets.push_back(0);
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            query(i, n.m_ids, n.m_sqrDists);
+            n.m_offsets.push_back(n.m_ids.size());
+        }
+    };
+
+    if (numParts == 1)
+    {
+        runPart(0);
+        return std::move(parts[0]);
+    }
+
+    TaskGroup group(threads);
+    for (std::size_t part = 0; part < numParts; ++part)
+        group.add([&runPart, part](){ runPart(part); });
+    group.wait();
+
+    // Join the parts.
+    std::size_t total = 0;
+    for (const KDNeighbors& n : parts)
+        total += n.m_ids.size();
+
+    KDNeighbors nbrs;
+    nbrs.m_offsets.reserve(numQueries + 1);
+    nbrs.m_ids.reserve(total);
+    nbrs.m_sqrDists.reserve(total);
+    nbrs.m_offsets.push_back(0);
+    for (KDNeighbors& n : parts)
+    {
+        const std::size_t base = nbrs.m_ids.size();
+        nbrs.m_ids.insert(nbrs.m_ids.end(), n.m_ids.begin(), n.m_ids.end());
+        nbrs.m_sqrDists.insert(nbrs.m_sqrDists.end(), n.m_sqrDists.begin(),
+            n.m_sqrDists.end());
+        for (std::size_t i = 1; i < n.m_offsets.size(); ++i)
+            nbrs.m_offsets.push_back(base + n.m_offsets[i]);
+        n = KDNeighbors();
+    }
+    return nbrs;
+}
+
+template<typename IMPL, std::size_t N, typename ID>
+KDNeighbors knnQueries(const IMPL& impl, const PointView& view,
+    const std::array<Dimension::Id, N>& dims, std::size_t numQueries, ID id,
+    point_count_t k, std::size_t threads)
+{
+    std::vector<PointColumn<double>> cols;
+    for (Dimension::Id dim : dims)
+        cols.push_back(view.column<double>(dim));
+
+    auto query = [&](std::size_t i, PointIdList& ids,
+        std::vector<double>& sqrDists)
+    {
+        const PointId idx = id(i);
+        std::array<double, N> pt;
+        for (std::size_t d = 0; d < N; ++d)
+            pt[d] = cols[d][idx];
+
+        const std::size_t pos = ids.size();
+        ids.resize(pos + k);
+        sqrDists.resize(pos + k);
+        const std::size_t found = impl.knn(pt.data(), k, ids.data() + pos,
+            sqrDists.data() + pos);
+        ids.resize(pos + found);
+        sqrDists.resize(pos + found);
+    };
+    return runBatch(numQueries, threads, query);
+}
+
+template<typename IMPL, std::size_t N, typename ID>
+KDNeighbors radiusQueries(const IMPL& impl, const PointView& view,
+    const std::array<Dimension::Id, N>& dims, std::size_t numQueries, ID id,
+    double r, std::size_t threads)
+{
+    std::vector<PointColumn<double>> cols;
+    for (Dimension::Id dim : dims)
+        cols.push_back(view.column<double>(dim));
+
+    auto query = [&](std::size_t i, PointIdList& ids,
+        std::vector<double>& sqrDists)
+    {
+        const PointId idx = id(i);
+        std::array<double, N> pt;
+        for (std::size_t d = 0; d < N; ++d)
+            pt[d] = cols[d][idx];
+        impl.radius(pt.data(), r, ids, sqrDists);
+    };
+    return runBatch(numQueries, threads, query);
+}
+
+const std::array<Dimension::Id, 2> Dims2 { Dimension::Id::X,
+    Dimension::Id::Y };
+const std::array<Dimension::Id, 3> Dims3 { Dimension::Id::X,
+    Dimension::Id::Y, Dimension::Id::Z };
+
+} // unnamed namespace
+
 //
 // KD2Index
 //
 
-KD2Index::KD2Index(const PointView& buf) :
-    m_buf(buf), m_impl(new KD2Impl(m_buf))
+KD2Index::KD2Index(const PointView& buf, KDStorage storage) :
+    m_buf(buf), m_impl(new KD2Impl(m_buf, storage))
 {
     if (!m_buf.hasDim(Dimension::Id::X))
         throw pdal_error("KD2Index: point view missing 'X' dimension.");
@@ -56,7 +179,12 @@ KD2Index::~KD2Index()
 
 void KD2Index::build()
 {
-    m_impl->build();
+    m_impl->build(1);
+}
+
+void KD2Index::build(std::size_t threads)
+{
+    m_impl->build(threads);
 }
 
 PointId KD2Index::neighbor(double x, double y) const
@@ -145,12 +273,40 @@ PointIdList KD2Index::radius(PointRef &point, double const& r) const
     return radius(x, y, r);
 }
 
+KDNeighbors KD2Index::knnBatch(PointId first, point_count_t count,
+    point_count_t k, std::size_t threads) const
+{
+    return knnQueries(*m_impl, m_buf, Dims2, count,
+        [first](std::size_t i){ return first + i; }, k, threads);
+}
+
+KDNeighbors KD2Index::knnBatch(const PointIdList& ids, point_count_t k,
+    std::size_t threads) const
+{
+    return knnQueries(*m_impl, m_buf, Dims2, ids.size(),
+        [&ids](std::size_t i){ return ids[i]; }, k, threads);
+}
+
+KDNeighbors KD2Index::radiusBatch(PointId first, point_count_t count,
+    double r, std::size_t threads) const
+{
+    return radiusQueries(*m_impl, m_buf, Dims2, count,
+        [first](std::size_t i){ return first + i; }, r, threads);
+}
+
+KDNeighbors KD2Index::radiusBatch(const PointIdList& ids, double r,
+    std::size_t threads) const
+{
+    return radiusQueries(*m_impl, m_buf, Dims2, ids.size(),
+        [&ids](std::size_t i){ return ids[i]; }, r, threads);
+}
+
 //
 // KD3Index
 //
 
-KD3Index::KD3Index(const PointView& buf) :
-    m_buf(buf), m_impl(new KD3Impl(m_buf))
+KD3Index::KD3Index(const PointView& buf, KDStorage storage) :
+    m_buf(buf), m_impl(new KD3Impl(m_buf, storage))
 {
     if (!m_buf.hasDim(Dimension::Id::X))
         throw pdal_error("KD3Index: point view missing 'X' dimension.");
@@ -165,7 +321,12 @@ KD3Index::~KD3Index()
 
 void KD3Index::build()
 {
-    m_impl->build();
+    m_impl->build(1);
+}
+
+void KD3Index::build(std::size_t threads)
+{
+    m_impl->build(threads);
 }
 
 PointId KD3Index::neighbor(double x, double y, double z) const
@@ -261,12 +422,41 @@ PointIdList KD3Index::radius(PointRef &point, double r) const
     return radius(x, y, z, r);
 }
 
+KDNeighbors KD3Index::knnBatch(PointId first, point_count_t count,
+    point_count_t k, std::size_t threads) const
+{
+    return knnQueries(*m_impl, m_buf, Dims3, count,
+        [first](std::size_t i){ return first + i; }, k, threads);
+}
+
+KDNeighbors KD3Index::knnBatch(const PointIdList& ids, point_count_t k,
+    std::size_t threads) const
+{
+    return knnQueries(*m_impl, m_buf, Dims3, ids.size(),
+        [&ids](std::size_t i){ return ids[i]; }, k, threads);
+}
+
+KDNeighbors KD3Index::radiusBatch(PointId first, point_count_t count,
+    double r, std::size_t threads) const
+{
+    return radiusQueries(*m_impl, m_buf, Dims3, count,
+        [first](std::size_t i){ return first + i; }, r, threads);
+}
+
+KDNeighbors KD3Index::radiusBatch(const PointIdList& ids, double r,
+    std::size_t threads) const
+{
+    return radiusQueries(*m_impl, m_buf, Dims3, ids.size(),
+        [&ids](std::size_t i){ return ids[i]; }, r, threads);
+}
+
 //
 // KDFlexIndex
 //
 
-KDFlexIndex::KDFlexIndex(const PointView& buf, const Dimension::IdList& dims) :
-    m_buf(buf), m_dims(dims), m_impl(new KDFlexImpl(m_buf, m_dims))
+KDFlexIndex::KDFlexIndex(const PointView& buf, const Dimension::IdList& dims,
+        KDStorage storage) :
+    m_buf(buf), m_dims(dims), m_impl(new KDFlexImpl(m_buf, m_dims, storage))
 {}
 
 KDFlexIndex::~KDFlexIndex()
@@ -274,7 +464,12 @@ KDFlexIndex::~KDFlexIndex()
 
 void KDFlexIndex::build()
 {
-    m_impl->build();
+    m_impl->build(1);
+}
+
+void KDFlexIndex::build(std::size_t threads)
+{
+    m_impl->build(threads);
 }
 
 PointId KDFlexIndex::neighbor(PointRef &point) const
@@ -293,4 +488,39 @@ PointIdList KDFlexIndex::radius(PointId idx, double r) const
     return m_impl->radius(idx, r);
 }
 
+std::istream& operator>>(std::istream& in, KDStorage& storage)
+{
+    std::string s;
+    in >> s;
+
+    s = Utils::tolower(s);
+    if (s == "view")
+        storage = KDStorage::View;
+    else if (s == "double")
+        storage = KDStorage::Double;
+    else if (s == "float")
+        storage = KDStorage::Float;
+    else
+        in.setstate(std::ios_base::failbit);
+    return in;
+}
+
+std::ostream& operator<<(std::ostream& out, const KDStorage& storage)
+{
+    switch (storage)
+    {
+    case KDStorage::View:
+        out << "view";
+        break;
+    case KDStorage::Double:
+        out << "double";
+        break;
+    case KDStorage::Float:
+        out << "float";
+        break;
+    }
+
+    return out;
+}
+
 } // namespace pdal
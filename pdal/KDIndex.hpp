@@ -43,13 +43,59 @@ class KD2Impl;
 class KD3Impl;
 class KDFlexImpl;
 
+/// Storage of the coordinates searched by a KD index.
+enum class KDStorage
+{
+    /// Coordinates are read from the point view as needed.
+    View,
+    /// Coordinates are copied to contiguous arrays, in the order of the
+    /// leaves of the tree, when the index is built.
+    Double,
+    /// As Double, but coordinates are stored as single-precision values
+    /// relative to the minimum of each dimension, halving the memory used.
+    /// Distances are computed with single precision.
+    Float
+};
+
+PDAL_DLL std::istream& operator>>(std::istream& in, KDStorage& storage);
+PDAL_DLL std::ostream& operator<<(std::ostream& out, const KDStorage& storage);
+
+/// Number of query points that filters pass to a batched KD index query
+/// at once, limiting the memory used by the results.
+const point_count_t KDQueryBatchSize = 1 << 18;
+
+/// Neighbors of a batch of query points in compressed sparse row form.
+/// The neighbors of query 'i' are found at positions m_offsets[i] through
+/// m_offsets[i + 1] - 1 of m_ids and m_sqrDists, ordered by increasing
+/// distance.
+struct KDNeighbors
+{
+    std::vector<std::size_t> m_offsets;
+    PointIdList m_ids;
+    std::vector<double> m_sqrDists;
+
+    /// Number of query points.
+    std::size_t size() const
+        { return m_offsets.empty() ? 0 : m_offsets.size() - 1; }
+    /// Number of neighbors of a query point.
+    std::size_t count(std::size_t i) const
+        { return m_offsets[i + 1] - m_offsets[i]; }
+    /// Neighbors of a query point.
+    const PointId *ids(std::size_t i) const
+        { return m_ids.data() + m_offsets[i]; }
+    /// Square distances to the neighbors of a query point.
+    const double *sqrDists(std::size_t i) const
+        { return m_sqrDists.data() + m_offsets[i]; }
+};
+
 class PDAL_DLL KD2Index
 {
 public:
-    KD2Index(const PointView& buf);
+    KD2Index(const PointView& buf, KDStorage storage = KDStorage::View);
     ~KD2Index();
 
     void build();
+    void build(std::size_t threads);
     PointId neighbor(double x, double y) const;
     PointId neighbor(PointId idx) const;
     PointId neighbor(PointRef &point) const;
@@ -67,6 +113,28 @@ public:
     PointIdList radius(PointId idx, double const& r) const;
     PointIdList radius(PointRef &point, double const& r) const;
 
+    /// Find the k nearest neighbors of a range of points of the view.
+    /// \param first  ID of the first query point.
+    /// \param count  Number of query points.
+    /// \param k  Number of neighbors to find.
+    /// \param threads  Number of threads used to run the queries.
+    /// \return  Neighbors of each query point.
+    KDNeighbors knnBatch(PointId first, point_count_t count, point_count_t k,
+        std::size_t threads = 1) const;
+    KDNeighbors knnBatch(const PointIdList& ids, point_count_t k,
+        std::size_t threads = 1) const;
+
+    /// Find the neighbors within a radius of a range of points of the view.
+    /// \param first  ID of the first query point.
+    /// \param count  Number of query points.
+    /// \param r  Search radius.
+    /// \param threads  Number of threads used to run the queries.
+    /// \return  Neighbors of each query point.
+    KDNeighbors radiusBatch(PointId first, point_count_t count, double r,
+        std::size_t threads = 1) const;
+    KDNeighbors radiusBatch(const PointIdList& ids, double r,
+        std::size_t threads = 1) const;
+
 private:
     const PointView& m_buf;
     std::unique_ptr<KD2Impl> m_impl;
@@ -75,10 +143,11 @@ private:
 class PDAL_DLL KD3Index
 {
 public:
-    KD3Index(const PointView& buf);
+    KD3Index(const PointView& buf, KDStorage storage = KDStorage::View);
     ~KD3Index();
 
     void build();
+    void build(std::size_t threads);
     PointId neighbor(double x, double y, double z) const;
     PointId neighbor(PointId idx) const;
     PointId neighbor(PointRef &point) const;
@@ -98,6 +167,28 @@ public:
     PointIdList radius(PointId idx, double r) const;
     PointIdList radius(PointRef &point, double r) const;
 
+    /// Find the k nearest neighbors of a range of points of the view.
+    /// \param first  ID of the first query point.
+    /// \param count  Number of query points.
+    /// \param k  Number of neighbors to find.
+    /// \param threads  Number of threads used to run the queries.
+    /// \return  Neighbors of each query point.
+    KDNeighbors knnBatch(PointId first, point_count_t count, point_count_t k,
+        std::size_t threads = 1) const;
+    KDNeighbors knnBatch(const PointIdList& ids, point_count_t k,
+        std::size_t threads = 1) const;
+
+    /// Find the neighbors within a radius of a range of points of the view.
+    /// \param first  ID of the first query point.
+    /// \param count  Number of query points.
+    /// \param r  Search radius.
+    /// \param threads  Number of threads used to run the queries.
+    /// \return  Neighbors of each query point.
+    KDNeighbors radiusBatch(PointId first, point_count_t count, double r,
+        std::size_t threads = 1) const;
+    KDNeighbors radiusBatch(const PointIdList& ids, double r,
+        std::size_t threads = 1) const;
+
 private:
     const PointView& m_buf;
     std::unique_ptr<KD3Impl> m_impl;
@@ -106,10 +197,12 @@ private:
 class KDFlexIndex
 {
 public:
-    KDFlexIndex(const PointView& buf, const Dimension::IdList& dims);
+    KDFlexIndex(const PointView& buf, const Dimension::IdList& dims,
+        KDStorage storage = KDStorage::View);
     ~KDFlexIndex();
 
     void build();
+    void build(std::size_t threads);
     PointId neighbor(PointRef &point) const;
     PointIdList neighbors(PointRef &point, point_count_t k, size_t stride = 1) const;
     PointIdList radius(PointId idx, double r) const;
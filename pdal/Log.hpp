@@ -36,6 +36,7 @@
 
 #include <cassert>
 #include <memory> // shared_ptr
+#include <mutex>
 #include <stack>
 #include <chrono>
 
@@ -107,16 +108,23 @@ public:
     /// Push the leader string onto the stack.
     /// \param  leader  Leader string
     void pushLeader(const std::string& leader)
-        { m_leaders.push(leader); }
+    {
+        std::lock_guard<std::mutex> lock(m_leaderMutex);
+        m_leaders.push(leader);
+    }
 
     /// Get the leader string.
     /// \return  The current leader string.
     std::string leader() const
-        { return m_leaders.empty() ? std::string() : m_leaders.top(); }
+    {
+        std::lock_guard<std::mutex> lock(m_leaderMutex);
+        return m_leaders.empty() ? std::string() : m_leaders.top();
+    }
 
     /// Pop the current leader string.
     void popLeader()
     {
+        std::lock_guard<std::mutex> lock(m_leaderMutex);
         if (!m_leaders.empty())
             m_leaders.pop();
     }
@@ -156,6 +164,8 @@ private:
     LogLevel m_level;
     bool m_deleteStreamOnCleanup;
     std::stack<std::string> m_leaders;
+    // Stages running on different threads may share a log.
+    mutable std::mutex m_leaderMutex;
     NullOStream m_nullStream;
     bool m_timing;
     std::chrono::steady_clock m_clock;
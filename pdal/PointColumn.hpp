@@ -0,0 +1,244 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstring>
+
+#include <pdal/PointView.hpp>
+#include <pdal/util/Utils.hpp>
+
+namespace pdal
+{
+
+/// Accessor for the values of a dimension of a point view, converted to
+/// type T.  When the view's table stores points in memory blocks, values
+/// are read directly from memory, skipping the per-value type switch and
+/// virtual calls of PointView::getFieldAs().  Obtain through
+/// PointView::column().
+template<typename T>
+class PointColumn
+{
+    friend class PointView;
+
+public:
+    /// Number of values (points in the view).
+    point_count_t size() const
+        { return m_size; }
+
+    /// Whether values are read directly from table memory.
+    bool direct() const
+        { return m_convert != nullptr; }
+
+    /// Fetch the value for a point.
+    /// \param idx  Index of the point in the view.
+    T operator[](PointId idx) const
+    {
+        if (!m_convert)
+            return m_view->getFieldAs<T>(m_dim, idx);
+        PointId rawIdx = m_identity ? idx : (*m_index)[idx];
+        return m_convert(m_blocks[rawIdx >> m_shift] +
+            (rawIdx & m_mask) * m_stride);
+    }
+
+    /// Fetch the values for a range of points.  The dimension's type is
+    /// resolved once for the range rather than once per value.
+    /// \param begin  Index of the first point in the view.
+    /// \param count  Number of points.
+    /// \param vals  Filled with the values.
+    void get(PointId begin, point_count_t count, T *vals) const
+    {
+        switch (m_convert ? m_type : Dimension::Type::None)
+        {
+        case Dimension::Type::Unsigned8:
+            getAs<uint8_t>(begin, count, vals);
+            break;
+        case Dimension::Type::Unsigned16:
+            getAs<uint16_t>(begin, count, vals);
+            break;
+        case Dimension::Type::Unsigned32:
+            getAs<uint32_t>(begin, count, vals);
+            break;
+        case Dimension::Type::Unsigned64:
+            getAs<uint64_t>(begin, count, vals);
+            break;
+        case Dimension::Type::Signed8:
+            getAs<int8_t>(begin, count, vals);
+            break;
+        case Dimension::Type::Signed16:
+            getAs<int16_t>(begin, count, vals);
+            break;
+        case Dimension::Type::Signed32:
+            getAs<int32_t>(begin, count, vals);
+            break;
+        case Dimension::Type::Signed64:
+            getAs<int64_t>(begin, count, vals);
+            break;
+        case Dimension::Type::Float:
+            getAs<float>(begin, count, vals);
+            break;
+        case Dimension::Type::Double:
+            getAs<double>(begin, count, vals);
+            break;
+        case Dimension::Type::None:
+            for (point_count_t i = 0; i < count; ++i)
+                vals[i] = m_view->getFieldAs<T>(m_dim, begin + i);
+            break;
+        }
+    }
+
+private:
+    using Converter = T (*)(const char *);
+
+    PointColumn(const PointView& view, Dimension::Id dim) :
+        m_view(&view), m_dim(dim), m_size(view.size()), m_convert(nullptr),
+        m_type(Dimension::Type::None), m_identity(false), m_index(nullptr),
+        m_shift(0), m_mask(0), m_stride(0)
+    {}
+
+    void setBlocks(const DimBlocks& blocks, Dimension::Type type,
+        const std::deque<PointId>& index, bool identity)
+    {
+        switch (type)
+        {
+        case Dimension::Type::Unsigned8:
+            m_convert = convert<uint8_t>;
+            break;
+        case Dimension::Type::Unsigned16:
+            m_convert = convert<uint16_t>;
+            break;
+        case Dimension::Type::Unsigned32:
+            m_convert = convert<uint32_t>;
+            break;
+        case Dimension::Type::Unsigned64:
+            m_convert = convert<uint64_t>;
+            break;
+        case Dimension::Type::Signed8:
+            m_convert = convert<int8_t>;
+            break;
+        case Dimension::Type::Signed16:
+            m_convert = convert<int16_t>;
+            break;
+        case Dimension::Type::Signed32:
+            m_convert = convert<int32_t>;
+            break;
+        case Dimension::Type::Signed64:
+            m_convert = convert<int64_t>;
+            break;
+        case Dimension::Type::Float:
+            m_convert = convert<float>;
+            break;
+        case Dimension::Type::Double:
+            m_convert = convert<double>;
+            break;
+        case Dimension::Type::None:
+            return;
+        }
+
+        // Block point counts are powers of two.
+        m_type = type;
+        m_blocks = blocks.m_blocks;
+        m_shift = 0;
+        while (((point_count_t)1 << m_shift) < blocks.m_blockPtCnt)
+            m_shift++;
+        m_mask = blocks.m_blockPtCnt - 1;
+        m_stride = blocks.m_stride;
+        m_index = &index;
+        m_identity = identity;
+    }
+
+    template<typename S>
+    static T convert(const char *pos)
+    {
+        S s;
+        T t;
+
+        std::memcpy(&s, pos, sizeof(S));
+        if (!Utils::numericCast(s, t))
+            throw pdal_error("Unable to fetch data and convert as "
+                "requested: " + Utils::typeidName<S>() + " -> " +
+                Utils::typeidName<T>());
+        return t;
+    }
+
+    template<typename S>
+    void getAs(PointId begin, point_count_t count, T *vals) const
+    {
+        for (point_count_t i = 0; i < count; ++i)
+        {
+            PointId rawIdx = m_identity ? begin + i : (*m_index)[begin + i];
+            vals[i] = convert<S>(m_blocks[rawIdx >> m_shift] +
+                (rawIdx & m_mask) * m_stride);
+        }
+    }
+
+    const PointView *m_view;
+    Dimension::Id m_dim;
+    point_count_t m_size;
+    Converter m_convert;
+    Dimension::Type m_type;
+    bool m_identity;
+    const std::deque<PointId> *m_index;
+    std::vector<const char *> m_blocks;
+    int m_shift;
+    point_count_t m_mask;
+    std::size_t m_stride;
+};
+
+
+template<typename T>
+PointColumn<T> PointView::column(Dimension::Id dim) const
+{
+    PointColumn<T> col(*this, dim);
+
+    const Dimension::Detail *dd = m_layout->dimDetail(dim);
+    DimBlocks blocks;
+    if (dd->type() != Dimension::Type::None &&
+        m_pointTable.dimBlocks(dd, blocks))
+    {
+        // Views that hold all the points of a table in order don't need
+        // to go through the index.
+        bool identity = true;
+        for (PointId i = 0; i < m_size; ++i)
+            if (m_index[i] != i)
+            {
+                identity = false;
+                break;
+            }
+        col.setBlocks(blocks, dd->type(), m_index, identity);
+    }
+    return col;
+}
+
+} // namespace pdal
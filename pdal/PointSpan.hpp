@@ -0,0 +1,241 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#include <pdal/PointTable.hpp>
+#include <pdal/util/Utils.hpp>
+
+namespace pdal
+{
+
+/// A set of selected points of a stream table that are processed together
+/// by a stage (see Streamable::processBatch).  Field access is done a column
+/// at a time so that the dimension's type is resolved once for the whole
+/// set rather than once per point.
+class PDAL_DLL PointSpan
+{
+public:
+    PointSpan(StreamPointTable& table, const PointId *ids,
+            point_count_t size) :
+        m_table(table), m_ids(ids), m_size(size)
+    {}
+
+    /// Table holding the points.
+    StreamPointTable& table() const
+        { return m_table; }
+
+    /// Number of points in the span.
+    point_count_t size() const
+        { return m_size; }
+
+    /// Fetch the table ID of a point in the span.
+    /// \param i  Position of the point in the span.
+    PointId id(point_count_t i) const
+        { return m_ids[i]; }
+
+    /// Mark a point as filtered out.  It won't be passed to subsequent
+    /// stages.
+    /// \param i  Position of the point in the span.
+    void skip(point_count_t i)
+        { m_table.setSkip(m_ids[i]); }
+
+    /// Determine if a point has been filtered out.
+    /// \param i  Position of the point in the span.
+    bool skipped(point_count_t i) const
+        { return m_table.skip(m_ids[i]); }
+
+    /**
+      Fetch the values of a dimension for all points in the span, converted
+      to the requested type.  Throws pdal_error if a value can't be
+      converted, as does PointRef::getFieldAs().
+
+      \param dim  Dimension to fetch.
+      \param vals  Filled with the values.  Resized to the span size.
+    */
+    template<typename T>
+    void getField(Dimension::Id dim, std::vector<T>& vals) const
+    {
+        vals.resize(m_size);
+        getField(dim, vals.data());
+    }
+
+    template<typename T>
+    void getField(Dimension::Id dim, T *vals) const;
+
+    /**
+      Set the values of a dimension for all points in the span.  Values
+      that can't be converted to the dimension's type are ignored, as with
+      PointRef::setField().
+
+      \param dim  Dimension to set.
+      \param vals  Values to set, one per point in the span.
+    */
+    template<typename T>
+    void setField(Dimension::Id dim, const std::vector<T>& vals)
+        { setField(dim, vals.data()); }
+
+    template<typename T>
+    void setField(Dimension::Id dim, const T *vals);
+
+private:
+    template<typename S, typename T>
+    void getAs(const Dimension::Detail *d, T *vals) const
+    {
+        for (point_count_t i = 0; i < m_size; ++i)
+        {
+            S s;
+            std::memcpy(&s, m_table.getPoint(m_ids[i]) + d->offset(),
+                sizeof(S));
+            if (!Utils::numericCast(s, vals[i]))
+            {
+                std::ostringstream oss;
+                oss << "Unable to fetch data and convert as requested: ";
+                oss << Dimension::name(d->id()) << ":" <<
+                    Dimension::interpretationName(d->type()) <<
+                    "(" << (double)s << ") -> " << Utils::typeidName<T>();
+                throw pdal_error(oss.str());
+            }
+        }
+    }
+
+    template<typename S, typename T>
+    void setAs(const Dimension::Detail *d, const T *vals)
+    {
+        for (point_count_t i = 0; i < m_size; ++i)
+        {
+            S s;
+            if (Utils::numericCast(vals[i], s))
+                std::memcpy(m_table.getPoint(m_ids[i]) + d->offset(), &s,
+                    sizeof(S));
+        }
+    }
+
+    StreamPointTable& m_table;
+    const PointId *m_ids;
+    point_count_t m_size;
+};
+
+
+template<typename T>
+void PointSpan::getField(Dimension::Id dim, T *vals) const
+{
+    const Dimension::Detail *d = m_table.layout()->dimDetail(dim);
+
+    switch (d->type())
+    {
+    case Dimension::Type::Unsigned8:
+        getAs<uint8_t>(d, vals);
+        break;
+    case Dimension::Type::Unsigned16:
+        getAs<uint16_t>(d, vals);
+        break;
+    case Dimension::Type::Unsigned32:
+        getAs<uint32_t>(d, vals);
+        break;
+    case Dimension::Type::Unsigned64:
+        getAs<uint64_t>(d, vals);
+        break;
+    case Dimension::Type::Signed8:
+        getAs<int8_t>(d, vals);
+        break;
+    case Dimension::Type::Signed16:
+        getAs<int16_t>(d, vals);
+        break;
+    case Dimension::Type::Signed32:
+        getAs<int32_t>(d, vals);
+        break;
+    case Dimension::Type::Signed64:
+        getAs<int64_t>(d, vals);
+        break;
+    case Dimension::Type::Float:
+        getAs<float>(d, vals);
+        break;
+    case Dimension::Type::Double:
+        getAs<double>(d, vals);
+        break;
+    case Dimension::Type::None:
+        std::fill(vals, vals + m_size, T(0));
+        break;
+    }
+}
+
+
+template<typename T>
+void PointSpan::setField(Dimension::Id dim, const T *vals)
+{
+    const Dimension::Detail *d = m_table.layout()->dimDetail(dim);
+
+    switch (d->type())
+    {
+    case Dimension::Type::Unsigned8:
+        setAs<uint8_t>(d, vals);
+        break;
+    case Dimension::Type::Unsigned16:
+        setAs<uint16_t>(d, vals);
+        break;
+    case Dimension::Type::Unsigned32:
+        setAs<uint32_t>(d, vals);
+        break;
+    case Dimension::Type::Unsigned64:
+        setAs<uint64_t>(d, vals);
+        break;
+    case Dimension::Type::Signed8:
+        setAs<int8_t>(d, vals);
+        break;
+    case Dimension::Type::Signed16:
+        setAs<int16_t>(d, vals);
+        break;
+    case Dimension::Type::Signed32:
+        setAs<int32_t>(d, vals);
+        break;
+    case Dimension::Type::Signed64:
+        setAs<int64_t>(d, vals);
+        break;
+    case Dimension::Type::Float:
+        setAs<float>(d, vals);
+        break;
+    case Dimension::Type::Double:
+        setAs<double>(d, vals);
+        break;
+    case Dimension::Type::None:
+        break;
+    }
+}
+
+} // namespace pdal
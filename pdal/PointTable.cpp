@@ -125,6 +125,18 @@ char *RowPointTable::getPoint(PointId idx)
 }
 
 
+bool RowPointTable::dimBlocks(const Dimension::Detail *d,
+    DimBlocks& blocks) const
+{
+    blocks.m_blocks.clear();
+    for (const char *buf : m_blocks)
+        blocks.m_blocks.push_back(buf + d->offset());
+    blocks.m_blockPtCnt = m_blockPtCnt;
+    blocks.m_stride = m_layoutRef.pointSize();
+    return true;
+}
+
+
 MetadataNode BasePointTable::toMetadata() const
 {
     return layout()->toMetadata();
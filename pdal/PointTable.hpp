@@ -36,6 +36,8 @@
 
 #include <algorithm>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "pdal/SpatialReference.hpp"
@@ -49,6 +51,16 @@ namespace pdal
 
 class ArtifactManager;
 
+// Location of the values of a dimension in a table that stores its points
+// in fixed-size blocks.  Value 'n' is at
+// m_blocks[n / m_blockPtCnt] + (n % m_blockPtCnt) * m_stride.
+struct DimBlocks
+{
+    std::vector<const char *> m_blocks;
+    point_count_t m_blockPtCnt;
+    std::size_t m_stride;
+};
+
 class PDAL_DLL BasePointTable : public PointContainer
 {
     FRIEND_TEST(PointTable, srs);
@@ -91,6 +103,16 @@ public:
     }
     virtual bool supportsView() const
         { return false; }
+    /**
+      Enable or disable adding points to the table from more than one
+      thread at a time.  While enabled, a thread may access the points it
+      has added while other threads add points.
+
+      \param concurrent  Whether concurrent point addition should be enabled.
+      \return  Whether the table supports concurrent point addition.
+    */
+    virtual bool setConcurrent(bool /*concurrent*/)
+        { return false; }
     MetadataNode privateMetadata(const std::string& name);
     MetadataNode toMetadata() const;
     ArtifactManager& artifactManager();
@@ -99,6 +121,11 @@ private:
     // Point data operations.
     virtual PointId addPoint() = 0;
     virtual char *getDimension(const Dimension::Detail *d, PointId idx) = 0;
+    // Fill 'blocks' and return true if the values of a dimension can be
+    // accessed directly in memory blocks.
+    virtual bool dimBlocks(const Dimension::Detail * /*d*/,
+            DimBlocks& /*blocks*/) const
+        { return false; }
 
 protected:
     virtual char *getPoint(PointId idx) = 0;
@@ -154,6 +181,10 @@ private:
 public:
     RowPointTable() : SimplePointTable(m_layout), m_numPts(0)
         {}
+    // Create a table whose layout is a copy of 'layout'.
+    explicit RowPointTable(const PointLayout& layout) :
+        SimplePointTable(m_layout), m_numPts(0), m_layout(layout)
+        {}
     virtual ~RowPointTable();
     virtual bool supportsView() const
         { return true; }
@@ -164,6 +195,8 @@ protected:
 private:
     // Point data operations.
     virtual PointId addPoint();
+    virtual bool dimBlocks(const Dimension::Detail *d,
+        DimBlocks& blocks) const;
 
     PointLayout m_layout;
 };
@@ -174,23 +207,33 @@ using PointTable = RowPointTable;
 class PDAL_DLL ColumnPointTable : public SimplePointTable
 {
 private:
-    // Point storage.
-    using DimBlockList = std::vector<char *>;
-    using MemBlocks = std::vector<DimBlockList>;
+    // Point storage.  Pointers to the memory blocks of each dimension are
+    // held in pages.  The page list is sized once when the table is
+    // finalized, so existing entries never move as points are added.
+    using BlockPage = std::unique_ptr<char *[]>;
 
-    // List of dimension memory block lists.
-    MemBlocks m_blocks;
+    std::vector<BlockPage> m_pages;
     point_count_t m_numPts;
+    bool m_concurrent;
+    mutable std::mutex m_mutex;
 
-    // Make sure this is power-of-2 to facilitate fast div and mod ops.
+    // Make sure these are power-of-2 to facilitate fast div and mod ops.
     static const point_count_t m_blockPtCnt = 16384;
+    static const point_count_t m_pageBlockCnt = 1024;
+    static const point_count_t m_maxPages = 8192;
 
 public:
-    ColumnPointTable() : SimplePointTable(m_layout), m_numPts(0)
+    ColumnPointTable() : SimplePointTable(m_layout), m_numPts(0),
+        m_concurrent(false)
         {}
     virtual ~ColumnPointTable();
     virtual bool supportsView() const
         { return true; }
+    virtual bool setConcurrent(bool concurrent)
+    {
+        m_concurrent = concurrent;
+        return true;
+    }
     virtual void finalize();
     virtual char *getPoint(PointId idx)
         { return nullptr; }
@@ -202,6 +245,8 @@ private:
         void *value) const;
 
     virtual PointId addPoint();
+    virtual bool dimBlocks(const Dimension::Detail *d,
+        DimBlocks& blocks) const;
 
     // Hide base class calls for now.
     const char *getDimension(const Dimension::Detail *d, PointId idx) const;
@@ -217,12 +262,14 @@ private:
 /// finalize() method.
 class PDAL_DLL StreamPointTable : public SimplePointTable
 {
+    friend class PointSpan;
+
 protected:
     StreamPointTable(PointLayout& layout, point_count_t capacity)
         : SimplePointTable(layout)
         , m_capacity(capacity)
         , m_numPoints(0)
-        , m_skips(m_capacity, false)
+        , m_skips(m_capacity, 0)
     {}
 
 public:
@@ -243,15 +290,32 @@ public:
 
         m_numPoints = count;
         reset();
-        std::fill(m_skips.begin(), m_skips.end(), false);
+        std::fill(m_skips.begin(), m_skips.end(), 0);
+    }
+
+    /// Clear a range of points so that it can be refilled.  Only valid
+    /// for tables that support chunks.
+    void clear(PointId start, point_count_t count)
+    {
+        if (!count)
+            return;
+
+        resetRange(start, count);
+        std::fill(m_skips.begin() + start, m_skips.begin() + start + count, 0);
     }
 
+    /// Returns true if the table can be divided into ranges of points
+    /// (chunks) that are filled, processed and cleared independently of
+    /// one another, possibly from different threads.
+    virtual bool supportsChunks() const
+        { return false; }
+
     /// Returns true if a point in the table was filtered out and should be
     /// considered omitted.
     bool skip(PointId n) const
         { return m_skips[n]; }
     void setSkip(PointId n)
-        { m_skips[n] = true; }
+        { m_skips[n] = 1; }
 
     point_count_t capacity() const
         { return m_capacity; }
@@ -268,10 +332,17 @@ protected:
     virtual void reset()
     {}
 
+    /// Called in place of reset() when a chunk of the table has been
+    /// consumed.  Only called for tables that support chunks.
+    virtual void resetRange(PointId /*start*/, point_count_t /*count*/)
+    {}
+
 private:
     point_count_t m_capacity;
     point_count_t m_numPoints;
-    std::vector<bool> m_skips;
+    // One byte per point so that skips of different points can be set
+    // from different threads.
+    std::vector<char> m_skips;
 };
 
 // A concrete implementation of StreamPointTable that uses a fixed-size
@@ -292,10 +363,19 @@ public:
         }
     }
 
+    virtual bool supportsChunks() const
+        { return true; }
+
 protected:
     virtual void reset()
         { std::fill(m_buf.begin(), m_buf.end(), 0); }
 
+    virtual void resetRange(PointId start, point_count_t count)
+    {
+        std::fill(m_buf.begin() + pointsToBytes(start),
+            m_buf.begin() + pointsToBytes(start + count), 0);
+    }
+
     virtual char *getPoint(PointId idx)
         { return m_buf.data() + pointsToBytes(idx); }
 
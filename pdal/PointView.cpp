@@ -38,12 +38,13 @@
 #include <pdal/PointView.hpp>
 #include <pdal/util/Algorithm.hpp>
 
+#include "private/PointSort.hpp"
 #include "private/Raster.hpp"
 
 namespace pdal
 {
 
-int PointView::m_lastId = 0;
+std::atomic<int> PointView::m_lastId(0);
 
 PointView::PointView(PointTableRef pointTable) : m_pointTable(pointTable),
     m_layout(pointTable.layout()), m_size(0), m_id(0)
@@ -90,6 +91,32 @@ PointId PointView::tableId(PointId idx)
 }
 
 
+void PointView::stableSort(const std::vector<SortKey>& keys,
+    std::size_t threads)
+{
+    clearTemps();
+    reorder(sort::order(*this, keys, threads));
+}
+
+
+void PointView::spatialSort(SpatialCurve curve, bool is3d,
+    std::size_t threads)
+{
+    clearTemps();
+    reorder(sort::spatialOrder(*this, curve, is3d, threads));
+}
+
+
+// Overwrite the ordering index with a new order of the points.  Use a copy
+// of the index to avoid hammering over things as we are copying.
+void PointView::reorder(const std::vector<PointId>& order)
+{
+    const std::vector<PointId> old(m_index.begin(), m_index.begin() + size());
+    for (PointId i = 0; i < size(); ++i)
+        m_index[i] = old[order[i]];
+}
+
+
 void PointView::setFieldInternal(Dimension::Id dim, PointId idx,
     const void *buf)
 {
@@ -215,28 +242,40 @@ void PointView::invalidateProducts()
 
 
 KD3Index& PointView::build3dIndex()
+{
+    return build3dIndex(KDStorage::View);
+}
+
+
+KD3Index& PointView::build3dIndex(KDStorage storage, std::size_t threads)
 {
     //ABELL
     // Should we allow a force of point view build - perhaps the index has
     // changed or the point values have changed.
     if (!m_index3)
     {
-        m_index3.reset(new KD3Index(*this));
-        m_index3->build();
+        m_index3.reset(new KD3Index(*this, storage));
+        m_index3->build(threads);
     }
     return *m_index3.get();
 }
 
 
 KD2Index& PointView::build2dIndex()
+{
+    return build2dIndex(KDStorage::View);
+}
+
+
+KD2Index& PointView::build2dIndex(KDStorage storage, std::size_t threads)
 {
     //ABELL
     // Should we allow a force of point view build - perhaps the index has
     // changed or the point values have changed.
     if (!m_index2)
     {
-        m_index2.reset(new KD2Index(*this));
-        m_index2->build();
+        m_index2.reset(new KD2Index(*this, storage));
+        m_index2->build(threads);
     }
     return *m_index2.get();
 }
@@ -42,6 +42,7 @@
 #include <pdal/PointTable.hpp>
 #include <pdal/PointRef.hpp>
 
+#include <atomic>
 #include <memory>
 #include <queue>
 #include <set>
@@ -61,6 +62,8 @@ class PointView;
 class PointViewIter;
 class KD2Index;
 class KD3Index;
+template<typename T> class PointColumn;
+enum class KDStorage;
 class BOX2D;
 class BOX3D;
 
@@ -125,6 +128,16 @@ public:
     template<class T>
     T getFieldAs(Dimension::Id dim, PointId pointIndex) const;
 
+    /// Get an accessor for the values of a dimension, converted to the
+    /// requested type.  The dimension's type and location in the table are
+    /// resolved once rather than for each value fetched.  The accessor is
+    /// invalidated if points are added to or reordered in the view.
+    /// Include <pdal/PointColumn.hpp> to use.
+    /// \param dim  Dimension to access.
+    /// \return  Column accessor.
+    template<typename T>
+    PointColumn<T> column(Dimension::Id dim) const;
+
     inline void getField(char *pos, Dimension::Id d,
         Dimension::Type type, PointId id) const;
 
@@ -304,15 +317,57 @@ public:
     KD3Index& build3dIndex();
     KD2Index& build2dIndex();
 
+    /// Build the 3D/2D index of the view, if it hasn't been built, with the
+    /// provided coordinate storage.  An index that has already been built
+    /// is returned as is.
+    /// \param storage  Coordinate storage of the index.
+    /// \param threads  Number of threads used to build the index.
+    /// \return  The view's index.
+    KD3Index& build3dIndex(KDStorage storage, std::size_t threads = 1);
+    KD2Index& build2dIndex(KDStorage storage, std::size_t threads = 1);
+
+    /// Dimension and direction on which to sort points.
+    struct SortKey
+    {
+        Dimension::Id dim;
+        bool descending;
+    };
+
+    /// Sort the points by the values of one or more dimensions.  Points
+    /// are ordered by the first key, then by the second, and so on.  Points
+    /// with equal keys keep their relative order.  This is much faster
+    /// than sorting with a comparator.  Keys whose dimension isn't in the
+    /// layout are ignored.
+    /// \param keys  Sort keys, most significant first.
+    /// \param threads  Number of threads used to sort.
+    void stableSort(const std::vector<SortKey>& keys, std::size_t threads = 1);
+
+    /// Space-filling curve along which points can be ordered.
+    enum class SpatialCurve
+    {
+        Morton,
+        Hilbert
+    };
+
+    /// Sort the points along a space-filling curve through their
+    /// locations, so that points that are close in space tend to be close
+    /// in the view.  This improves locality for stages that process
+    /// neighborhoods of points.
+    /// \param curve  Space-filling curve.
+    /// \param is3d  Whether to order by X, Y and Z rather than X and Y.
+    /// \param threads  Number of threads used to sort.
+    void spatialSort(SpatialCurve curve, bool is3d = false,
+        std::size_t threads = 1);
+
     template <typename Compare>
     void stableSort(Compare compare)
     {
         clearTemps();
 
         // This vector of ascending IDs represents our current normal order.
-        std::vector<std::size_t> order;
+        std::vector<PointId> order;
         order.reserve(size());
-        for (std::size_t i = 0; i < size(); ++i)
+        for (PointId i = 0; i < size(); ++i)
             order.push_back(i);
 
         // Sort these IDs into the proper order based on the comparator.
@@ -324,12 +379,7 @@ public:
                 return compare(PointRef(*this, a), PointRef(*this, b));
             });
 
-        // Now, overwrite our ordering index with the result of the sort.  Use
-        // a temporary copy of the index to avoid hammering over things as we
-        // are copying.
-        const auto old = m_index;
-        for (std::size_t i = 0; i < size(); ++i)
-            m_index[i] = old[order[i]];
+        reorder(order);
     }
 
 protected:
@@ -348,9 +398,10 @@ protected:
     std::unique_ptr<KD2Index> m_index2;
 
 private:
-    static int m_lastId;
+    static std::atomic<int> m_lastId;
 
     PointId tableId(PointId idx);
+    void reorder(const std::vector<PointId>& order);
 
     virtual void setFieldInternal(Dimension::Id dim, PointId idx,
         const void *buf);
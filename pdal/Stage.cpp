@@ -38,13 +38,18 @@
 #include <pdal/PDALUtils.hpp>
 #include <pdal/util/Algorithm.hpp>
 #include <pdal/util/ProgramArgs.hpp>
+#include <pdal/util/Executor.hpp>
 #include <pdal/private/gdal/ErrorHandler.hpp>
 #include "../filters/private/expr/ConditionalExpression.hpp"
 
 #include "private/StageRunner.hpp"
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <iterator>
 #include <memory>
+#include <set>
 
 namespace pdal
 {
@@ -63,12 +68,15 @@ void Stage::splitView(const PointViewPtr& view, PointViewPtr& keep, PointViewPtr
     const expr::ConditionalExpression *where = whereExpr();
     if (where)
     {
+        std::vector<char> pass;
+        where->eval(*view, pass);
+
         PointView *k = keep.get();
         PointView *s = skip.get();
-        for (PointRef p : *view)
+        for (PointId id = 0; id < view->size(); ++id)
         {
-            PointView *active = where->eval(p) ? k : s;
-            active->appendPoint(*view, p.pointId());
+            PointView *active = pass[id] ? k : s;
+            active->appendPoint(*view, id);
         }
     }
     else
@@ -173,7 +181,7 @@ void Stage::prepare(PointTableRef table)
 }
 
 
-PointViewSet Stage::execute(PointTableRef table)
+PointViewSet Stage::execute(PointTableRef table, std::size_t threads)
 {
     if (!table.layout()->finalized())
     {
@@ -212,6 +220,7 @@ PointViewSet Stage::execute(PointTableRef table)
     std::stack<StageInstance> stages;
     std::stack<StageInstance> pending;
     std::map<StageInstance, StageInstance> children;
+    bool branched = false;
 
     m_log->get(LogLevel::Debug) << "Executing pipeline in standard mode." <<
         std::endl;
@@ -224,6 +233,8 @@ PointViewSet Stage::execute(PointTableRef table)
         StageInstance si = pending.top();
         pending.pop();
         stages.push(si);
+        if (si.m_stage->m_inputs.size() > 1)
+            branched = true;
         for (Stage *in : si.m_stage->m_inputs)
         {
             StageInstance parent(in, stageInstanceId++);
@@ -234,33 +245,170 @@ PointViewSet Stage::execute(PointTableRef table)
 
     // Go through the stages in order, executing
     PointViewSet outViews;
-    std::map<StageInstance, PointViewSet> sets;
-    while (stages.size())
+    if (threads <= 1 || !branched || !table.setConcurrent(true))
+    {
+        std::map<StageInstance, PointViewSet> sets;
+        while (stages.size())
+        {
+            StageInstance si = stages.top();
+            stages.pop();
+            PointViewSet& inViews = sets[si];
+            if (inViews.empty())
+                inViews.insert(PointViewPtr(new PointView(table)));
+            outViews = si.m_stage->execute(table, inViews);
+
+            StageInstance child = children[si];
+
+            // If a stage has no child it is the terminal stage.  We're done.
+            if (child.m_stage)
+                sets[child].insert(outViews.begin(), outViews.end());
+            // Allow previous point views to be freed.
+            sets.erase(si);
+        }
+        return outViews;
+    }
+
+    m_log->get(LogLevel::Debug) << "Running pipeline branches on up to " <<
+        threads << " threads." << std::endl;
+
+    // A stage instance is run once all of its inputs have been run.  The
+    // output of each input is kept separately and keyed by the position of
+    // the input in the serial execution order so that a child sees its
+    // input views in the same order no matter which input finished first.
+    std::map<StageInstance, int> position;
+    std::map<StageInstance, size_t> waiting;
+    std::map<StageInstance, std::map<int, PointViewSet>> results;
+    std::vector<StageInstance> roots;
+    for (int pos = 0; stages.size(); ++pos)
     {
         StageInstance si = stages.top();
         stages.pop();
-        PointViewSet& inViews = sets[si];
-        if (inViews.empty())
-            inViews.insert(PointViewPtr(new PointView(table)));
-        outViews = si.m_stage->execute(table, inViews);
-
-        StageInstance child = children[si];
-
-        // If a stage has no child it is the terminal stage.  We're done.
-        if (child.m_stage)
-            sets[child].insert(outViews.begin(), outViews.end());
-        // Allow previous point views to be freed.
-        sets.erase(si);
+        position[si] = pos;
+        waiting[si] = si.m_stage->m_inputs.size();
+        if (si.m_stage->m_inputs.empty())
+            roots.push_back(si);
+    }
+
+    std::mutex mutex;
+    std::mutex tableLock;
+    std::condition_variable done;
+    std::exception_ptr error;
+    size_t remaining = position.size();
+    TaskGroup group(threads);
+
+    // Called with 'mutex' held.
+    auto gather = [&](const StageInstance& si)
+    {
+        PointViewSet views;
+
+        // Views are renumbered so that the set ordering matches a serial run.
+        for (auto& r : results[si])
+            for (const PointViewPtr& v : r.second)
+            {
+                v->m_id = ++PointView::m_lastId;
+                views.insert(v);
+            }
+        results.erase(si);
+        if (views.empty())
+            views.insert(PointViewPtr(new PointView(table)));
+        return views;
+    };
+
+    // A stage that feeds more than one consumer has an instance for each
+    // of them.  The instances share the stage's members, so an instance
+    // isn't started while another instance of the same stage is running.
+    // Called with 'mutex' held.
+    std::set<Stage *> running;
+    std::map<Stage *, std::deque<StageInstance>> deferred;
+    std::function<void(StageInstance)> schedule = [&](StageInstance si)
+    {
+        if (!running.insert(si.m_stage).second)
+        {
+            deferred[si.m_stage].push_back(si);
+            return;
+        }
+        group.add([&, si]()
+        {
+            PointViewSet inViews;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                inViews = gather(si);
+            }
+
+            PointViewSet views;
+            std::exception_ptr err;
+            try
+            {
+                views = si.m_stage->execute(table, inViews, &tableLock);
+            }
+            catch (...)
+            {
+                err = std::current_exception();
+            }
+            inViews.clear();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            remaining--;
+            if (err && !error)
+                error = err;
+            running.erase(si.m_stage);
+            if (!error)
+            {
+                auto di = deferred.find(si.m_stage);
+                if (di != deferred.end())
+                {
+                    StageInstance next = di->second.front();
+                    di->second.pop_front();
+                    if (di->second.empty())
+                        deferred.erase(di);
+                    schedule(next);
+                }
+
+                StageInstance child = children[si];
+                if (child.m_stage)
+                {
+                    results[child][position[si]] = views;
+                    if (--waiting[child] == 0)
+                        schedule(child);
+                }
+                else
+                    outViews = views;
+            }
+            done.notify_all();
+        });
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const StageInstance& si : roots)
+            schedule(si);
     }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&]() { return remaining == 0 || error; });
+    lock.unlock();
+
+    // Wait for any stages that are still running if there was an error.
+    group.wait();
+    table.setConcurrent(false);
+    if (error)
+        std::rethrow_exception(error);
     return outViews;
 }
 
-PointViewSet Stage::execute(PointTableRef table, PointViewSet& views)
+PointViewSet Stage::execute(PointTableRef table, PointViewSet& views,
+    std::mutex *tableLock)
 {
 
     PointViewSet outViews;
     std::vector<StageRunnerPtr> runners;
 
+    // The spatial references on the table are shared by all stages, so
+    // hold the lock while setting them up and getting the stage ready.
+    std::unique_lock<std::mutex> lock;
+    if (tableLock)
+        lock = std::unique_lock<std::mutex>(*tableLock);
+
     startLogging();
 
     // Put the spatial references from the views onto the table.
@@ -295,12 +443,34 @@ PointViewSet Stage::execute(PointTableRef table, PointViewSet& views)
     for (StageRunnerPtr r : runners)
         keeps.insert(r->keeps());
     prerun(keeps);
+    if (lock)
+        lock.unlock();
+
+    // If the stage allows it, run the views as a group of tasks.
+    std::unique_ptr<TaskGroup> group;
+    std::size_t threads = (std::min)(viewThreads(), runners.size());
+    if (threads > 1)
+    {
+        log()->get(LogLevel::Debug) << "Running " << runners.size() <<
+            " point views on " << threads << " threads." << std::endl;
+        group.reset(new TaskGroup(threads));
+    }
 
     for (StageRunnerPtr r : runners)
-        r->run();
+    {
+        if (group)
+            r->run(*group);
+        else
+            r->run();
+    }
+
+    // Waiting on the group rather than on the individual runners lets a
+    // worker thread that is running this stage help with the views.
+    if (group)
+        group->wait();
 
-    // As the stages complete (synchronously at this time), propagate the
-    // spatial reference and merge the output views.
+    // As the stages complete, propagate the spatial reference and merge
+    // the output views.
     srs = getSpatialReference();
     for (StageRunnerPtr r : runners)
     {
@@ -311,9 +481,18 @@ PointViewSet Stage::execute(PointTableRef table, PointViewSet& views)
         if (!srs.empty())
             for (PointViewPtr v : temp)
                 v->setSpatialReference(srs);
+
+        // Views created on worker threads get their ids in completion
+        // order.  Renumber them in runner order so that the order of the
+        // output set doesn't depend on scheduling.
+        if (group)
+            for (PointViewPtr v : temp)
+                v->m_id = ++PointView::m_lastId;
         outViews.insert(temp.begin(), temp.end());
     }
 
+    if (tableLock)
+        lock.lock();
     done(table);
     stopLogging();
     m_pointCount = 0;
@@ -35,6 +35,7 @@
 #pragma once
 
 #include <list>
+#include <mutex>
 
 #include <pdal/Dimension.hpp>
 #include <pdal/DimType.hpp>
@@ -130,12 +131,18 @@ public:
       \ref run function of each stage in depth first order.  Each stage is run
       to completion (all points are processed) before the next stages is run.o
 
+      Independent branches of a pipeline (inputs of a stage with several
+      inputs, such as filters.merge) can be run at the same time by
+      providing more than one thread.  Branch outputs are combined in the
+      same order as a single-threaded run.
+
       \param table  Point table being used for stage pipeline.  This must be
         the same \ref table used in the \ref prepare function.
+      \param threads  Maximum number of pipeline branches to run at once.
     */
-    PointViewSet execute(PointTableRef table);
+    PointViewSet execute(PointTableRef table, std::size_t threads = 1);
 
-    virtual void execute(StreamPointTable& table)
+    virtual void execute(StreamPointTable& table, std::size_t threads = 1)
     {
         throw pdal_error("Attempting to use stream mode with a non-streamable "
             "stage.");
@@ -359,6 +366,16 @@ protected:
     */
     point_count_t faceCount() const
         { return m_faceCount; }
+    /**
+      Determine whether the stage may be run on several point views at
+      the same time.  Stages that only modify the points of the view being
+      processed and hold no per-view mutable state can override this to
+      allow point views to be run concurrently (standard mode).
+
+      \return  Whether point views can be run concurrently by this stage.
+    */
+    virtual bool parallelViewSafe() const
+        { return false; }
 
 private:
     uint32_t m_verbose;
@@ -384,6 +401,8 @@ private:
 
     virtual const expr::ConditionalExpression *whereExpr() const = 0;
     virtual WhereMergeMode mergeMode() const = 0;
+    virtual std::size_t viewThreads() const
+        { return 1; }
     void setupLog();
     void handleOptions();
     void countElements(const PointViewSet& views);
@@ -456,9 +475,12 @@ private:
 
       \param table  PointTable
       \param pvSet  Input PointViewSet
+      \param tableLock  Lock held while the stage uses state shared through
+        the table.  Provided when other stages may run at the same time.
       \return  Output PointViewSet
     */
-    PointViewSet execute(PointTableRef table, PointViewSet& pvSet);
+    PointViewSet execute(PointTableRef table, PointViewSet& pvSet,
+        std::mutex *tableLock = nullptr);
 
     /**
       Functions called after dimensions have been added.  Implement in
@@ -32,11 +32,15 @@
 * OF SUCH DAMAGE.
 ****************************************************************************/
 
+#include <condition_variable>
 #include <iterator>
+#include <thread>
 
 #include <pdal/Streamable.hpp>
+#include <pdal/PointSpan.hpp>
 #include <pdal/Filter.hpp>
 #include <pdal/Reader.hpp>
+#include <pdal/util/Executor.hpp>
 #include "../filters/private/expr/ConditionalExpression.hpp"
 
 namespace pdal
@@ -70,7 +74,7 @@ const Stage *Streamable::findNonstreamable() const
 
 
 // Streamed execution.
-void Streamable::execute(StreamPointTable& table)
+void Streamable::execute(StreamPointTable& table, std::size_t threads)
 {
     m_log->get(LogLevel::Debug) << "Executing pipeline in stream mode." <<
         std::endl;
@@ -165,7 +169,10 @@ void Streamable::execute(StreamPointTable& table)
             (lastRunStages - stages).done(table);
             // Call ready on all the stages we didn't run last time.
             (stages - lastRunStages).ready(table);
-            execute(table, stages, srsMap);
+            if (threads > 1 && table.supportsChunks())
+                executePipelined(table, stages, srsMap, threads);
+            else
+                execute(table, stages, srsMap);
             lastRunStages = stages;
         }
         else
@@ -211,6 +218,9 @@ void Streamable::execute(StreamPointTable& table,
 
     // Loop until we're finished.  We handle the number of points up to
     // the capacity of the StreamPointTable that we've been provided.
+    // The selection holds the ids of the points that haven't been filtered
+    // out so that filters only visit those points.
+    std::vector<PointId> selection(table.capacity());
 
     bool finished = false;
     while (!finished)
@@ -244,8 +254,11 @@ void Streamable::execute(StreamPointTable& table,
 
         // Note again that we're treating writers as filters.
         // When we get a false back from a filter, we're filtering out a
-        // point, so add it to the list of skips so that it doesn't get
-        // processed by subsequent filters.
+        // point, so it's removed from the selection and marked as skipped
+        // so that it doesn't get processed by subsequent filters.
+        point_count_t selected = pointLimit;
+        for (PointId idx = 0; idx < pointLimit; idx++)
+            selection[idx] = idx;
         for (Streamable *s : filters)
         {
             auto si = srsMap.find(s);
@@ -255,18 +268,7 @@ void Streamable::execute(StreamPointTable& table,
                 srsMap[s] = srs;
             }
             s->startLogging();
-
-            const expr::ConditionalExpression* where = s->whereExpr();
-            for (PointId idx = 0; idx < pointLimit; idx++)
-            {
-                point.setPointId(idx);
-                if (table.skip(idx))
-                    continue;
-                if (where && !where->eval(point))
-                    continue;
-                if (!s->processOne(point))
-                    table.setSkip(idx);
-            }
+            selected = s->processPoints(table, selection.data(), selected);
             const SpatialReference& tempSrs = s->getSpatialReference();
             if (!tempSrs.empty())
             {
@@ -280,5 +282,278 @@ void Streamable::execute(StreamPointTable& table,
     }
 }
 
+
+
+void Streamable::processBatch(PointSpan& span)
+{
+    PointRef point(span.table());
+    for (point_count_t i = 0; i < span.size(); ++i)
+    {
+        point.setPointId(span.id(i));
+        if (!processOne(point))
+            span.skip(i);
+    }
+}
+
+
+point_count_t Streamable::processPoints(StreamPointTable& table,
+    PointId *selection, point_count_t count)
+{
+    const expr::ConditionalExpression* where = whereExpr();
+    if (!where)
+    {
+        PointSpan span(table, selection, count);
+        processBatch(span);
+    }
+    else
+    {
+        // Only the points that pass the 'where' expression are handed
+        // to the stage.  Points that don't pass remain selected.
+        std::vector<char> pass;
+        where->eval(PointSpan(table, selection, count), pass);
+
+        std::vector<PointId> passed;
+        passed.reserve(count);
+        for (point_count_t i = 0; i < count; ++i)
+            if (pass[i])
+                passed.push_back(selection[i]);
+        PointSpan span(table, passed.data(), passed.size());
+        processBatch(span);
+    }
+
+    // Remove the points that the stage filtered out from the selection.
+    point_count_t kept = 0;
+    for (point_count_t i = 0; i < count; ++i)
+        if (!table.skip(selection[i]))
+            selection[kept++] = selection[i];
+    return kept;
+}
+
+
+namespace
+{
+
+// A chunk is a range of points of a stream table.  Each stage processes
+// the chunks in ring order.  'm_next' is the position of the stage that
+// should process the chunk next.
+struct Chunk
+{
+    PointId m_start;
+    point_count_t m_capacity;
+    point_count_t m_count;
+    std::vector<PointId> m_selection;
+    point_count_t m_selected;
+    size_t m_next;
+    bool m_last;
+    SpatialReference m_srs;
+};
+
+// Smallest number of points handed to a thread when splitting a chunk.
+const point_count_t MinSplitPoints = 512;
+
+} // unnamed namespace
+
+
+// Streamed execution with each stage running on its own thread.  The table
+// is divided into a ring of chunks so that the reader can fill a chunk
+// while subsequent stages process earlier chunks.
+void Streamable::executePipelined(StreamPointTable& table,
+    std::list<Streamable *>& stageList, SrsMap& srsMap, std::size_t threads)
+{
+    std::vector<Streamable *> stages(stageList.begin(), stageList.end());
+    const size_t numStages = stages.size();
+    const point_count_t chunkSize = table.capacity() / numStages;
+    if (numStages < 2 || chunkSize == 0)
+    {
+        execute(table, stageList, srsMap);
+        return;
+    }
+
+    m_log->get(LogLevel::Debug) << "Streaming " << numStages <<
+        " stages with chunks of " << chunkSize << " points." << std::endl;
+
+    std::vector<Chunk> chunks(numStages);
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        Chunk& c = chunks[i];
+        c.m_start = i * chunkSize;
+        c.m_capacity = chunkSize;
+        c.m_count = 0;
+        c.m_selection.resize(chunkSize);
+        c.m_selected = 0;
+        c.m_next = 0;
+        c.m_last = false;
+    }
+
+    // Spatial reference state for each stage.  Each stage thread only
+    // touches its own entry.  Results are copied back to the map when done.
+    std::vector<char> srsKnown(numStages);
+    std::vector<SpatialReference> stageSrs(numStages);
+    for (size_t i = 1; i < numStages; ++i)
+    {
+        auto si = srsMap.find(stages[i]);
+        if (si != srsMap.end())
+        {
+            srsKnown[i] = 1;
+            stageSrs[i] = si->second;
+        }
+    }
+
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::exception_ptr error;
+
+    // We may be limited in the number of points requested.
+    point_count_t count = (std::numeric_limits<point_count_t>::max)();
+    if (Reader *r = dynamic_cast<Reader *>(stages.front()))
+        count = r->count();
+
+    auto read = [&](Streamable *reader, Chunk& c)
+    {
+        point_count_t pointLimit = (std::min)(count, c.m_capacity);
+        PointRef point(table, c.m_start);
+
+        reader->startLogging();
+        // When we get false back from a reader, we're done, so set
+        // the point limit to the number of points processed in this chunk.
+        bool finished = (pointLimit == 0);
+        for (PointId idx = 0; idx < pointLimit; idx++)
+        {
+            point.setPointId(c.m_start + idx);
+            finished = !reader->processOne(point);
+            if (finished)
+                pointLimit = idx;
+        }
+        count -= pointLimit;
+        reader->stopLogging();
+
+        c.m_count = pointLimit;
+        c.m_selected = pointLimit;
+        for (PointId idx = 0; idx < pointLimit; idx++)
+            c.m_selection[idx] = c.m_start + idx;
+        c.m_last = finished;
+        c.m_srs = reader->getSpatialReference();
+    };
+
+    // Note that we're treating writers as filters.
+    auto filter = [&](size_t stageNum, Chunk& c)
+    {
+        Streamable *s = stages[stageNum];
+        if (!srsKnown[stageNum] || stageSrs[stageNum] != c.m_srs)
+        {
+            s->spatialReferenceChanged(c.m_srs);
+            srsKnown[stageNum] = 1;
+            stageSrs[stageNum] = c.m_srs;
+        }
+        s->startLogging();
+
+        // When splitting, each part of the selection is filtered in place
+        // and the surviving ids are then moved together.
+        size_t parts = 1;
+        if (s->parallelPointSafe())
+            parts = (std::min)((size_t)threads,
+                (size_t)(c.m_selected / MinSplitPoints));
+        if (parts > 1)
+        {
+            std::vector<point_count_t> kept(parts);
+            const point_count_t partSize = (c.m_selected + parts - 1) / parts;
+            TaskGroup group(parts);
+            for (size_t i = 0; i < parts; ++i)
+            {
+                point_count_t begin = (std::min)(i * partSize, c.m_selected);
+                point_count_t size = (std::min)(partSize,
+                    c.m_selected - begin);
+                PointId *sel = c.m_selection.data() + begin;
+                group.add([&table, &kept, s, sel, size, i]()
+                    { kept[i] = s->processPoints(table, sel, size); });
+            }
+            group.wait();
+
+            point_count_t selected = 0;
+            for (size_t i = 0; i < parts; ++i)
+            {
+                PointId *sel = c.m_selection.data() +
+                    (std::min)(i * partSize, c.m_selected);
+                std::copy(sel, sel + kept[i], c.m_selection.data() + selected);
+                selected += kept[i];
+            }
+            c.m_selected = selected;
+        }
+        else
+            c.m_selected = s->processPoints(table, c.m_selection.data(),
+                c.m_selected);
+
+        const SpatialReference& tempSrs = s->getSpatialReference();
+        if (!tempSrs.empty())
+            c.m_srs = tempSrs;
+        s->stopLogging();
+    };
+
+    auto run = [&](size_t stageNum)
+    {
+        try
+        {
+            for (size_t ci = 0; ; ci = (ci + 1) % chunks.size())
+            {
+                Chunk& c = chunks[ci];
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&]()
+                        { return c.m_next == stageNum || error; });
+                    if (error)
+                        return;
+                }
+
+                if (stageNum == 0)
+                    read(stages.front(), c);
+                else
+                    filter(stageNum, c);
+                bool last = c.m_last;
+
+                // Once the last stage is done with a chunk, clear it and
+                // hand it back to the reader.
+                if (stageNum == numStages - 1)
+                {
+                    table.clear(c.m_start, c.m_count);
+                    if (last)
+                    {
+                        table.clearSpatialReferences();
+                        if (!c.m_srs.empty())
+                            table.setSpatialReference(c.m_srs);
+                    }
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    c.m_next = (stageNum + 1) % numStages;
+                }
+                cv.notify_all();
+                if (last)
+                    return;
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error)
+                error = std::current_exception();
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < numStages; ++i)
+        workers.emplace_back(run, i);
+    for (std::thread& t : workers)
+        t.join();
+
+    for (size_t i = 1; i < numStages; ++i)
+        if (srsKnown[i])
+            srsMap[stages[i]] = stageSrs[i];
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
 } // namespace pdal
 
@@ -40,6 +40,7 @@
 namespace pdal
 {
 
+class PointSpan;
 class StreamableWrapper;
 
 class PDAL_DLL Streamable : public virtual Stage
@@ -60,11 +61,17 @@ public:
       Streaming points can reduce memory consumption, but will limit access
       to algorithms that need to operate on full point sets.
 
+      When more than one thread is requested and the table supports chunks,
+      the table is divided into a ring of chunks and each stage runs on its
+      own thread, so that the reader can fill one chunk while filters and
+      writers process others.  Stages that allow it (see
+      \ref parallelPointSafe) also split each chunk among the threads.
+
       \param table  Streaming point table used for stage pipeline.  This must be
         the same \ref table used in the \ref prepare function.
-
+      \param threads  Number of threads used to split chunks among.
     */
-    virtual void execute(StreamPointTable& table);
+    virtual void execute(StreamPointTable& table, std::size_t threads = 1);
     using Stage::execute;
 
     /**
@@ -82,6 +89,22 @@ protected:
 
     void execute(StreamPointTable& table, std::list<Streamable *>& stages,
         SrsMap& srsMap);
+    void executePipelined(StreamPointTable& table,
+        std::list<Streamable *>& stages, SrsMap& srsMap, std::size_t threads);
+
+    /**
+      Process the selected points of a stream table with this stage.
+      Points that the stage filters out are marked as skipped in the table
+      and removed from the selection.  Points that don't pass the stage's
+      'where' expression aren't processed but remain selected.
+
+      \param table  Stream table holding the points.
+      \param selection  Ids of the points to process.  Updated in place.
+      \param count  Number of ids in the selection.
+      \return  Number of ids remaining in the selection.
+    */
+    point_count_t processPoints(StreamPointTable& table, PointId *selection,
+        point_count_t count);
 
     /**
       Process a single point (streaming mode).  Implement in subclass.
@@ -92,6 +115,17 @@ protected:
         to subsequent stages).
     */
     virtual bool processOne(PointRef& /*point*/) = 0;
+
+    /**
+      Process a set of points (streaming mode).  The default implementation
+      calls \ref processOne for each point in the span.  Stages can
+      override this to avoid per-point dispatch and access fields a column
+      at a time.  Points to be filtered out should be marked with
+      PointSpan::skip().
+
+      \param span  Points to process.
+    */
+    virtual void processBatch(PointSpan& span);
     /**
     {
         throwStreamingError();
@@ -108,6 +142,17 @@ protected:
     virtual void spatialReferenceChanged(const SpatialReference& /*srs*/)
     {}
 
+    /**
+      Determine whether \ref processOne can be called for different points
+      at the same time.  Stages whose processing of a point depends only on
+      that point and on state that isn't modified while streaming can
+      override this to have chunks of points split among threads.
+
+      \return  Whether processOne() may be called concurrently.
+    */
+    virtual bool parallelPointSafe() const
+        { return false; }
+
     /**
       Find the first nonstreamable stage in a pipeline.
 
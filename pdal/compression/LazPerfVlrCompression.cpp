@@ -36,7 +36,9 @@
 #pragma warning (disable: 4251)
 #include <lazperf/lazperf.hpp>
 #include <lazperf/filestream.hpp>
+#include <lazperf/header.hpp>
 #include <lazperf/vlr.hpp>
+#include <lazperf/writers.hpp>
 #pragma warning (pop)
 
 // This only exist in version 1.3+, so is an acceptable version test for now.
@@ -44,6 +46,10 @@
 #error "LAZperf version 2+ (supporting LAS version 1.4) not found"
 #endif
 
+#include <deque>
+#include <future>
+
+#include <pdal/util/Executor.hpp>
 #include <pdal/util/IStream.hpp>
 #include <pdal/util/OStream.hpp>
 #include <pdal/pdal_types.hpp>
@@ -67,10 +73,18 @@ namespace pdal
 class LazPerfVlrCompressorImpl
 {
 public:
-    LazPerfVlrCompressorImpl(std::ostream& stream, int format, int ebCount) :
+    LazPerfVlrCompressorImpl(std::ostream& stream, int format, int ebCount,
+            uint32_t chunksize, std::size_t threads) :
         m_stream(stream), m_outputStream(stream), m_format(format), m_ebCount(ebCount),
-        m_chunksize(50000), m_chunkPointsWritten(0), m_chunkInfoPos(0), m_chunkOffset(0)
-    {}
+        m_chunksize(chunksize), m_chunkPointsWritten(0), m_chunkInfoPos(0), m_chunkOffset(0),
+        m_pointLen(lazperf::baseCount(format) + ebCount), m_started(false)
+    {
+        if (threads > 1)
+        {
+            m_tasks.reset(new TaskGroup(threads));
+            m_points.reserve((size_t)m_chunksize * m_pointLen);
+        }
+    }
 
     std::vector<char> vlrData() const
     {
@@ -80,6 +94,12 @@ public:
 
     void compress(const char *inbuf)
     {
+        if (m_tasks)
+        {
+            compressParallel(inbuf);
+            return;
+        }
+
         // First time through.
         if (!m_compressor)
         {
@@ -108,6 +128,15 @@ public:
             newChunk();
         }
 
+        // Compress the partial chunk and write out the remaining chunks.
+        if (m_tasks)
+        {
+            if (m_chunkPointsWritten)
+                queueChunk();
+            while (m_pending.size())
+                writeChunk();
+        }
+
         // If we didn't write any points, chunk info pos will be 0 and we need to
         // set the chunk info pos. Could do this as an "else" case of the
         // above, but this seems safer in case some other compressor creation logic
@@ -137,6 +166,62 @@ public:
     }
 
 private:
+    // Buffer a point.  Full chunks are compressed as tasks, and the oldest
+    // chunk is written once a few chunks per thread are in flight.
+    void compressParallel(const char *inbuf)
+    {
+        if (!m_started)
+        {
+            m_chunkInfoPos = m_stream.tellp();
+            m_stream.seekp(sizeof(uint64_t), std::ios::cur);
+            m_chunkOffset = m_stream.tellp();
+            m_started = true;
+        }
+        m_points.insert(m_points.end(), inbuf, inbuf + m_pointLen);
+        if (++m_chunkPointsWritten == m_chunksize)
+        {
+            queueChunk();
+            while (m_pending.size() > 2 * m_tasks->maxConcurrency())
+                writeChunk();
+        }
+    }
+
+    void queueChunk()
+    {
+        using Task = std::packaged_task<std::vector<unsigned char>()>;
+
+        auto task = std::make_shared<Task>(
+            [points = std::move(m_points), count = m_chunkPointsWritten,
+                format = m_format, ebCount = m_ebCount, pointLen = m_pointLen]()
+        {
+            lazperf::writer::chunk_compressor compressor(format, ebCount);
+            const char *pos = points.data();
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                compressor.compress(pos);
+                pos += pointLen;
+            }
+            return compressor.done();
+        });
+        m_pending.push_back(task->get_future());
+        m_tasks->add([task](){ (*task)(); });
+
+        m_points = std::vector<char>();
+        m_points.reserve((size_t)m_chunksize * m_pointLen);
+        m_chunkPointsWritten = 0;
+    }
+
+    // Wait for the oldest chunk to be compressed and write it.
+    void writeChunk()
+    {
+        std::vector<unsigned char> data =
+            Executor::global().get(m_pending.front());
+        m_pending.pop_front();
+        m_stream.write((const char *)data.data(), data.size());
+        m_chunkTable.push_back((uint32_t)data.size());
+        m_chunkOffset = m_stream.tellp();
+    }
+
     void resetCompressor()
     {
         if (m_compressor)
@@ -162,11 +247,24 @@ private:
     std::streampos m_chunkInfoPos;
     std::streampos m_chunkOffset;
     std::vector<uint32_t> m_chunkTable;
+
+    // Parallel compression.
+    size_t m_pointLen;
+    bool m_started;
+    std::vector<char> m_points;
+    std::deque<std::future<std::vector<unsigned char>>> m_pending;
+    std::unique_ptr<TaskGroup> m_tasks;
 };
 
 
 LazPerfVlrCompressor::LazPerfVlrCompressor(std::ostream& stream, int format, int ebCount) :
-    m_impl(new LazPerfVlrCompressorImpl(stream, format, ebCount))
+    m_impl(new LazPerfVlrCompressorImpl(stream, format, ebCount, DefaultChunkSize, 1))
+{}
+
+
+LazPerfVlrCompressor::LazPerfVlrCompressor(std::ostream& stream, int format, int ebCount,
+        uint32_t chunksize, std::size_t threads) :
+    m_impl(new LazPerfVlrCompressorImpl(stream, format, ebCount, chunksize, threads))
 {}
 
 
@@ -57,9 +57,14 @@ class LazPerfVlrCompressorImpl;
 class LazPerfVlrCompressor
 {
 public:
+    static const uint32_t DefaultChunkSize = 50000;
+
     LazPerfVlrCompressor(std::ostream& stream, int format, int ebCount);
+    // When 'threads' is greater than one, chunks are compressed on that
+    // many threads and written to the stream in order as they complete.
+    // The output is the same as that of a single-threaded compressor.
     LazPerfVlrCompressor(std::ostream& stream, int format, int ebCount,
-        uint32_t chunksize);
+        uint32_t chunksize, std::size_t threads = 1);
     ~LazPerfVlrCompressor();
 
     std::vector<char> vlrData() const;
@@ -34,15 +34,256 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+
 #include <nanoflann/nanoflann.hpp>
 
+#include <pdal/KDIndex.hpp>
+#include <pdal/PointColumn.hpp>
+#include <pdal/util/Executor.hpp>
+
 namespace pdal
 {
 
+// Copy of the coordinates of the points of a view, stored by dimension in
+// contiguous arrays.  Once the tree is built, the arrays are put in the
+// order of the tree's leaves and the tree refers to positions in the arrays
+// rather than to point IDs, so that leaf scans read adjacent memory.
+// With float storage, coordinates are stored relative to the minimum
+// value of each dimension to limit the loss of precision.
+class KDSnapshot
+{
+public:
+    KDSnapshot(KDStorage storage) : m_storage(storage)
+    {}
+
+    bool active() const
+        { return m_storage != KDStorage::View; }
+
+    void load(const std::vector<const PointColumn<double> *>& cols)
+    {
+        const point_count_t size = cols.empty() ? 0 : cols[0]->size();
+
+        m_origin.assign(cols.size(), 0.0);
+        m_doubles.clear();
+        m_floats.clear();
+        m_ids.clear();
+        if (m_storage == KDStorage::Float)
+        {
+            m_floats.resize(cols.size());
+            for (size_t d = 0; d < cols.size(); ++d)
+            {
+                const PointColumn<double>& col = *cols[d];
+                double origin = size ? col[0] : 0.0;
+                for (PointId i = 1; i < size; ++i)
+                    origin = (std::min)(origin, col[i]);
+                m_origin[d] = origin;
+                std::vector<float>& vals = m_floats[d];
+                vals.resize(size);
+                for (PointId i = 0; i < size; ++i)
+                    vals[i] = static_cast<float>(col[i] - origin);
+            }
+        }
+        else
+        {
+            m_doubles.resize(cols.size());
+            for (size_t d = 0; d < cols.size(); ++d)
+            {
+                const PointColumn<double>& col = *cols[d];
+                std::vector<double>& vals = m_doubles[d];
+                vals.resize(size);
+                for (PointId i = 0; i < size; ++i)
+                    vals[i] = col[i];
+            }
+        }
+    }
+
+    // Put the coordinates in the order of the tree's index array and
+    // make the index array refer to positions.
+    void reorder(std::vector<std::size_t>& vind)
+    {
+        m_ids.assign(vind.begin(), vind.end());
+        for (std::vector<double>& vals : m_doubles)
+            permute(vals);
+        for (std::vector<float>& vals : m_floats)
+            permute(vals);
+        for (std::size_t i = 0; i < vind.size(); ++i)
+            vind[i] = i;
+    }
+
+    PointId id(std::size_t pos) const
+        { return m_ids.empty() ? pos : m_ids[pos]; }
+
+    double get(std::size_t pos, int dim) const
+    {
+        if (m_storage == KDStorage::Float)
+            return m_origin[dim] + m_floats[dim][pos];
+        return m_doubles[dim][pos];
+    }
+
+    double distance(const double *p, std::size_t pos) const
+    {
+        double result(0.0);
+        if (m_storage == KDStorage::Float)
+            for (size_t d = 0; d < m_floats.size(); ++d)
+            {
+                float diff = static_cast<float>(p[d] - m_origin[d]) -
+                    m_floats[d][pos];
+                result += diff * diff;
+            }
+        else
+            for (size_t d = 0; d < m_doubles.size(); ++d)
+            {
+                double diff = p[d] - m_doubles[d][pos];
+                result += diff * diff;
+            }
+        return result;
+    }
+
+private:
+    template<typename T>
+    void permute(std::vector<T>& vals)
+    {
+        std::vector<T> tmp(vals.size());
+        for (std::size_t i = 0; i < m_ids.size(); ++i)
+            tmp[i] = vals[m_ids[i]];
+        vals.swap(tmp);
+    }
+
+    KDStorage m_storage;
+    std::vector<double> m_origin;
+    std::vector<std::vector<double>> m_doubles;
+    std::vector<std::vector<float>> m_floats;
+    PointIdList m_ids;
+};
+
+// Builds a nanoflann index with the subtrees near the root built as tasks on
+// up to 'threads' threads.  The tree is the same as the one built by
+// nanoflann's buildIndex(), whose steps this follows using the index's
+// public members.  The index's node pool isn't thread-safe, so allocation
+// is serialized.
+template<typename TREE>
+class KDTreeBuilder
+{
+public:
+    KDTreeBuilder(TREE& tree, std::size_t threads) : m_tree(tree),
+        m_spawnDepth(0)
+    {
+        // Spawn about twice as many tasks as threads to balance uneven
+        // splits.
+        while (((std::size_t)1 << m_spawnDepth) < threads * 2)
+            m_spawnDepth++;
+    }
+
+    void build()
+    {
+        TREE& t = m_tree;
+        t.m_size = t.dataset.kdtree_get_point_count();
+        t.m_size_at_index_build = t.m_size;
+        t.init_vind();
+        t.freeIndex(t);
+        t.m_size_at_index_build = t.m_size;
+        if (t.m_size == 0)
+            return;
+        t.computeBoundingBox(t.root_bbox);
+        t.root_node = divide(0, t.m_size, t.root_bbox, 0);
+    }
+
+private:
+    using NodePtr = typename TREE::NodePtr;
+    using Node = typename TREE::Node;
+    using BoundingBox = typename TREE::BoundingBox;
+    using DistanceType = typename TREE::DistanceType;
+
+    TREE& m_tree;
+    int m_spawnDepth;
+    std::mutex m_mutex;
+
+    NodePtr divide(std::size_t left, std::size_t right, BoundingBox& bbox,
+        int depth)
+    {
+        TREE& t = m_tree;
+        NodePtr node;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            node = t.pool.template allocate<Node>();
+        }
+
+        if (right - left <= t.m_leaf_max_size)
+        {
+            node->child1 = node->child2 = nullptr;
+            node->node_type.lr.left = left;
+            node->node_type.lr.right = right;
+
+            for (int i = 0; i < t.dim; ++i)
+                bbox[i].low = bbox[i].high = t.dataset_get(t, t.vind[left], i);
+            for (std::size_t k = left + 1; k < right; ++k)
+                for (int i = 0; i < t.dim; ++i)
+                {
+                    auto v = t.dataset_get(t, t.vind[k], i);
+                    if (bbox[i].low > v)
+                        bbox[i].low = v;
+                    if (bbox[i].high < v)
+                        bbox[i].high = v;
+                }
+            return node;
+        }
+
+        std::size_t idx;
+        int cutfeat;
+        DistanceType cutval;
+        t.middleSplit_(t, &t.vind[0] + left, right - left, idx, cutfeat,
+            cutval, bbox);
+        node->node_type.sub.divfeat = cutfeat;
+
+        BoundingBox leftBox(bbox);
+        leftBox[cutfeat].high = cutval;
+        BoundingBox rightBox(bbox);
+        rightBox[cutfeat].low = cutval;
+
+        // Near the root, the right subtree is built as a task while this
+        // thread builds the left one.
+        std::unique_ptr<TaskGroup> group;
+        if (depth < m_spawnDepth)
+        {
+            group.reset(new TaskGroup(1));
+            group->add([&]()
+                { node->child2 = divide(left + idx, right, rightBox,
+                    depth + 1); });
+        }
+        node->child1 = divide(left, left + idx, leftBox, depth + 1);
+        if (group)
+            group->wait();
+        else
+            node->child2 = divide(left + idx, right, rightBox, depth + 1);
+
+        node->node_type.sub.divlow = leftBox[cutfeat].high;
+        node->node_type.sub.divhigh = rightBox[cutfeat].low;
+        for (int i = 0; i < t.dim; ++i)
+        {
+            bbox[i].low = (std::min)(leftBox[i].low, rightBox[i].low);
+            bbox[i].high = (std::max)(leftBox[i].high, rightBox[i].high);
+        }
+        return node;
+    }
+};
+
+template<typename TREE>
+void buildTree(TREE& tree, std::size_t threads)
+{
+    if (threads <= 1)
+        tree.buildIndex();
+    else
+        KDTreeBuilder<TREE>(tree, threads).build();
+}
+
 class KD2Impl
 {
 public:
-    KD2Impl(const PointView& buf) : m_buf(buf),
+    KD2Impl(const PointView& buf, KDStorage storage) : m_buf(buf),
+        m_x(buf.column<double>(Dimension::Id::X)),
+        m_y(buf.column<double>(Dimension::Id::Y)), m_snapshot(storage),
         m_index(2, *this, nanoflann::KDTreeSingleIndexAdaptorParams(100))
     {}
 
@@ -53,16 +294,19 @@ public:
 
     double kdtree_get_pt(const PointId idx, int dim) const
     {
-        using namespace Dimension;
-        std::array<Id, 2> ids { Id::X, Id::Y };
-        return m_buf.getFieldAs<double>(ids[dim], idx);
+        if (m_snapshot.active())
+            return m_snapshot.get(idx, dim);
+        return dim == 0 ? m_x[idx] : m_y[idx];
     }
     
     double kdtree_distance(const double *p1, const PointId p2_idx,
         size_t /*numDims*/) const
     {
-        double d0 = p1[0] - m_buf.getFieldAs<double>(Dimension::Id::X, p2_idx);
-        double d1 = p1[1] - m_buf.getFieldAs<double>(Dimension::Id::Y, p2_idx);
+        if (m_snapshot.active())
+            return m_snapshot.distance(p1, p2_idx);
+
+        double d0 = p1[0] - m_x[p2_idx];
+        double d1 = p1[1] - m_y[p2_idx];
 
         return (d0 * d0 + d1 * d1);
     }
@@ -82,9 +326,13 @@ public:
         return true;
     }
 
-    void build()
+    void build(std::size_t threads)
     {
-        m_index.buildIndex();
+        if (m_snapshot.active())
+            m_snapshot.load({ &m_x, &m_y });
+        buildTree(m_index, threads);
+        if (m_snapshot.active())
+            m_snapshot.reorder(m_index.vind);
     }
 
     PointIdList neighbors(double x, double y, point_count_t k) const
@@ -98,6 +346,7 @@ public:
 
         std::array<double, 2> pt { x, y };
         m_index.findNeighbors(resultSet, &pt[0], nanoflann::SearchParams(10));
+        toIds(output.data(), resultSet.size());
         return output;
     }
 
@@ -111,6 +360,7 @@ public:
 
         std::array<double, 2> pt { x, y };
         m_index.findNeighbors(resultSet, &pt[0], nanoflann::SearchParams(10));
+        toIds(indices->data(), resultSet.size());
     }
 
     PointIdList radius(double const& x, double const& y, double const& r) const
@@ -128,12 +378,53 @@ public:
             m_index.radiusSearch(&pt[0], r * r, ret_matches, params);
 
         for (std::size_t i = 0; i < count; ++i)
-            output.push_back(ret_matches[i].first);
+            output.push_back(m_snapshot.id(ret_matches[i].first));
         return output;
     }
 
+    // Find the k nearest neighbors of a query point.
+    std::size_t knn(const double *pt, point_count_t k, PointId *ids,
+        double *sqrDists) const
+    {
+        k = (std::min)(m_buf.size(), k);
+        nanoflann::KNNResultSet<double, PointId, point_count_t> resultSet(k);
+
+        resultSet.init(ids, sqrDists);
+        m_index.findNeighbors(resultSet, pt, nanoflann::SearchParams());
+        toIds(ids, resultSet.size());
+        return resultSet.size();
+    }
+
+    // Append the neighbors within a radius of a query point.
+    void radius(const double *pt, double r, PointIdList& ids,
+        std::vector<double>& sqrDists) const
+    {
+        std::vector<std::pair<std::size_t, double>> ret_matches;
+        nanoflann::SearchParams params;
+        params.sorted = true;
+
+        const std::size_t count =
+            m_index.radiusSearch(pt, r * r, ret_matches, params);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            ids.push_back(m_snapshot.id(ret_matches[i].first));
+            sqrDists.push_back(ret_matches[i].second);
+        }
+    }
+
 private:
+    // Convert tree positions to point IDs.
+    void toIds(PointId *ids, std::size_t count) const
+    {
+        if (m_snapshot.active())
+            for (std::size_t i = 0; i < count; ++i)
+                ids[i] = m_snapshot.id(ids[i]);
+    }
+
     const PointView& m_buf;
+    PointColumn<double> m_x;
+    PointColumn<double> m_y;
+    KDSnapshot m_snapshot;
 
     typedef nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<
         double, KD2Impl, double>, KD2Impl, -1, std::size_t> KDTree;
@@ -144,7 +435,10 @@ private:
 class KD3Impl
 {
 public:
-    KD3Impl(const PointView& buf) : m_buf(buf),
+    KD3Impl(const PointView& buf, KDStorage storage) : m_buf(buf),
+        m_x(buf.column<double>(Dimension::Id::X)),
+        m_y(buf.column<double>(Dimension::Id::Y)),
+        m_z(buf.column<double>(Dimension::Id::Z)), m_snapshot(storage),
         m_index(3, *this, nanoflann::KDTreeSingleIndexAdaptorParams(100))
     {}
 
@@ -158,21 +452,31 @@ public:
         if (idx >= m_buf.size())
             return 0.0;
 
-        using namespace Dimension;
-        std::array<Id, 3> ids { Id::X, Id::Y, Id::Z };
-        if ((size_t)dim >= ids.size())
+        if (m_snapshot.active() && dim < 3)
+            return m_snapshot.get(idx, dim);
+        switch (dim)
+        {
+        case 0:
+            return m_x[idx];
+        case 1:
+            return m_y[idx];
+        case 2:
+            return m_z[idx];
+        default:
             throw pdal_error("kdtree_get_pt: Request for invalid dimension "
                 "from nanoflann");
-
-        return m_buf.getFieldAs<double>(ids[dim], idx);
+        }
     }
 
     double kdtree_distance(const double *p1, const PointId p2_idx,
         size_t /*numDims*/) const
     {
-        double d0 = p1[0] - m_buf.getFieldAs<double>(Dimension::Id::X, p2_idx);
-        double d1 = p1[1] - m_buf.getFieldAs<double>(Dimension::Id::Y, p2_idx);
-        double d2 = p1[2] - m_buf.getFieldAs<double>(Dimension::Id::Z, p2_idx);
+        if (m_snapshot.active())
+            return m_snapshot.distance(p1, p2_idx);
+
+        double d0 = p1[0] - m_x[p2_idx];
+        double d1 = p1[1] - m_y[p2_idx];
+        double d2 = p1[2] - m_z[p2_idx];
 
         return (d0 * d0 + d1 * d1 + d2 * d2);
     }
@@ -192,9 +496,13 @@ public:
         return true;
     }
 
-    void build()
+    void build(std::size_t threads)
     {
-        m_index.buildIndex();
+        if (m_snapshot.active())
+            m_snapshot.load({ &m_x, &m_y, &m_z });
+        buildTree(m_index, threads);
+        if (m_snapshot.active())
+            m_snapshot.reorder(m_index.vind);
     }
 
     PointIdList neighbors(double x, double y, double z, point_count_t k,
@@ -218,6 +526,7 @@ public:
         nanoflann::KNNResultSet<double, PointId, point_count_t> resultSet(k2);
         resultSet.init(&output[0], &out_dist_sqr[0]);
         m_index.findNeighbors(resultSet, &pt[0], nanoflann::SearchParams());
+        toIds(output.data(), resultSet.size());
 
         // Perform the downsampling if a stride is provided.
         if (stride > 1)
@@ -242,6 +551,7 @@ public:
         pt.push_back(y);
         pt.push_back(z);
         m_index.findNeighbors(resultSet, &pt[0], nanoflann::SearchParams(10));
+        toIds(indices->data(), resultSet.size());
     }
 
     PointIdList radius(double x, double y, double z, double r) const
@@ -259,12 +569,54 @@ public:
             m_index.radiusSearch(&pt[0], r * r, ret_matches, params);
 
         for (std::size_t i = 0; i < count; ++i)
-            output.push_back(ret_matches[i].first);
+            output.push_back(m_snapshot.id(ret_matches[i].first));
         return output;
     }
 
+    // Find the k nearest neighbors of a query point.
+    std::size_t knn(const double *pt, point_count_t k, PointId *ids,
+        double *sqrDists) const
+    {
+        k = (std::min)(m_buf.size(), k);
+        nanoflann::KNNResultSet<double, PointId, point_count_t> resultSet(k);
+
+        resultSet.init(ids, sqrDists);
+        m_index.findNeighbors(resultSet, pt, nanoflann::SearchParams());
+        toIds(ids, resultSet.size());
+        return resultSet.size();
+    }
+
+    // Append the neighbors within a radius of a query point.
+    void radius(const double *pt, double r, PointIdList& ids,
+        std::vector<double>& sqrDists) const
+    {
+        std::vector<std::pair<std::size_t, double>> ret_matches;
+        nanoflann::SearchParams params;
+        params.sorted = true;
+
+        const std::size_t count =
+            m_index.radiusSearch(pt, r * r, ret_matches, params);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            ids.push_back(m_snapshot.id(ret_matches[i].first));
+            sqrDists.push_back(ret_matches[i].second);
+        }
+    }
+
 private:
+    // Convert tree positions to point IDs.
+    void toIds(PointId *ids, std::size_t count) const
+    {
+        if (m_snapshot.active())
+            for (std::size_t i = 0; i < count; ++i)
+                ids[i] = m_snapshot.id(ids[i]);
+    }
+
     const PointView& m_buf;
+    PointColumn<double> m_x;
+    PointColumn<double> m_y;
+    PointColumn<double> m_z;
+    KDSnapshot m_snapshot;
 
     typedef nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<
         double, KD3Impl, double>, KD3Impl, -1, std::size_t> KDTree;
@@ -275,20 +627,33 @@ private:
 class KDFlexImpl
 {
 public:
-    KDFlexImpl(const PointView& buf, const Dimension::IdList& dims) :
-        m_buf(buf), m_dims(dims),
+    KDFlexImpl(const PointView& buf, const Dimension::IdList& dims,
+            KDStorage storage) :
+        m_buf(buf), m_dims(dims), m_snapshot(storage),
         m_index(m_dims.size(), *this,
             nanoflann::KDTreeSingleIndexAdaptorParams(100))
-    {}
+    {
+        for (Dimension::Id dim : m_dims)
+            m_cols.push_back(buf.column<double>(dim));
+    }
 
     std::size_t kdtree_get_point_count() const
     {
         return m_buf.size();
     }
 
-    void build()
+    void build(std::size_t threads)
     {
-        m_index.buildIndex();
+        if (m_snapshot.active())
+        {
+            std::vector<const PointColumn<double> *> cols;
+            for (const PointColumn<double>& col : m_cols)
+                cols.push_back(&col);
+            m_snapshot.load(cols);
+        }
+        buildTree(m_index, threads);
+        if (m_snapshot.active())
+            m_snapshot.reorder(m_index.vind);
     }
 
     PointIdList neighbors(PointRef &point, point_count_t k, size_t stride) const
@@ -316,6 +681,7 @@ public:
         nanoflann::KNNResultSet<double, PointId, point_count_t> resultSet(k2);
         resultSet.init(&output[0], &out_dist_sqr[0]);
         m_index.findNeighbors(resultSet, &pt[0], nanoflann::SearchParams());
+        toIds(output.data(), resultSet.size());
 
         // Perform the downsampling if a stride is provided.
         if (stride > 1)
@@ -335,11 +701,8 @@ public:
         params.sorted = true;
 
         std::vector<double> pt;
-        for (auto const& dim : m_dims)
-        {
-            double val = m_buf.getFieldAs<double>(dim, idx);
-            pt.push_back(val);
-        }
+        for (auto const& col : m_cols)
+            pt.push_back(col[idx]);
 
         // Our distance metric is square distance, so we use the square of
         // the radius.
@@ -347,7 +710,7 @@ public:
             m_index.radiusSearch(pt.data(), r * r, ret_matches, params);
 
         for (std::size_t i = 0; i < count; ++i)
-            output.push_back(ret_matches[i].first);
+            output.push_back(m_snapshot.id(ret_matches[i].first));
         return output;
     }
 
@@ -356,16 +719,21 @@ public:
         if (idx >= m_buf.size())
             return 0.0;
 
-        return m_buf.getFieldAs<double>(m_dims[dim], idx);
+        if (m_snapshot.active())
+            return m_snapshot.get(idx, dim);
+        return m_cols[dim][idx];
     }
 
     inline double kdtree_distance(const double* p1, const PointId idx,
                                   size_t /*numDims*/) const
     {
+        if (m_snapshot.active())
+            return m_snapshot.distance(p1, idx);
+
         double result(0.0);
         for (size_t i = 0; i < m_dims.size(); ++i)
         {
-            double d = p1[i] - m_buf.getFieldAs<double>(m_dims[i], idx);
+            double d = p1[i] - m_cols[i][idx];
             result += d * d;
         }
 
@@ -381,7 +749,7 @@ public:
         {
             for (size_t j = 0; j < m_dims.size(); ++j)
             {
-                double val = m_buf.getFieldAs<double>(m_dims[j], 0);
+                double val = m_cols[j][0];
                 bb[j].low = val;
                 bb[j].high = val;
             }
@@ -390,7 +758,7 @@ public:
             {
                 for (size_t j = 0; j < m_dims.size(); ++j)
                 {
-                    double val = m_buf.getFieldAs<double>(m_dims[j], i);
+                    double val = m_cols[j][i];
                     if (val < bb[j].low)
                         bb[j].low = val;
                     if (val > bb[j].high)
@@ -402,8 +770,18 @@ public:
     }
 
 private:
+    // Convert tree positions to point IDs.
+    void toIds(PointId *ids, std::size_t count) const
+    {
+        if (m_snapshot.active())
+            for (std::size_t i = 0; i < count; ++i)
+                ids[i] = m_snapshot.id(ids[i]);
+    }
+
     const PointView& m_buf;
     const Dimension::IdList& m_dims;
+    std::vector<PointColumn<double>> m_cols;
+    KDSnapshot m_snapshot;
 
     typedef nanoflann::KDTreeSingleIndexAdaptor< nanoflann::L2_Simple_Adaptor<
         double, KDFlexImpl, double>, KDFlexImpl, -1, std::size_t> KDTree;
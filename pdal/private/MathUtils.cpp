@@ -40,6 +40,7 @@
 #include <pdal/PointView.hpp>
 #include <pdal/SpatialReference.hpp>
 #include <pdal/util/Bounds.hpp>
+#include <pdal/util/Executor.hpp>
 #include <pdal/util/Utils.hpp>
 #include <pdal/private/gdal/Raster.hpp>
 
@@ -255,79 +256,174 @@ Eigen::MatrixXd extendedLocalMinimum(const PointView& view, int rows, int cols,
     return ZImin;
 }
 
-void dilateDiamond(std::vector<double>& data, size_t rows, size_t cols, int iterations)
+namespace
 {
-    std::vector<double> out(data.size(), std::numeric_limits<double>::lowest());
-    std::array<size_t, 5> idx;
 
+// Apply the five-point cross structuring element 'iterations' times.
+// On a rectangular grid this is the same as applying a diamond of radius
+// 'iterations', but the cost grows with the radius.
+template<typename OP>
+void crossPasses(std::vector<double>& data, size_t rows, size_t cols,
+    int iterations, OP op, int threads)
+{
+    std::vector<double> out(data.size());
     for (int iter = 0; iter < iterations; ++iter)
     {
-        for (size_t col = 0; col < cols; ++col)
+        parallelRange(cols, (size_t)threads, [&](size_t begin, size_t end)
         {
-            size_t index = col*rows;
-            for (size_t row = 0; row < rows; ++row)
+            for (size_t col = begin; col < end; ++col)
             {
-                // Find the index into the vector of the current cell.  Then
-                // find the index of the cells to the right/left/above/below
-                // if they exist.
-                size_t j = 0;
-                idx[j++] = index+row;
-                if (row > 0)
-                    idx[j++] = idx[0]-1;
-                if (row < rows-1)
-                    idx[j++] = idx[0]+1;
-                if (col > 0)
-                    idx[j++] = idx[0]-rows;
-                if (col < cols-1)
-                    idx[j++] = idx[0]+rows;
-                // If the data at the test cell pos is greater than that
-                // from the last iteration, set the value to the maximum of
-                // the value of those cells.
-                for (size_t i = 0; i < j; ++i)
+                const double *in = data.data() + col * rows;
+                double *o = out.data() + col * rows;
+                for (size_t row = 0; row < rows; ++row)
                 {
-                    if (data[idx[i]] > out[index+row])
-                        out[index+row] = data[idx[i]];
+                    double v = in[row];
+                    if (row > 0)
+                        v = op(v, in[row - 1]);
+                    if (row < rows - 1)
+                        v = op(v, in[row + 1]);
+                    if (col > 0)
+                        v = op(v, in[row - rows]);
+                    if (col < cols - 1)
+                        v = op(v, in[row + rows]);
+                    o[row] = v;
                 }
             }
-        }
+        });
         data.swap(out);
     }
 }
 
-void erodeDiamond(std::vector<double>& data, size_t rows, size_t cols,
-    int iterations)
+// Replace each value of a line with the extreme of the values in a
+// centered window of 2 * half + 1 values (van Herk/Gil-Werman).  The line
+// is split into blocks of the window size and running extremes are
+// computed forward and backward in each block, so that any window is
+// covered by the backward run of one block and the forward run of the
+// next.  The cost per value doesn't depend on the size of the window.
+// Values past the ends of the line are treated as the identity.
+template<typename OP>
+void runningExtreme(double *line, size_t n, size_t half, double identity,
+    OP op, std::vector<double>& fwd, std::vector<double>& bwd)
 {
-    std::vector<double> out(data.size(), (std::numeric_limits<double>::max)());
-    std::array<size_t, 5> idx;
+    const size_t w = 2 * half + 1;
+    const size_t m = ((n + 2 * half + w - 1) / w) * w;
 
-    for (int iter = 0; iter < iterations; ++iter)
+    fwd.assign(m, identity);
+    std::copy(line, line + n, fwd.begin() + half);
+    bwd = fwd;
+    for (size_t b = 0; b < m; b += w)
     {
-        for (size_t col = 0; col < cols; ++col)
+        for (size_t i = b + 1; i < b + w; ++i)
+            fwd[i] = op(fwd[i], fwd[i - 1]);
+        for (size_t i = b + w - 1; i > b; --i)
+            bwd[i - 1] = op(bwd[i - 1], bwd[i]);
+    }
+
+    const double *f = fwd.data() + w - 1;
+    const double *r = bwd.data();
+    for (size_t k = 0; k < n; ++k)
+        line[k] = op(r[k], f[k]);
+}
+
+// Apply running extremes along all the diagonal lines of a column-major
+// grid.  When 'down' is true, lines go toward increasing columns and
+// rows.  Otherwise they go toward increasing columns and decreasing rows.
+template<typename OP>
+void diagonalPass(std::vector<double>& data, size_t rows, size_t cols,
+    size_t half, bool down, double identity, OP op, int threads)
+{
+    const size_t numLines = rows + cols - 1;
+    parallelRange(numLines, (size_t)threads, [&](size_t begin, size_t end)
+    {
+        std::vector<double> line, fwd, bwd;
+        for (size_t l = begin; l < end; ++l)
         {
-            size_t index = col*rows;
-            for (size_t row = 0; row < rows; ++row)
+            size_t row, col;
+            if (l < rows)
             {
-                size_t j = 0;
-                idx[j++] = index+row;
-                if (row > 0)
-                    idx[j++] = idx[0]-1;
-                if (row < rows-1)
-                    idx[j++] = idx[0]+1;
-                if (col > 0)
-                    idx[j++] = idx[0]-rows;
-                if (col < cols-1)
-                    idx[j++] = idx[0]+rows;
-                for (size_t i = 0; i < j; ++i)
-                {
-                    if (data[idx[i]] < out[index+row])
-                        out[index+row] = data[idx[i]];
-                }
+                row = l;
+                col = 0;
+            }
+            else
+            {
+                row = down ? 0 : rows - 1;
+                col = l - rows + 1;
             }
+            const size_t len = down ?
+                (std::min)(rows - row, cols - col) :
+                (std::min)(row + 1, cols - col);
+            const size_t step = down ? rows + 1 : rows - 1;
+            double *start = data.data() + col * rows + row;
+
+            line.resize(len);
+            for (size_t i = 0; i < len; ++i)
+                line[i] = start[i * step];
+            runningExtreme(line.data(), len, half, identity, op, fwd, bwd);
+            for (size_t i = 0; i < len; ++i)
+                start[i * step] = line[i];
         }
-        data.swap(out);
+    });
+}
+
+// Apply a diamond-shaped structuring element of the given radius.
+//
+// The diamond of radius r is the Minkowski sum of two diagonal segments
+// of half-length h = (r - 1) / 2 and a diamond of radius r - 2h (one or
+// two), so the operation is done as two diagonal running-extreme passes
+// followed by one or two cross passes.  The grid is padded with the
+// identity so that intermediate results outside the grid are available.
+template<typename OP>
+void diamond(std::vector<double>& data, size_t rows, size_t cols,
+    int radius, double identity, OP op, int threads)
+{
+    if (radius <= 0 || rows == 0 || cols == 0)
+        return;
+    if (radius <= 2)
+    {
+        crossPasses(data, rows, cols, radius, op, threads);
+        return;
+    }
+
+    const size_t half = (size_t)(radius - 1) / 2;
+    const int rest = radius - 2 * (int)half;
+    const size_t pad = half + rest;
+    const size_t prows = rows + 2 * pad;
+    const size_t pcols = cols + 2 * pad;
+
+    std::vector<double> padded(prows * pcols, identity);
+    for (size_t col = 0; col < cols; ++col)
+        std::copy(data.begin() + col * rows, data.begin() + (col + 1) * rows,
+            padded.begin() + (col + pad) * prows + pad);
+
+    diagonalPass(padded, prows, pcols, half, true, identity, op, threads);
+    diagonalPass(padded, prows, pcols, half, false, identity, op, threads);
+    crossPasses(padded, prows, pcols, rest, op, threads);
+
+    for (size_t col = 0; col < cols; ++col)
+    {
+        auto start = padded.begin() + (col + pad) * prows + pad;
+        std::copy(start, start + rows, data.begin() + col * rows);
     }
 }
 
+} // unnamed namespace
+
+void dilateDiamond(std::vector<double>& data, size_t rows, size_t cols,
+    int iterations, int threads)
+{
+    diamond(data, rows, cols, iterations,
+        std::numeric_limits<double>::lowest(),
+        [](double a, double b){ return (std::max)(a, b); }, threads);
+}
+
+void erodeDiamond(std::vector<double>& data, size_t rows, size_t cols,
+    int iterations, int threads)
+{
+    diamond(data, rows, cols, iterations,
+        (std::numeric_limits<double>::max)(),
+        [](double a, double b){ return (std::min)(a, b); }, threads);
+}
+
 Eigen::MatrixXd pointViewToEigen(const PointView& view)
 {
     Eigen::MatrixXd matrix(view.size(), 3);
@@ -0,0 +1,446 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "PointSort.hpp"
+
+#include <pdal/PointColumn.hpp>
+#include <pdal/util/Executor.hpp>
+
+#include <array>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+
+namespace pdal
+{
+namespace sort
+{
+
+namespace
+{
+
+struct Entry
+{
+    uint64_t key;
+    PointId id;
+};
+
+// Don't split work into parts smaller than this.
+const std::size_t MinPartSize = 1 << 16;
+
+// Run func(part) for each part, using up to 'threads' threads.
+template<typename FUNC>
+void forParts(std::size_t numParts, std::size_t threads, FUNC func)
+{
+    if (numParts == 1)
+    {
+        func((std::size_t)0);
+        return;
+    }
+
+    TaskGroup group(threads);
+    for (std::size_t part = 0; part < numParts; ++part)
+        group.add([&func, part](){ func(part); });
+    group.wait();
+}
+
+// Map a value to an unsigned integer that sorts in the same order.
+template<typename T>
+typename std::enable_if<std::is_unsigned<T>::value, uint64_t>::type
+radixKey(T t)
+{
+    return t;
+}
+
+template<typename T>
+typename std::enable_if<std::is_signed<T>::value &&
+    std::is_integral<T>::value, uint64_t>::type
+radixKey(T t)
+{
+    using U = typename std::make_unsigned<T>::type;
+
+    // Flipping the sign bit orders negative values before positive ones.
+    const U signBit = (U)1 << (sizeof(T) * 8 - 1);
+    return (U)((U)t ^ signBit);
+}
+
+template<typename T>
+typename std::enable_if<std::is_floating_point<T>::value, uint64_t>::type
+radixKey(T t)
+{
+    using U = typename std::conditional<sizeof(T) == 4,
+        uint32_t, uint64_t>::type;
+
+    // -0.0 and 0.0 compare equal, so they get the same key.
+    if (t == 0)
+        t = 0;
+
+    U u;
+    std::memcpy(&u, &t, sizeof(T));
+
+    // Positive values sort above negative ones.  Negative values sort in
+    // reverse order of their magnitude.
+    const U signBit = (U)1 << (sizeof(T) * 8 - 1);
+    return (u & signBit) ? (U)~u : (U)(u | signBit);
+}
+
+// Set the keys of the entries to the values of a dimension of the points
+// they refer to.
+template<typename T>
+void extract(const PointView& view, Dimension::Id dim, bool descending,
+    std::size_t bytes, std::vector<Entry>& entries, std::size_t threads)
+{
+    PointColumn<T> col = view.column<T>(dim);
+    const uint64_t mask = (bytes == 8) ? ~(uint64_t)0 :
+        (((uint64_t)1 << (bytes * 8)) - 1);
+
+    parallelRange(entries.size(), threads,
+        [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                uint64_t key = radixKey(col[entries[i].id]);
+                entries[i].key = descending ? (~key & mask) : key;
+            }
+        });
+}
+
+void extract(const PointView& view, Dimension::Id dim,
+    Dimension::Type type, bool descending, std::vector<Entry>& entries,
+    std::size_t threads)
+{
+    const std::size_t bytes = Dimension::size(type);
+
+    switch (type)
+    {
+    case Dimension::Type::Unsigned8:
+        extract<uint8_t>(view, dim, descending, bytes, entries, threads);
+        break;
+    case Dimension::Type::Unsigned16:
+        extract<uint16_t>(view, dim, descending, bytes, entries, threads);
+        break;
+    case Dimension::Type::Unsigned32:
+        extract<uint32_t>(view, dim, descending, bytes, entries, threads);
+        break;
+    case Dimension::Type::Unsigned64:
+        extract<uint64_t>(view, dim, descending, bytes, entries, threads);
+        break;
+    case Dimension::Type::Signed8:
+        extract<int8_t>(view, dim, descending, bytes, entries, threads);
+        break;
+    case Dimension::Type::Signed16:
+        extract<int16_t>(view, dim, descending, bytes, entries, threads);
+        break;
+    case Dimension::Type::Signed32:
+        extract<int32_t>(view, dim, descending, bytes, entries, threads);
+        break;
+    case Dimension::Type::Signed64:
+        extract<int64_t>(view, dim, descending, bytes, entries, threads);
+        break;
+    case Dimension::Type::Float:
+        extract<float>(view, dim, descending, bytes, entries, threads);
+        break;
+    case Dimension::Type::Double:
+        extract<double>(view, dim, descending, bytes, entries, threads);
+        break;
+    case Dimension::Type::None:
+        break;
+    }
+}
+
+// Stable sort of the entries by their keys, one byte at a time.  Each pass
+// counts the values of the byte in each part of the input, then each part
+// scatters its entries to the positions that the counts determine.  Bytes
+// that have the same value for every entry are skipped.
+void radixSort(std::vector<Entry>& entries, std::vector<Entry>& buf,
+    std::size_t bytes, std::size_t threads)
+{
+    using Counts = std::array<std::size_t, 256>;
+
+    const std::size_t count = entries.size();
+    const std::size_t numParts =
+        (std::max)((std::size_t)1, (std::min)(threads, count / MinPartSize));
+    std::vector<Counts> counts(numParts);
+
+    auto partBegin = [count, numParts](std::size_t part)
+        { return count * part / numParts; };
+
+    for (std::size_t byte = 0; byte < bytes; ++byte)
+    {
+        const int shift = (int)(byte * 8);
+
+        forParts(numParts, threads, [&](std::size_t part)
+        {
+            Counts& c = counts[part];
+            c.fill(0);
+            const std::size_t end = partBegin(part + 1);
+            for (std::size_t i = partBegin(part); i < end; ++i)
+                c[(entries[i].key >> shift) & 0xFF]++;
+        });
+
+        // Turn the counts into the position at which each part writes
+        // its first entry with each value of the byte.
+        bool skip = false;
+        std::size_t pos = 0;
+        for (std::size_t value = 0; value < 256; ++value)
+        {
+            std::size_t total = 0;
+            for (Counts& c : counts)
+            {
+                std::size_t n = c[value];
+                c[value] = pos + total;
+                total += n;
+            }
+            if (total == count)
+                skip = true;
+            pos += total;
+        }
+        if (skip)
+            continue;
+
+        forParts(numParts, threads, [&](std::size_t part)
+        {
+            Counts& c = counts[part];
+            const std::size_t end = partBegin(part + 1);
+            for (std::size_t i = partBegin(part); i < end; ++i)
+                buf[c[(entries[i].key >> shift) & 0xFF]++] = entries[i];
+        });
+        entries.swap(buf);
+    }
+}
+
+// Extract the point IDs of sorted entries.
+std::vector<PointId> pointIds(const std::vector<Entry>& entries,
+    std::size_t threads)
+{
+    std::vector<PointId> ids(entries.size());
+    parallelRange(entries.size(), threads,
+        [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+                ids[i] = entries[i].id;
+        });
+    return ids;
+}
+
+// Spread the low 32 bits of a value to the even bits of the result.
+uint64_t spread2(uint64_t v)
+{
+    v &= 0xFFFFFFFFULL;
+    v = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+    v = (v | (v << 8)) & 0x00FF00FF00FF00FFULL;
+    v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    v = (v | (v << 2)) & 0x3333333333333333ULL;
+    v = (v | (v << 1)) & 0x5555555555555555ULL;
+    return v;
+}
+
+// Spread the low 21 bits of a value to every third bit of the result.
+uint64_t spread3(uint64_t v)
+{
+    v &= 0x1FFFFFULL;
+    v = (v | (v << 32)) & 0x001F00000000FFFFULL;
+    v = (v | (v << 16)) & 0x001F0000FF0000FFULL;
+    v = (v | (v << 8)) & 0x100F00F00F00F00FULL;
+    v = (v | (v << 4)) & 0x10C30C30C30C30C3ULL;
+    v = (v | (v << 2)) & 0x1249249249249249ULL;
+    return v;
+}
+
+// Interleave the bits of quantized coordinates.  The bits of the first
+// coordinate are the most significant at each level.
+uint64_t interleave(const uint32_t *q, int dims)
+{
+    if (dims == 2)
+        return (spread2(q[0]) << 1) | spread2(q[1]);
+    return (spread3(q[0]) << 2) | (spread3(q[1]) << 1) | spread3(q[2]);
+}
+
+// Transform quantized coordinates in place so that interleaving them yields
+// the Hilbert index.  See J. Skilling, "Programming the Hilbert curve",
+// AIP Conference Proceedings 707 (2004).
+void hilbertTranspose(uint32_t *q, int dims, int bits)
+{
+    const uint32_t m = (uint32_t)1 << (bits - 1);
+
+    // Inverse undo.
+    for (uint32_t b = m; b > 1; b >>= 1)
+    {
+        const uint32_t p = b - 1;
+        for (int i = 0; i < dims; ++i)
+        {
+            if (q[i] & b)
+                q[0] ^= p;
+            else
+            {
+                uint32_t t = (q[0] ^ q[i]) & p;
+                q[0] ^= t;
+                q[i] ^= t;
+            }
+        }
+    }
+
+    // Gray encode.
+    for (int i = 1; i < dims; ++i)
+        q[i] ^= q[i - 1];
+    uint32_t t = 0;
+    for (uint32_t b = m; b > 1; b >>= 1)
+        if (q[dims - 1] & b)
+            t ^= b - 1;
+    for (int i = 0; i < dims; ++i)
+        q[i] ^= t;
+}
+
+} // unnamed namespace
+
+std::vector<PointId> order(const PointView& view,
+    const std::vector<PointView::SortKey>& keys, std::size_t threads)
+{
+    const std::size_t count = view.size();
+    PointLayoutPtr layout = view.layout();
+
+    std::vector<Entry> entries(count);
+    std::vector<Entry> buf;
+    for (PointId i = 0; i < count; ++i)
+        entries[i].id = i;
+
+    // Sorting by the least significant key first and then by each more
+    // significant key in turn leaves the entries ordered by all of them
+    // since each sort is stable.
+    for (auto ki = keys.rbegin(); ki != keys.rend(); ++ki)
+    {
+        if (!layout->hasDim(ki->dim))
+            continue;
+
+        Dimension::Type type = layout->dimType(ki->dim);
+        if (type == Dimension::Type::None)
+            continue;
+        if (buf.empty())
+            buf.resize(count);
+        extract(view, ki->dim, type, ki->descending, entries, threads);
+        radixSort(entries, buf, Dimension::size(type), threads);
+    }
+
+    return pointIds(entries, threads);
+}
+
+std::vector<PointId> spatialOrder(const PointView& view,
+    PointView::SpatialCurve curve, bool is3d, std::size_t threads)
+{
+    using namespace Dimension;
+
+    const std::size_t count = view.size();
+    const int dims = is3d ? 3 : 2;
+    const int bits = is3d ? 21 : 32;
+    const Id ids[] = { Id::X, Id::Y, Id::Z };
+
+    std::vector<PointColumn<double>> cols;
+    for (int d = 0; d < dims; ++d)
+        cols.push_back(view.column<double>(ids[d]));
+
+    // Find the bounds of the points.
+    std::mutex mutex;
+    double lo[3] = { (std::numeric_limits<double>::max)(),
+        (std::numeric_limits<double>::max)(),
+        (std::numeric_limits<double>::max)() };
+    double hi[3] = { (std::numeric_limits<double>::lowest)(),
+        (std::numeric_limits<double>::lowest)(),
+        (std::numeric_limits<double>::lowest)() };
+    parallelRange(count, threads, [&](std::size_t begin, std::size_t end)
+    {
+        double l[3] = { lo[0], lo[1], lo[2] };
+        double h[3] = { hi[0], hi[1], hi[2] };
+        for (std::size_t i = begin; i < end; ++i)
+            for (int d = 0; d < dims; ++d)
+            {
+                double v = cols[d][i];
+                l[d] = (std::min)(l[d], v);
+                h[d] = (std::max)(h[d], v);
+            }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int d = 0; d < dims; ++d)
+        {
+            lo[d] = (std::min)(lo[d], l[d]);
+            hi[d] = (std::max)(hi[d], h[d]);
+        }
+    });
+
+    // Morton ordering normalizes each axis to its own range, as the
+    // original comparison-based ordering did.  Hilbert ordering uses the
+    // same scale for all axes so that cells are cubes (squares).
+    const double maxQ = (double)(((uint64_t)1 << bits) - 1);
+    double scale[3] = { 0, 0, 0 };
+    if (curve == PointView::SpatialCurve::Morton)
+    {
+        for (int d = 0; d < dims; ++d)
+            if (hi[d] > lo[d])
+                scale[d] = maxQ / (hi[d] - lo[d]);
+    }
+    else
+    {
+        double range = 0;
+        for (int d = 0; d < dims; ++d)
+            range = (std::max)(range, hi[d] - lo[d]);
+        for (int d = 0; d < dims; ++d)
+            scale[d] = (range > 0) ? maxQ / range : 0;
+    }
+
+    std::vector<Entry> entries(count);
+    parallelRange(count, threads, [&](std::size_t begin, std::size_t end)
+    {
+        uint32_t q[3];
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            for (int d = 0; d < dims; ++d)
+            {
+                double v = (cols[d][i] - lo[d]) * scale[d];
+                q[d] = (uint32_t)(std::min)(maxQ, (std::max)(0.0, v));
+            }
+            if (curve == PointView::SpatialCurve::Hilbert)
+                hilbertTranspose(q, dims, bits);
+            entries[i].key = interleave(q, dims);
+            entries[i].id = i;
+        }
+    });
+
+    std::vector<Entry> buf(count);
+    radixSort(entries, buf, sizeof(uint64_t), threads);
+
+    return pointIds(entries, threads);
+}
+
+} // namespace sort
+} // namespace pdal
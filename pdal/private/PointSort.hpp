@@ -0,0 +1,82 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <pdal/PointView.hpp>
+
+#include <vector>
+
+namespace pdal
+{
+namespace sort
+{
+
+/**
+  Compute the stable order of the points of a view by one or more keys.
+
+  The values of each key dimension are read once into packed (key, PointId)
+  pairs, mapped to unsigned integers that sort in the same order as the
+  values, and sorted with a least-significant-digit radix sort.  Keys are
+  applied from the least significant to the most significant, so the
+  result is ordered by the first key, then the second, and so on.
+  Keys whose dimension isn't in the view's layout are ignored.
+
+  \param view  View whose points are sorted.
+  \param keys  Sort keys, most significant first.
+  \param threads  Number of threads used to sort.
+  \return  Indices of the view's points in sorted order.
+*/
+std::vector<PointId> order(const PointView& view,
+    const std::vector<PointView::SortKey>& keys, std::size_t threads = 1);
+
+/**
+  Compute the order of the points of a view along a space-filling curve.
+
+  X and Y (and Z, for 3D curves) are quantized over the bounds of the view
+  to 32 (21) bits per axis using the same scale for each axis.  The
+  quantized values are combined into 64-bit Morton or Hilbert keys, which
+  are then radix-sorted.  Points with equal keys keep their order.
+
+  \param view  View whose points are sorted.
+  \param curve  Space-filling curve.
+  \param is3d  Whether to include Z in the keys.
+  \param threads  Number of threads used to sort.
+  \return  Indices of the view's points in sorted order.
+*/
+std::vector<PointId> spatialOrder(const PointView& view,
+    PointView::SpatialCurve curve, bool is3d, std::size_t threads = 1);
+
+} // namespace sort
+} // namespace pdal
@@ -30,19 +30,46 @@
 
 #include "SrsTransform.hpp"
 #include <pdal/SpatialReference.hpp>
+#include <pdal/util/Executor.hpp>
+
+#include <algorithm>
 
 #include <ogr_spatialref.h>
 
 namespace pdal
 {
 
+namespace
+{
+
+// Transform 'count' points, setting a success flag for each.  Depending on
+// the GDAL version, Transform() returns false when any point fails or only
+// when all points fail, so the result is taken from the per-point flags
+// rather than from the return value.  Returns true if any point was
+// transformed.
+bool transformPoints(OGRCoordinateTransformation *xform, size_t count,
+    double *x, double *y, double *z, int *success)
+{
+    std::fill(success, success + count, 0);
+    if (!xform || count == 0)
+        return false;
+
+    xform->Transform(count, x, y, z, nullptr, success);
+    return std::any_of(success, success + count, [](int s){ return s; });
+}
+
+} // unnamed namespace
+
 SrsTransform::SrsTransform()
 {}
 
+// Cloning keeps the axis mapping and any explicit coordinate operation,
+// which are lost when the transform is rebuilt from the source and
+// target SRSes.
 SrsTransform::SrsTransform(const SrsTransform& src)
 {
     if (src.valid())
-        set(*(src.m_transform->GetSourceCS()), *(src.m_transform->GetTargetCS()));
+        m_transform.reset(src.m_transform->Clone());
 }
 
 
@@ -117,6 +144,16 @@ SrsTransform::SrsTransform(const SpatialReference& src,
     m_transform.reset(OGRCreateCoordinateTransformation(&srcRef, &dstRef));
 }
 
+SrsTransform::SrsTransform(const std::string& coordOperation, bool reverse)
+{
+    OGRCoordinateTransformationOptions options;
+    options.SetCoordinateOperation(coordOperation.c_str(), reverse);
+    OGRSpatialReference nullSrs("");
+    m_transform.reset(
+        OGRCreateCoordinateTransformation(&nullSrs, &nullSrs, options));
+}
+
+
 void SrsTransform::set(const SpatialReference& src, const SpatialReference& dst)
 {
     OGRSpatialReference osrSrc(src.getWKT2().data());
@@ -158,11 +195,71 @@ bool SrsTransform::transform(double& x, double& y, double& z) const
 bool SrsTransform::transform(std::vector<double>& x, std::vector<double>& y,
     std::vector<double>& z) const
 {
-    if (x.size() != y.size() && y.size() != z.size())
+    if (x.size() != y.size() || y.size() != z.size())
+        throw pdal_error("SrsTransform::called with vectors of different "
+            "sizes.");
+    return m_transform &&
+        m_transform->Transform(x.size(), x.data(), y.data(), z.data());
+}
+
+
+bool SrsTransform::transform(std::vector<double>& x, std::vector<double>& y,
+    std::vector<double>& z, std::vector<int>& success) const
+{
+    if (x.size() != y.size() || y.size() != z.size())
+        throw pdal_error("SrsTransform::called with vectors of different "
+            "sizes.");
+    success.resize(x.size());
+    return transformPoints(m_transform.get(), x.size(), x.data(), y.data(),
+        z.data(), success.data());
+}
+
+
+bool SrsTransform::transform(size_t count, double *x, double *y, double *z,
+    int *success) const
+{
+    return transformPoints(m_transform.get(), count, x, y, z, success);
+}
+
+
+bool transform(const std::vector<SrsTransform>& transforms,
+    std::vector<double>& x, std::vector<double>& y, std::vector<double>& z,
+    std::vector<int>& success)
+{
+    // Don't split work into parts too small to be worth a task.
+    const size_t MinPartSize = 4096;
+
+    if (x.size() != y.size() || y.size() != z.size())
         throw pdal_error("SrsTransform::called with vectors of different "
             "sizes.");
-    int err = m_transform->Transform(x.size(), x.data(), y.data(), z.data());
-    return (err == OGRERR_NONE);
+    success.resize(x.size());
+    if (transforms.empty())
+    {
+        std::fill(success.begin(), success.end(), 0);
+        return false;
+    }
+
+    size_t parts = (std::min)(transforms.size(),
+        (x.size() + MinPartSize - 1) / MinPartSize);
+    if (parts <= 1)
+        return transforms[0].transform(x.size(), x.data(), y.data(), z.data(),
+            success.data());
+
+    const size_t partSize = (x.size() + parts - 1) / parts;
+    std::vector<char> ok(parts, 0);
+    TaskGroup group(parts);
+    for (size_t part = 0; part < parts; ++part)
+    {
+        const size_t start = part * partSize;
+        const size_t count = (std::min)(partSize, x.size() - start);
+        group.add([&, part, start, count]()
+        {
+            ok[part] = transforms[part].transform(count, x.data() + start,
+                y.data() + start, z.data() + start, success.data() + start);
+        });
+    }
+    group.wait();
+    return std::any_of(ok.begin(), ok.end(), [](char c){ return c; });
 }
 
 } // namespace pdal
@@ -52,6 +52,9 @@ public:
     SrsTransform(const SpatialReference& src, const SpatialReference& dst);
     SrsTransform(const SpatialReference& src, std::vector<int> srcOrder,
                  const SpatialReference& dst, std::vector<int> dstOrder);
+    /// Object that performs a PROJ coordinate operation (pipeline string,
+    /// WKT2 coordinate operation or URN).
+    SrsTransform(const std::string& coordOperation, bool reverse);
     ~SrsTransform();
 
 
@@ -80,6 +83,27 @@ public:
     bool transform(std::vector<double>& x, std::vector<double>& y,
         std::vector<double>& z) const;
 
+    /// Transform a set of points in place, noting the points that
+    /// couldn't be transformed.
+    /// \param x  X coordinates
+    /// \param y  Y coordinates
+    /// \param z  Z coordinates
+    /// \param success  Set to non-zero for each point that was transformed.
+    /// \return  True if any point was transformed successfully
+    bool transform(std::vector<double>& x, std::vector<double>& y,
+        std::vector<double>& z, std::vector<int>& success) const;
+
+    /// Transform \count points in place, noting the points that
+    /// couldn't be transformed.
+    /// \param count  Number of points.
+    /// \param x  X coordinates
+    /// \param y  Y coordinates
+    /// \param z  Z coordinates
+    /// \param success  Set to non-zero for each point that was transformed.
+    /// \return  True if any point was transformed successfully
+    bool transform(size_t count, double *x, double *y, double *z,
+        int *success) const;
+
     /// Determine if this represents a valid transform.
     /// \return  Whether the transform is valid or not.
     bool valid() const
@@ -89,5 +113,18 @@ private:
     std::unique_ptr<OGRCoordinateTransformation> m_transform;
 };
 
+/// Transform a set of points in place, splitting the points among the
+/// transforms.  Coordinate transformations aren't thread-safe, so each
+/// transform is used by a single thread.
+/// \param transforms  Copies of a transform, one per thread.
+/// \param x  X coordinates
+/// \param y  Y coordinates
+/// \param z  Z coordinates
+/// \param success  Set to non-zero for each point that was transformed.
+/// \return  True if any point was transformed successfully
+PDAL_DLL bool transform(const std::vector<SrsTransform>& transforms,
+    std::vector<double>& x, std::vector<double>& y, std::vector<double>& z,
+    std::vector<int>& success);
+
 } // namespace pdal
 
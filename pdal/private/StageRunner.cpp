@@ -35,6 +35,7 @@
 #include "StageRunner.hpp"
 
 #include <pdal/Filter.hpp>
+#include <pdal/util/Executor.hpp>
 
 namespace pdal
 {
@@ -51,7 +52,7 @@ PointViewPtr StageRunner::keeps()
     return m_keeps;
 }
 
-// For now this is all synchronous
+// Run the stage on the view in the calling thread.
 void StageRunner::run()
 {
     point_count_t keepSize = m_keeps->size();
@@ -81,8 +82,30 @@ void StageRunner::run()
     m_viewSet.insert(m_skips);
 }
 
+// Queue the run on a task group.  Any exception thrown by the stage is
+// captured and rethrown from wait().
+void StageRunner::run(TaskGroup& group)
+{
+    auto promise = std::make_shared<std::promise<void>>();
+    m_done = promise->get_future();
+    group.add([this, promise]()
+    {
+        try
+        {
+            run();
+            promise->set_value();
+        }
+        catch (...)
+        {
+            promise->set_exception(std::current_exception());
+        }
+    });
+}
+
 PointViewSet StageRunner::wait()
 {
+    if (m_done.valid())
+        m_done.get();
     return m_viewSet;
 }
 
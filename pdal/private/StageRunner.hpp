@@ -36,10 +36,13 @@
 
 #include <pdal/PointView.hpp>
 
+#include <future>
+
 namespace pdal
 {
 
 class Stage;
+class TaskGroup;
 
 class StageRunner
 {
@@ -47,6 +50,7 @@ public:
     StageRunner(Stage *s, PointViewPtr view);
 
     void run();
+    void run(TaskGroup& group);
     PointViewPtr keeps();
     PointViewSet wait();
 
@@ -55,6 +59,7 @@ private:
     PointViewPtr m_keeps;
     PointViewPtr m_skips;
     PointViewSet m_viewSet;
+    std::future<void> m_done;
 };
 typedef std::shared_ptr<StageRunner> StageRunnerPtr;
 
@@ -478,7 +478,7 @@ void Raster::pixelToCoord(int col, int row, std::array<double, 2>& output) const
   \param[out] line  Raster line (row) position.
 */
 bool Raster::getPixelAndLinePosition(double x, double y,
-    int32_t& pixel, int32_t& line)
+    int32_t& pixel, int32_t& line) const
 {
     pixel = (int32_t)std::floor(m_inverseTransform[0] +
         (m_inverseTransform[1] * x) + (m_inverseTransform[2] * y));
@@ -594,6 +594,11 @@ GDALError Raster::read(int band, int x, int y, int width, int height, std::vecto
     GDALRasterBandH b = GDALGetRasterBand(m_ds, band + 1);
     CPLErr readResult = GDALRasterIO(b, GF_Read, x, y, validWidth, validHeight,
         data.data(), validWidth, validHeight, GDT_Float64, nPixelSpace, nLineSpace);
+    if (readResult != CE_None)
+    {
+        m_errorMsg = "Unable to read block for raster '" + m_filename + "'.";
+        return GDALError::CantReadBlock;
+    }
 
     return GDALError::None;
 }
@@ -546,6 +546,19 @@ public:
 
     void getBlockSize(int band, int &xSize, int &ySize) const;
 
+    /**
+      Compute the raster pixel and line (column and row) that contain a
+      geo-located position.
+
+      \param x  X position
+      \param y  Y position
+      \param[out] pixel  Raster column.
+      \param[out] line  Raster row.
+      \return  Whether the position is inside the raster.
+    */
+    bool getPixelAndLinePosition(double x, double y,
+        int32_t& pixel, int32_t& line) const;
+
 private:
     std::string m_filename;
 
@@ -566,8 +579,6 @@ private:
     mutable std::vector<pdal::Dimension::Type> m_types;
 
     GDALError validateType(Dimension::Type& type, GDALDriver *driver);
-    bool getPixelAndLinePosition(double x, double y,
-        int32_t& pixel, int32_t& line);
     GDALError computePDALDimensionTypes();
 };
 
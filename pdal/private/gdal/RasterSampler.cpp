@@ -0,0 +1,202 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "RasterSampler.hpp"
+#include "Raster.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace pdal
+{
+namespace gdal
+{
+
+namespace
+{
+
+// Block keys hold the band number and the block's column and row.
+const int KeyBits = 24;
+const uint64_t KeyMask = (1ULL << KeyBits) - 1;
+
+} // unnamed namespace
+
+RasterSampler::RasterSampler(Raster& raster, size_t cacheSize) :
+    m_raster(raster), m_cacheSize(cacheSize), m_cachedBytes(0),
+    m_blocksRead(0)
+{
+    for (int band = 0; band < m_raster.bandCount(); ++band)
+    {
+        BandInfo info;
+        m_raster.getBlockSize(band, info.blockWidth, info.blockHeight);
+        if (info.blockWidth <= 0 || info.blockHeight <= 0)
+        {
+            info.blockWidth = m_raster.width();
+            info.blockHeight = 1;
+        }
+        m_bands.push_back(info);
+    }
+}
+
+
+RasterSampler::~RasterSampler()
+{}
+
+
+bool RasterSampler::validBand(int band) const
+{
+    return band >= 1 && band <= (int)m_bands.size();
+}
+
+
+uint64_t RasterSampler::blockKey(int band, int32_t pixel, int32_t line) const
+{
+    const BandInfo& info = m_bands[band - 1];
+    uint64_t col = (uint64_t)(pixel / info.blockWidth);
+    uint64_t row = (uint64_t)(line / info.blockHeight);
+    return ((uint64_t)band << (2 * KeyBits)) | (row << KeyBits) | col;
+}
+
+
+// Find a block in the cache or read it from the raster, evicting the
+// least-recently-used blocks to make room.
+const RasterSampler::Block *RasterSampler::fetch(int band, uint64_t key)
+{
+    auto it = m_index.find(key);
+    if (it != m_index.end())
+    {
+        m_blocks.splice(m_blocks.begin(), m_blocks, it->second);
+        return &m_blocks.front();
+    }
+
+    const BandInfo& info = m_bands[band - 1];
+    const int col = (int)(key & KeyMask);
+    const int row = (int)((key >> KeyBits) & KeyMask);
+    const size_t bytes =
+        (size_t)info.blockWidth * info.blockHeight * sizeof(double);
+
+    while (m_blocks.size() && m_cachedBytes + bytes > m_cacheSize)
+    {
+        m_cachedBytes -= m_blocks.back().data.size() * sizeof(double);
+        m_index.erase(m_blocks.back().key);
+        m_blocks.pop_back();
+    }
+
+    Block block;
+    block.key = key;
+    if (m_raster.read(band - 1, col * info.blockWidth, row * info.blockHeight,
+            info.blockWidth, info.blockHeight, block.data) != GDALError::None)
+        return nullptr;
+    m_blocksRead++;
+
+    m_blocks.push_front(std::move(block));
+    m_index[key] = m_blocks.begin();
+    m_cachedBytes += bytes;
+    return &m_blocks.front();
+}
+
+
+double RasterSampler::value(const Block& block, int band, int32_t pixel,
+    int32_t line) const
+{
+    const BandInfo& info = m_bands[band - 1];
+    const size_t col = (size_t)(pixel % info.blockWidth);
+    const size_t row = (size_t)(line % info.blockHeight);
+    return block.data[row * info.blockWidth + col];
+}
+
+
+bool RasterSampler::sample(double x, double y, int band, double& value)
+{
+    int32_t pixel, line;
+    if (!validBand(band) ||
+            !m_raster.getPixelAndLinePosition(x, y, pixel, line))
+        return false;
+
+    const Block *block = fetch(band, blockKey(band, pixel, line));
+    if (!block)
+        return false;
+    value = this->value(*block, band, pixel, line);
+    return true;
+}
+
+
+void RasterSampler::sample(const std::vector<double>& x,
+    const std::vector<double>& y, const std::vector<int>& bands,
+    std::vector<double>& values, std::vector<char>& valid)
+{
+    const size_t count = x.size();
+    const size_t numBands = bands.size();
+    values.resize(count * numBands);
+    valid.assign(count, 0);
+
+    for (int band : bands)
+        if (!validBand(band))
+            return;
+
+    std::vector<int32_t> pixels(count);
+    std::vector<int32_t> lines(count);
+    for (size_t i = 0; i < count; ++i)
+        valid[i] = m_raster.getPixelAndLinePosition(x[i], y[i],
+            pixels[i], lines[i]);
+
+    // Order the lookups by block so that each block is fetched once.
+    std::vector<std::pair<uint64_t, size_t>> order;
+    order.reserve(count);
+    for (size_t b = 0; b < numBands; ++b)
+    {
+        order.clear();
+        for (size_t i = 0; i < count; ++i)
+            if (valid[i])
+                order.emplace_back(blockKey(bands[b], pixels[i], lines[i]),
+                    i);
+        std::sort(order.begin(), order.end());
+
+        const Block *block = nullptr;
+        for (size_t j = 0; j < order.size(); ++j)
+        {
+            const size_t i = order[j].second;
+            if (j == 0 || order[j].first != order[j - 1].first)
+                block = fetch(bands[b], order[j].first);
+            if (block)
+                values[i * numBands + b] =
+                    value(*block, bands[b], pixels[i], lines[i]);
+            else
+                valid[i] = 0;
+        }
+    }
+}
+
+} // namespace gdal
+} // namespace pdal
@@ -0,0 +1,139 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include <pdal/pdal_internal.hpp>
+
+namespace pdal
+{
+namespace gdal
+{
+
+class Raster;
+
+/*
+  Samples the bands of a raster at geo-located positions.  Whole raster
+  blocks are read and kept in an LRU cache limited by memory use, so that
+  lookups of nearby positions don't each cause a raster read.  Batches of
+  lookups are ordered by block so that each block is read once per batch.
+*/
+class PDAL_DLL RasterSampler
+{
+public:
+    /// Default limit on the memory used by cached blocks (bytes).
+    static const size_t DefaultCacheSize = 256 * 1024 * 1024;
+
+    /**
+      Create a sampler.
+
+      \param raster  Open raster to sample.  Must remain open as long as
+        the sampler is used.
+      \param cacheSize  Limit on the memory used by cached blocks (bytes).
+        At least one block is always cached.
+    */
+    RasterSampler(Raster& raster, size_t cacheSize = DefaultCacheSize);
+    ~RasterSampler();
+
+    RasterSampler(const RasterSampler&) = delete;
+    RasterSampler& operator=(const RasterSampler&) = delete;
+
+    /**
+      Sample a band at a position.
+
+      \param x  X position
+      \param y  Y position
+      \param band  Band number.  Band numbers start at 1.
+      \param[out] value  Value of the raster cell containing the position.
+      \return  Whether the position is in the raster and the cell could
+        be read.
+    */
+    bool sample(double x, double y, int band, double& value);
+
+    /**
+      Sample bands at a set of positions.  Lookups are sorted by block
+      before the raster is read.
+
+      \param x  X positions
+      \param y  Y positions
+      \param bands  Band numbers to sample.  Band numbers start at 1.
+      \param[out] values  Value of band \c b at position \c i is stored at
+        <tt>values[i * bands.size() + b]</tt>.
+      \param[out] valid  Set to non-zero for each position where all the
+        bands could be sampled.
+    */
+    void sample(const std::vector<double>& x, const std::vector<double>& y,
+        const std::vector<int>& bands, std::vector<double>& values,
+        std::vector<char>& valid);
+
+    /// Number of raster blocks that have been read.
+    size_t blocksRead() const
+        { return m_blocksRead; }
+
+private:
+    struct Block
+    {
+        uint64_t key;
+        std::vector<double> data;
+    };
+    using BlockList = std::list<Block>;
+
+    struct BandInfo
+    {
+        int blockWidth;
+        int blockHeight;
+    };
+
+    Raster& m_raster;
+    size_t m_cacheSize;
+    size_t m_cachedBytes;
+    size_t m_blocksRead;
+    std::vector<BandInfo> m_bands;
+    BlockList m_blocks;     // Most recently used first.
+    std::unordered_map<uint64_t, BlockList::iterator> m_index;
+
+    bool validBand(int band) const;
+    uint64_t blockKey(int band, int32_t pixel, int32_t line) const;
+    const Block *fetch(int band, uint64_t key);
+    double value(const Block& block, int band, int32_t pixel,
+        int32_t line) const;
+};
+
+} // namespace gdal
+} // namespace pdal
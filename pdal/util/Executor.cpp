@@ -0,0 +1,309 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "Executor.hpp"
+#include "Utils.hpp"
+
+namespace pdal
+{
+
+namespace
+{
+
+// The executor and worker index of the calling thread, if it's a worker.
+thread_local Executor *t_executor = nullptr;
+thread_local std::size_t t_index = 0;
+
+std::mutex g_globalMutex;
+std::size_t g_globalThreads = 0;
+std::unique_ptr<Executor> g_global;
+
+} // unnamed namespace
+
+Executor::Executor(std::size_t numThreads) : m_pending(0), m_sleeping(0),
+    m_next(0), m_stop(false)
+{
+    numThreads = (std::max)(numThreads, (std::size_t)1);
+    for (std::size_t i = 0; i < numThreads; ++i)
+        m_workers.emplace_back(new Worker);
+    for (std::size_t i = 0; i < numThreads; ++i)
+        m_workers[i]->m_thread = std::thread([this, i](){ work(i); });
+}
+
+
+Executor::~Executor()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto& w : m_workers)
+        w->m_thread.join();
+}
+
+
+Executor& Executor::global()
+{
+    std::lock_guard<std::mutex> lock(g_globalMutex);
+    if (!g_global)
+    {
+        std::size_t numThreads = g_globalThreads;
+        std::string val;
+        if (!numThreads && Utils::getenv("PDAL_NUM_THREADS", val) == 0)
+            Utils::fromString(val, numThreads);
+        if (!numThreads)
+            numThreads = std::thread::hardware_concurrency();
+        g_global.reset(new Executor(numThreads));
+    }
+    return *g_global;
+}
+
+
+void Executor::setGlobalThreads(std::size_t numThreads)
+{
+    std::lock_guard<std::mutex> lock(g_globalMutex);
+    if (g_global)
+        throw pdal_error("Can't set the number of threads of the global "
+            "executor once it is running.");
+    g_globalThreads = numThreads;
+}
+
+
+void Executor::post(Task task)
+{
+    // Tasks posted by a worker go to its own deque.  Others are spread
+    // among the workers.
+    const std::size_t index = (t_executor == this) ?
+        t_index : m_next++ % m_workers.size();
+
+    Worker& w = *m_workers[index];
+    {
+        std::lock_guard<std::mutex> lock(w.m_mutex);
+        m_pending++;
+        w.m_tasks.push_back(std::move(task));
+    }
+
+    // A worker increments m_sleeping before checking m_pending, so if
+    // no worker is seen to be sleeping, any worker that is about to sleep
+    // will see the new task.
+    if (m_sleeping)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cv.notify_one();
+    }
+}
+
+
+bool Executor::runOne()
+{
+    const std::size_t index = (t_executor == this) ?
+        t_index : m_next++ % m_workers.size();
+
+    Task task;
+    if (!pop(index, task))
+        return false;
+    task();
+    return true;
+}
+
+
+bool Executor::isWorker() const
+{
+    return t_executor == this;
+}
+
+
+// Take the newest task from the deque of worker 'index' or, if that's
+// empty, the oldest task of some other worker.
+bool Executor::pop(std::size_t index, Task& task)
+{
+    if (m_pending == 0)
+        return false;
+
+    const std::size_t numWorkers = m_workers.size();
+    {
+        Worker& w = *m_workers[index];
+        std::lock_guard<std::mutex> lock(w.m_mutex);
+        if (w.m_tasks.size())
+        {
+            task = std::move(w.m_tasks.back());
+            w.m_tasks.pop_back();
+            m_pending--;
+            return true;
+        }
+    }
+    for (std::size_t i = 1; i < numWorkers; ++i)
+    {
+        Worker& w = *m_workers[(index + i) % numWorkers];
+        std::lock_guard<std::mutex> lock(w.m_mutex);
+        if (w.m_tasks.size())
+        {
+            task = std::move(w.m_tasks.front());
+            w.m_tasks.pop_front();
+            m_pending--;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void Executor::work(std::size_t index)
+{
+    t_executor = this;
+    t_index = index;
+
+    Task task;
+    while (true)
+    {
+        if (pop(index, task))
+        {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_sleeping++;
+        m_cv.wait(lock, [this](){ return m_pending || m_stop; });
+        m_sleeping--;
+        if (m_stop && !m_pending)
+            return;
+    }
+}
+
+
+TaskGroup::TaskGroup(std::size_t maxConcurrency, Executor& executor) :
+    m_executor(executor),
+    m_maxConcurrency((std::max)(maxConcurrency, (std::size_t)1)),
+    m_runners(0), m_outstanding(0)
+{}
+
+
+TaskGroup::~TaskGroup()
+{
+    try
+    {
+        wait();
+    }
+    catch (...)
+    {}
+}
+
+
+void TaskGroup::add(std::function<void()> task)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_tasks.push_back(std::move(task));
+    m_outstanding++;
+    if (m_runners < m_maxConcurrency)
+    {
+        m_runners++;
+        lock.unlock();
+        m_executor.post([this](){ drain(); });
+    }
+}
+
+
+// Run the group's tasks until there are none left.  No more than
+// m_maxConcurrency threads run this at once.
+void TaskGroup::drain()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_tasks.size())
+    {
+        std::function<void()> task(std::move(m_tasks.front()));
+        m_tasks.pop_front();
+        lock.unlock();
+
+        std::exception_ptr error;
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        task = nullptr;
+
+        lock.lock();
+        if (error && !m_error)
+            m_error = error;
+        m_outstanding--;
+    }
+    m_runners--;
+    if (done())
+        m_cv.notify_all();
+}
+
+
+void TaskGroup::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_executor.isWorker())
+    {
+        // Rather than block a worker, help out: run our own tasks if that
+        // doesn't exceed the concurrency limit, otherwise any other task.
+        while (!done())
+        {
+            if (m_tasks.size() && m_runners < m_maxConcurrency)
+            {
+                m_runners++;
+                lock.unlock();
+                drain();
+                lock.lock();
+            }
+            else
+            {
+                lock.unlock();
+                bool ran = m_executor.runOne();
+                lock.lock();
+                if (!ran)
+                    m_cv.wait_for(lock, std::chrono::milliseconds(1),
+                        [this](){ return done(); });
+            }
+        }
+    }
+    else
+        m_cv.wait(lock, [this](){ return done(); });
+
+    std::exception_ptr error;
+    std::swap(error, m_error);
+    if (error)
+        std::rethrow_exception(error);
+}
+
+} // namespace pdal
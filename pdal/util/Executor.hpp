@@ -0,0 +1,234 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <pdal/pdal_types.hpp>
+
+namespace pdal
+{
+
+// A pool of worker threads that run tasks from per-worker deques.  A worker
+// takes tasks from the back of its own deque and, when that is empty, steals
+// from the front of the deques of the other workers.  Tasks queued from a
+// worker go to that worker's deque, so nested work stays on the thread that
+// created it.
+//
+// Most code should use the process-wide executor, global(), so that stages
+// that run at the same time share one set of threads rather than each
+// creating their own.  The number of workers of the global executor is the
+// concurrency cap for the process.
+class Executor
+{
+public:
+    using Task = std::function<void()>;
+
+    PDAL_DLL Executor(std::size_t numThreads);
+    PDAL_DLL ~Executor();
+
+    Executor(const Executor& other) = delete;
+    Executor& operator=(const Executor& other) = delete;
+
+    // The process-wide executor.  It is created on first use with the number
+    // of threads set with setGlobalThreads(), the number in the environment
+    // variable PDAL_NUM_THREADS, or the number of hardware threads, in that
+    // order of preference.
+    PDAL_DLL static Executor& global();
+
+    // Set the number of threads of the global executor.  Throws if the
+    // global executor has already been created.
+    PDAL_DLL static void setGlobalThreads(std::size_t numThreads);
+
+    PDAL_DLL std::size_t numThreads() const
+    { return m_workers.size(); }
+
+    // Queue a task.  Tasks must not throw.
+    PDAL_DLL void post(Task task);
+
+    // Queue a function and return a future for its result.  An exception
+    // thrown by the function is stored in the future.
+    template<typename F>
+    auto async(F&& f) -> std::future<decltype(f())>
+    {
+        using Result = decltype(f());
+
+        auto task = std::make_shared<std::packaged_task<Result()>>(
+            std::forward<F>(f));
+        std::future<Result> future = task->get_future();
+        post([task](){ (*task)(); });
+        return future;
+    }
+
+    // Run a queued task in the calling thread, if there is one.  Used by
+    // threads that would otherwise block waiting for other tasks.
+    // \return  Whether a task was run.
+    PDAL_DLL bool runOne();
+
+    // Whether the calling thread is one of this executor's workers.
+    PDAL_DLL bool isWorker() const;
+
+    // Get the result of a future.  A worker runs queued tasks while it
+    // waits.
+    template<typename T>
+    T get(std::future<T>& future)
+    {
+        if (isWorker())
+            while (future.wait_for(std::chrono::seconds(0)) !=
+                    std::future_status::ready)
+                if (!runOne())
+                    future.wait_for(std::chrono::milliseconds(1));
+        return future.get();
+    }
+
+    // Wait on a condition variable until 'pred' is true.  A worker runs
+    // queued tasks while it waits rather than blocking, since the tasks
+    // it's waiting for may be queued behind it.
+    template<typename Pred>
+    void wait(std::unique_lock<std::mutex>& lock, std::condition_variable& cv,
+        Pred pred)
+    {
+        if (!isWorker())
+        {
+            cv.wait(lock, pred);
+            return;
+        }
+        while (!pred())
+        {
+            lock.unlock();
+            bool ran = runOne();
+            lock.lock();
+            if (!ran)
+                cv.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+
+private:
+    struct Worker
+    {
+        std::mutex m_mutex;
+        std::deque<Task> m_tasks;
+        std::thread m_thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<std::size_t> m_pending;
+    std::atomic<std::size_t> m_sleeping;
+    std::atomic<std::size_t> m_next;
+    bool m_stop;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+
+    void work(std::size_t index);
+    bool pop(std::size_t index, Task& task);
+};
+
+// A set of tasks run on an executor, no more than a fixed number of them at
+// once.  This is the replacement for a private ThreadPool: the concurrency
+// limit plays the role of the pool size, but the threads are shared with the
+// rest of the process.
+class TaskGroup
+{
+public:
+    PDAL_DLL TaskGroup(std::size_t maxConcurrency,
+        Executor& executor = Executor::global());
+    // Waits for running tasks.  Exceptions from tasks are discarded.
+    PDAL_DLL ~TaskGroup();
+
+    TaskGroup(const TaskGroup& other) = delete;
+    TaskGroup& operator=(const TaskGroup& other) = delete;
+
+    // Queue a task.
+    PDAL_DLL void add(std::function<void()> task);
+
+    // Wait for all queued tasks to complete and rethrow the first exception
+    // thrown by a task, if any.  When called from a worker of the executor,
+    // the worker runs other tasks while it waits, so tasks may wait for
+    // nested groups without tying up threads.
+    PDAL_DLL void wait();
+
+    PDAL_DLL std::size_t maxConcurrency() const
+    { return m_maxConcurrency; }
+
+private:
+    Executor& m_executor;
+    std::size_t m_maxConcurrency;
+    std::deque<std::function<void()>> m_tasks;
+    std::size_t m_runners;
+    std::size_t m_outstanding;
+    std::exception_ptr m_error;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+
+    void drain();
+    bool done() const
+    { return m_outstanding == 0 && m_runners == 0; }
+};
+
+// Split [0, count) into contiguous ranges and call func(begin, end) for
+// each of them, running up to 'threads' ranges at once.  There are a few
+// more ranges than threads so that uneven ranges balance out.  With a
+// single thread, func is called once on the whole range in the calling
+// thread.
+template<typename FUNC>
+void parallelRange(std::size_t count, std::size_t threads, FUNC func)
+{
+    const std::size_t numParts = (threads <= 1 || count < 2) ? 1 :
+        (std::min)(count, threads * 4);
+    if (numParts == 1)
+    {
+        func((std::size_t)0, count);
+        return;
+    }
+
+    TaskGroup group(threads);
+    for (std::size_t part = 0; part < numParts; ++part)
+        group.add([&func, count, numParts, part]()
+            { func(count * part / numParts, count * (part + 1) / numParts); });
+    group.wait();
+}
+
+} // namespace pdal
@@ -0,0 +1,167 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <atomic>
+#include <chrono>
+
+#include <pdal/util/Executor.hpp>
+
+using namespace pdal;
+
+TEST(ExecutorTest, async)
+{
+    Executor executor(3);
+    EXPECT_EQ(executor.numThreads(), 3u);
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i)
+        futures.push_back(executor.async([i](){ return i * i; }));
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(futures[i].get(), i * i);
+
+    std::future<void> f = executor.async([]()
+        { throw pdal_error("Task failed."); });
+    EXPECT_THROW(f.get(), pdal_error);
+    EXPECT_FALSE(executor.isWorker());
+}
+
+TEST(ExecutorTest, concurrency)
+{
+    Executor executor(4);
+    std::atomic<int> running(0);
+    std::atomic<int> maxRunning(0);
+    std::atomic<int> count(0);
+
+    TaskGroup group(2, executor);
+    for (int i = 0; i < 50; ++i)
+        group.add([&]()
+        {
+            int r = ++running;
+            int m = maxRunning;
+            while (r > m && !maxRunning.compare_exchange_weak(m, r))
+                ;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            --running;
+            ++count;
+        });
+    group.wait();
+    EXPECT_EQ(count, 50);
+    EXPECT_LE(maxRunning, 2);
+
+    // The group can be reused after a wait.
+    group.add([&](){ ++count; });
+    group.wait();
+    EXPECT_EQ(count, 51);
+}
+
+// Tasks that wait for nested groups must not deadlock, even when there are
+// more waiting tasks than threads.
+TEST(ExecutorTest, nested)
+{
+    Executor executor(2);
+    std::atomic<int> count(0);
+
+    TaskGroup outer(8, executor);
+    for (int i = 0; i < 8; ++i)
+        outer.add([&]()
+        {
+            EXPECT_TRUE(executor.isWorker());
+            TaskGroup inner(4, executor);
+            for (int j = 0; j < 10; ++j)
+                inner.add([&](){ ++count; });
+            inner.wait();
+        });
+    outer.wait();
+    EXPECT_EQ(count, 80);
+}
+
+// A worker waiting on a condition runs the task that satisfies it.
+TEST(ExecutorTest, wait)
+{
+    Executor executor(1);
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool ready = false;
+
+    std::future<bool> f = executor.async([&]()
+    {
+        executor.post([&]()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready = true;
+            cv.notify_all();
+        });
+        std::unique_lock<std::mutex> lock(mutex);
+        executor.wait(lock, cv, [&ready](){ return ready; });
+        return ready;
+    });
+    EXPECT_TRUE(f.get());
+}
+
+TEST(ExecutorTest, exceptions)
+{
+    Executor executor(2);
+    std::atomic<int> count(0);
+
+    TaskGroup group(2, executor);
+    for (int i = 0; i < 10; ++i)
+        group.add([&count, i]()
+        {
+            ++count;
+            if (i == 5)
+                throw pdal_error("Task failed.");
+        });
+    EXPECT_THROW(group.wait(), pdal_error);
+    EXPECT_EQ(count, 10);
+
+    // The error has been reported.
+    group.wait();
+}
+
+TEST(ExecutorTest, global)
+{
+    Executor& executor = Executor::global();
+    EXPECT_GE(executor.numThreads(), 1u);
+    EXPECT_EQ(&executor, &Executor::global());
+    EXPECT_THROW(Executor::setGlobalThreads(2), pdal_error);
+
+    TaskGroup group(4);
+    std::atomic<int> count(0);
+    for (int i = 0; i < 20; ++i)
+        group.add([&count](){ ++count; });
+    group.wait();
+    EXPECT_EQ(count, 20);
+}
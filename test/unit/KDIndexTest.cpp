@@ -33,7 +33,11 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <algorithm>
+#include <random>
+
 #include <pdal/KDIndex.hpp>
+#include <pdal/util/Utils.hpp>
 
 using namespace pdal;
 
@@ -378,3 +382,176 @@ TEST(KDIndex, radius3D)
     EXPECT_EQ(ids[2], 2u);
 }
 
+
+TEST(KDIndex, storage)
+{
+    PointTable table;
+    PointLayoutPtr layout = table.layout();
+    PointView view(table);
+
+    layout->registerDim(Dimension::Id::X);
+    layout->registerDim(Dimension::Id::Y);
+    layout->registerDim(Dimension::Id::Z);
+
+    // A grid of points far from the origin, with enough points that the
+    // tree has several leaves.
+    PointId id = 0;
+    for (int i = 0; i < 20; ++i)
+        for (int j = 0; j < 20; ++j)
+            for (int k = 0; k < 5; ++k)
+            {
+                view.setField(Dimension::Id::X, id, 500000.0 + i);
+                view.setField(Dimension::Id::Y, id, 4000000.0 + j * 2);
+                view.setField(Dimension::Id::Z, id, 100.0 + k * 3);
+                id++;
+            }
+
+    auto dist = [&view](PointId a, PointId b)
+    {
+        double x = view.getFieldAs<double>(Dimension::Id::X, a) -
+            view.getFieldAs<double>(Dimension::Id::X, b);
+        double y = view.getFieldAs<double>(Dimension::Id::Y, a) -
+            view.getFieldAs<double>(Dimension::Id::Y, b);
+        double z = view.getFieldAs<double>(Dimension::Id::Z, a) -
+            view.getFieldAs<double>(Dimension::Id::Z, b);
+        return x * x + y * y + z * z;
+    };
+
+    KD3Index viewIndex(view);
+    viewIndex.build();
+    KD2Index viewIndex2(view);
+    viewIndex2.build();
+    for (KDStorage storage : { KDStorage::Double, KDStorage::Float })
+    {
+        KD3Index index(view, storage);
+        index.build();
+        KD2Index index2(view, storage);
+        index2.build();
+        for (PointId i = 0; i < view.size(); i += 7)
+        {
+            PointIdList expected = viewIndex.neighbors(i, 8);
+            PointIdList ids = index.neighbors(i, 8);
+            ASSERT_EQ(ids.size(), expected.size());
+            EXPECT_EQ(ids[0], i);
+            for (size_t j = 0; j < ids.size(); ++j)
+                EXPECT_DOUBLE_EQ(dist(i, ids[j]), dist(i, expected[j]));
+
+            expected = viewIndex.radius(i, 3.5);
+            ids = index.radius(i, 3.5);
+            std::sort(expected.begin(), expected.end());
+            std::sort(ids.begin(), ids.end());
+            EXPECT_EQ(ids, expected);
+
+            expected = viewIndex2.radius(i, 2.5);
+            ids = index2.radius(i, 2.5);
+            std::sort(expected.begin(), expected.end());
+            std::sort(ids.begin(), ids.end());
+            EXPECT_EQ(ids, expected);
+        }
+    }
+}
+
+TEST(KDIndex, storageOption)
+{
+    KDStorage storage;
+    EXPECT_TRUE(Utils::fromString("view", storage));
+    EXPECT_EQ(storage, KDStorage::View);
+    EXPECT_TRUE(Utils::fromString("Double", storage));
+    EXPECT_EQ(storage, KDStorage::Double);
+    EXPECT_TRUE(Utils::fromString("float", storage));
+    EXPECT_EQ(storage, KDStorage::Float);
+    EXPECT_FALSE(Utils::fromString("half", storage));
+    EXPECT_EQ(Utils::toString(KDStorage::Float), "float");
+}
+
+TEST(KDIndex, batch)
+{
+    PointTable table;
+    PointLayoutPtr layout = table.layout();
+    PointView view(table);
+
+    layout->registerDim(Dimension::Id::X);
+    layout->registerDim(Dimension::Id::Y);
+    layout->registerDim(Dimension::Id::Z);
+
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> dis(0.0, 100.0);
+    for (PointId id = 0; id < 20000; ++id)
+    {
+        view.setField(Dimension::Id::X, id, dis(gen));
+        view.setField(Dimension::Id::Y, id, dis(gen));
+        view.setField(Dimension::Id::Z, id, dis(gen));
+    }
+
+    KD3Index serial(view);
+    serial.build();
+    KD3Index index(view, KDStorage::Double);
+    index.build(4);
+    KD2Index serial2(view);
+    serial2.build();
+    KD2Index index2(view);
+    index2.build(4);
+
+    KDNeighbors knn = index.knnBatch(0, view.size(), 8, 4);
+    KDNeighbors knn2 = index2.knnBatch(0, view.size(), 8, 4);
+    KDNeighbors rad = index.radiusBatch(100, 500, 5.0, 3);
+    KDNeighbors rad2 = index2.radiusBatch(100, 500, 2.0, 3);
+    ASSERT_EQ(knn.size(), view.size());
+    ASSERT_EQ(knn2.size(), view.size());
+    ASSERT_EQ(rad.size(), 500u);
+    ASSERT_EQ(rad2.size(), 500u);
+
+    for (PointId i = 0; i < view.size(); ++i)
+    {
+        PointIdList ids(8);
+        std::vector<double> sqrDists(8);
+        serial.knnSearch(i, 8, &ids, &sqrDists);
+        ASSERT_EQ(knn.count(i), 8u);
+        EXPECT_EQ(knn.ids(i)[0], i);
+        for (size_t j = 0; j < 8; ++j)
+            EXPECT_DOUBLE_EQ(knn.sqrDists(i)[j], sqrDists[j]);
+
+        serial2.knnSearch(i, 8, &ids, &sqrDists);
+        ASSERT_EQ(knn2.count(i), 8u);
+        for (size_t j = 0; j < 8; ++j)
+            EXPECT_DOUBLE_EQ(knn2.sqrDists(i)[j], sqrDists[j]);
+    }
+
+    for (size_t i = 0; i < rad.size(); ++i)
+    {
+        PointIdList expected = serial.radius(100 + i, 5.0);
+        PointIdList ids(rad.ids(i), rad.ids(i) + rad.count(i));
+        std::sort(expected.begin(), expected.end());
+        std::sort(ids.begin(), ids.end());
+        EXPECT_EQ(ids, expected);
+        for (size_t j = 1; j < rad.count(i); ++j)
+            EXPECT_LE(rad.sqrDists(i)[j - 1], rad.sqrDists(i)[j]);
+
+        expected = serial2.radius(100 + i, 2.0);
+        ids.assign(rad2.ids(i), rad2.ids(i) + rad2.count(i));
+        std::sort(expected.begin(), expected.end());
+        std::sort(ids.begin(), ids.end());
+        EXPECT_EQ(ids, expected);
+    }
+
+    // Query by a list of point IDs.
+    PointIdList queries { 5, 17, 5, 19999 };
+    KDNeighbors list = index.knnBatch(queries, 3, 2);
+    ASSERT_EQ(list.size(), queries.size());
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        ASSERT_EQ(list.count(i), 3u);
+        EXPECT_EQ(list.ids(i)[0], queries[i]);
+    }
+
+    // Ask for more neighbors than there are points in the view.
+    PointView small(table);
+    small.appendPoint(view, 0);
+    small.appendPoint(view, 1);
+    KD3Index smallIndex(small);
+    smallIndex.build(2);
+    KDNeighbors all = smallIndex.knnBatch(0, small.size(), 8, 2);
+    ASSERT_EQ(all.size(), 2u);
+    EXPECT_EQ(all.count(0), 2u);
+    EXPECT_EQ(all.count(1), 2u);
+}
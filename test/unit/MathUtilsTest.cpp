@@ -32,6 +32,8 @@
 * OF SUCH DAMAGE.
 ****************************************************************************/
 
+#include <random>
+
 #include <pdal/pdal_test_main.hpp>
 #include <pdal/private/MathUtils.hpp>
 
@@ -91,4 +93,66 @@ TEST(MathUtilsTest, barycentric)
     }
 }
 
+namespace
+{
+
+// Brute-force diamond morphology: each cell gets the extreme of the
+// cells within the given L1 distance.
+std::vector<double> bruteDiamond(const std::vector<double>& data,
+    int rows, int cols, int radius, bool dilate)
+{
+    std::vector<double> out(data.size());
+    for (int c = 0; c < cols; ++c)
+        for (int r = 0; r < rows; ++r)
+        {
+            double v = data[c * rows + r];
+            for (int cc = (std::max)(0, c - radius);
+                    cc <= (std::min)(cols - 1, c + radius); ++cc)
+            {
+                int dr = radius - std::abs(cc - c);
+                for (int rr = (std::max)(0, r - dr);
+                        rr <= (std::min)(rows - 1, r + dr); ++rr)
+                {
+                    double t = data[cc * rows + rr];
+                    v = dilate ? (std::max)(v, t) : (std::min)(v, t);
+                }
+            }
+            out[c * rows + r] = v;
+        }
+    return out;
+}
+
+} // unnamed namespace
+
+TEST(MathUtilsTest, diamond)
+{
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> dist(0, 100);
+
+    std::vector<std::pair<int, int>> sizes { {1, 1}, {1, 17}, {23, 1},
+        {2, 3}, {20, 31}, {37, 12} };
+    for (auto& size : sizes)
+    {
+        const int rows = size.first;
+        const int cols = size.second;
+        std::vector<double> data(rows * cols);
+        for (double& d : data)
+            d = dist(gen);
+
+        for (int radius = 0; radius < 14; ++radius)
+            for (int threads : { 1, 3 })
+            {
+                std::vector<double> eroded(data);
+                math::erodeDiamond(eroded, rows, cols, radius, threads);
+                EXPECT_EQ(eroded, bruteDiamond(data, rows, cols, radius,
+                    false)) << rows << "x" << cols << " radius " << radius;
+
+                std::vector<double> dilated(data);
+                math::dilateDiamond(dilated, rows, cols, radius, threads);
+                EXPECT_EQ(dilated, bruteDiamond(data, rows, cols, radius,
+                    true)) << rows << "x" << cols << " radius " << radius;
+            }
+    }
+}
+
 } // namespace pdal
@@ -37,6 +37,7 @@
 #include <array>
 #include <random>
 
+#include <pdal/PointColumn.hpp>
 #include <pdal/PointView.hpp>
 #include <pdal/PDALUtils.hpp>
 
@@ -290,6 +291,126 @@ TEST(PointViewTest, getFloatNan)
     EXPECT_NO_THROW(view->getFieldAs<float>(Dimension::Id::ScanAngleRank, 0));
 }
 
+namespace
+{
+
+void verifyColumns(PointTableRef table)
+{
+    PointLayoutPtr layout(table.layout());
+    layout->registerDim(Dimension::Id::Classification);
+    layout->registerDim(Dimension::Id::X);
+    layout->registerDim(Dimension::Id::Y);
+    table.finalize();
+
+    // Spans more than one block of the tables.
+    const point_count_t cnt = 70000;
+    PointViewPtr view(new PointView(table));
+    for (PointId i = 0; i < cnt; i++)
+    {
+        view->setField(Dimension::Id::Classification, i, (uint8_t)(i + 1));
+        view->setField(Dimension::Id::X, i, (int32_t)(i * 10));
+        view->setField(Dimension::Id::Y, i, (double)(i * 100));
+    }
+
+    PointColumn<double> x = view->column<double>(Dimension::Id::X);
+    PointColumn<double> y = view->column<double>(Dimension::Id::Y);
+    PointColumn<int> c = view->column<int>(Dimension::Id::Classification);
+    EXPECT_TRUE(x.direct());
+    EXPECT_EQ(x.size(), cnt);
+    for (PointId i = 0; i < cnt; ++i)
+    {
+        EXPECT_EQ(x[i], view->getFieldAs<double>(Dimension::Id::X, i));
+        EXPECT_EQ(y[i], view->getFieldAs<double>(Dimension::Id::Y, i));
+        EXPECT_EQ(c[i], view->getFieldAs<int>(Dimension::Id::Classification, i));
+    }
+
+    // Columns of a view that doesn't hold the table's points in order.
+    PointViewPtr odd = view->makeNew();
+    for (PointId i = cnt - 1; i < cnt; i -= 2)
+        odd->appendPoint(*view, i);
+    PointColumn<double> oddX = odd->column<double>(Dimension::Id::X);
+    EXPECT_EQ(oddX.size(), odd->size());
+    for (PointId i = 0; i < odd->size(); ++i)
+        EXPECT_EQ(oddX[i], odd->getFieldAs<double>(Dimension::Id::X, i));
+
+    PointColumn<uint8_t> small = view->column<uint8_t>(Dimension::Id::Y);
+    EXPECT_EQ(small[1], 100u);
+    EXPECT_THROW(small[3], pdal_error);
+}
+
+} // unnamed namespace
+
+TEST(PointViewTest, column)
+{
+    PointTable rowTable;
+    verifyColumns(rowTable);
+
+    ColumnPointTable columnTable;
+    verifyColumns(columnTable);
+}
+
+TEST(PointViewTest, sortKeys)
+{
+    using namespace Dimension;
+
+    PointTable table;
+    PointLayoutPtr layout(table.layout());
+    layout->registerDim(Id::GpsTime);
+    layout->registerDim(Id::ReturnNumber);
+    layout->registerDim(Id::OriginId);
+    Id offset = layout->assignDim("Offset", Type::Signed16);
+    table.finalize();
+
+    const point_count_t cnt = 200000;
+    std::mt19937 generator(1234);
+    std::uniform_int_distribution<int> dist(-500, 500);
+    PointViewPtr view(new PointView(table));
+    for (PointId i = 0; i < cnt; ++i)
+    {
+        int t = dist(generator);
+        view->setField(Id::GpsTime, i, t == 0 && (i % 2) ? -0.0 : t * 0.25);
+        view->setField(Id::ReturnNumber, i, (uint8_t)(generator() % 5));
+        view->setField(Id::OriginId, i, (uint32_t)i);
+        view->setField(offset, i, (int16_t)dist(generator));
+    }
+
+    auto verify = [&](const std::vector<PointView::SortKey>& keys)
+    {
+        auto cmp = [&keys](const PointRef& p1, const PointRef& p2)
+        {
+            for (const PointView::SortKey& key : keys)
+            {
+                double d1 = p1.getFieldAs<double>(key.dim);
+                double d2 = p2.getFieldAs<double>(key.dim);
+                if (d1 != d2)
+                    return key.descending ? d1 > d2 : d1 < d2;
+            }
+            return false;
+        };
+
+        PointViewPtr expected = view->makeNew();
+        PointViewPtr sorted = view->makeNew();
+        for (PointId i = 0; i < cnt; ++i)
+        {
+            expected->appendPoint(*view, i);
+            sorted->appendPoint(*view, i);
+        }
+        expected->stableSort(cmp);
+        sorted->stableSort(keys, 4);
+
+        ASSERT_EQ(expected->size(), sorted->size());
+        for (PointId i = 0; i < cnt; ++i)
+            ASSERT_EQ(expected->getFieldAs<uint32_t>(Id::OriginId, i),
+                sorted->getFieldAs<uint32_t>(Id::OriginId, i));
+    };
+
+    verify({ { Id::GpsTime, false } });
+    verify({ { Id::GpsTime, true } });
+    verify({ { offset, false }, { Id::ReturnNumber, true } });
+    verify({ { Id::ReturnNumber, false }, { Id::GpsTime, false },
+        { Id::Intensity, false } });
+}
+
 // Per discussions with @abellgithub (https://github.com/gadomski/PDAL/commit/c1d54e56e2de841d37f2a1b1c218ed723053f6a9#commitcomment-14415138)
 // we only do bounds checking on `PointView`s when in debug mode.
 #ifndef NDEBUG
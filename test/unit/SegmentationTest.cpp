@@ -40,6 +40,7 @@
 
 #include <filters/private/Segmentation.hpp>
 
+#include <cmath>
 #include <vector>
 
 using namespace pdal;
@@ -155,6 +156,39 @@ TEST(SegmentationTest, Clustering2D)
     EXPECT_EQ(1u, clusters[0].size());
 }
 
+TEST(SegmentationTest, ClusteringThreads)
+{
+    using namespace Segmentation;
+
+    PointTable table;
+    PointLayoutPtr layout(table.layout());
+
+    layout->registerDim(Dimension::Id::X);
+    layout->registerDim(Dimension::Id::Y);
+    layout->registerDim(Dimension::Id::Z);
+
+    // Clumps of points along a line, with some stragglers between them.
+    PointViewPtr src(new PointView(table));
+    for (PointId i = 0; i < 2000; ++i)
+    {
+        double x = (double)((i * 7919) % 2000) / 10.0;
+        if ((i % 13) != 0)
+            x = std::floor(x / 10.0) * 10.0 + (i % 5) * 0.5;
+        src->setField(Dimension::Id::X, i, x);
+        src->setField(Dimension::Id::Y, i, (double)(i % 3) * 0.5);
+        src->setField(Dimension::Id::Z, i, 0.0);
+    }
+
+    std::deque<PointIdList> single =
+        extractClusters<KD3Index>(*src, 2, 1000, 1.0);
+    std::deque<PointIdList> multi =
+        extractClusters<KD3Index>(*src, 2, 1000, 1.0, 4);
+    ASSERT_EQ(single.size(), multi.size());
+    EXPECT_GT(single.size(), 1u);
+    for (size_t i = 0; i < single.size(); ++i)
+        EXPECT_EQ(single[i], multi[i]);
+}
+
 TEST(SegmentationTest, SegmentReturns)
 {
     using namespace Segmentation;
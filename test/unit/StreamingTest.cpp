@@ -528,3 +528,110 @@ R"(
         EXPECT_NE(output.find("DBDCA"), std::string::npos);
     }
 }
+
+// Running stream stages on separate threads should pass the same points,
+// in the same order, to the final stage as a single-threaded run.
+TEST(Streaming, threads)
+{
+    auto run = [](std::size_t threads)
+    {
+        Options ro;
+        ro.add("bounds", BOX3D(0, 0, 0, 9999, 9999, 9999));
+        ro.add("mode", "ramp");
+        ro.add("count", 10000);
+        FauxReader r;
+        r.setOptions(ro);
+
+        Options rangeOps;
+        rangeOps.add("limits", "X[1000:8999]");
+        StageFactory factory;
+        Stage *range = factory.createStage("filters.range");
+        range->setOptions(rangeOps);
+        range->setInput(r);
+
+        std::vector<double> xs;
+        StreamCallbackFilter f;
+        f.setInput(*range);
+        f.setCallback([&xs](PointRef& point)
+        {
+            xs.push_back(point.getFieldAs<double>(Dimension::Id::X));
+            return true;
+        });
+
+        FixedPointTable table(1000);
+        f.prepare(table);
+        f.execute(table, threads);
+        return xs;
+    };
+
+    std::vector<double> serial = run(1);
+    EXPECT_EQ(serial.size(), 8000u);
+    EXPECT_EQ(serial, run(4));
+}
+
+// Check that points dropped partway through a table fill are removed from
+// the selection, so that only the selected points reach later stages.
+TEST(Streaming, selection)
+{
+    class DropFilter : public Filter, public Streamable
+    {
+    public:
+        DropFilter(int modulus) : m_modulus(modulus), m_count(0)
+        {}
+
+        std::string getName() const
+            { return "filters.drop"; }
+
+        int m_modulus;
+        point_count_t m_count;
+
+    private:
+        virtual bool processOne(PointRef& point)
+        {
+            m_count++;
+            return point.getFieldAs<int>(Dimension::Id::X) % m_modulus != 0;
+        }
+    };
+
+    auto run = [](std::size_t threads)
+    {
+        Options ro;
+        ro.add("bounds", BOX3D(0, 0, 0, 99, 99, 99));
+        ro.add("mode", "ramp");
+        ro.add("count", 100);
+        FauxReader r;
+        r.setOptions(ro);
+
+        DropFilter d1(2);
+        d1.setInput(r);
+
+        DropFilter d2(3);
+        d2.setInput(d1);
+
+        std::vector<int> xs;
+        StreamCallbackFilter f;
+        f.setInput(d2);
+        f.setCallback([&xs](PointRef& point)
+        {
+            xs.push_back(point.getFieldAs<int>(Dimension::Id::X));
+            return true;
+        });
+
+        // A table size that isn't a multiple of either modulus, so that
+        // points are dropped at different places in each fill.
+        FixedPointTable table(32);
+        f.prepare(table);
+        f.execute(table, threads);
+
+        EXPECT_EQ(d1.m_count, 100u);
+        EXPECT_EQ(d2.m_count, 50u);
+        return xs;
+    };
+
+    std::vector<int> expected;
+    for (int x = 0; x < 100; ++x)
+        if (x % 2 && x % 3)
+            expected.push_back(x);
+    EXPECT_EQ(run(1), expected);
+    EXPECT_EQ(run(4), expected);
+}
@@ -0,0 +1,118 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <map>
+#include <random>
+#include <tuple>
+
+#include <filters/private/VoxelMap.hpp>
+
+using namespace pdal;
+
+TEST(VoxelMapTest, insertFind)
+{
+    using Voxel = std::tuple<int, int, int>;
+
+    VoxelMap<int> map;
+    std::map<Voxel, int> expected;
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> dist(-50, 50);
+
+    EXPECT_EQ(map.find(0, 0, 0), nullptr);
+    for (int i = 0; i < 100000; ++i)
+    {
+        int x = dist(generator);
+        int y = dist(generator);
+        int z = dist(generator) / 10;
+
+        auto p = map.insert(x, y, z);
+        auto e = expected.insert({ Voxel(x, y, z), i });
+        EXPECT_EQ(p.second, e.second);
+        if (p.second)
+            *p.first = i;
+        EXPECT_EQ(*p.first, e.first->second);
+    }
+    EXPECT_EQ(map.size(), expected.size());
+
+    for (int x = -51; x <= 51; ++x)
+        for (int y = -51; y <= 51; ++y)
+        {
+            int *v = map.find(x, y, 1);
+            auto ei = expected.find(Voxel(x, y, 1));
+            if (ei == expected.end())
+                EXPECT_EQ(v, nullptr);
+            else
+                EXPECT_EQ(*v, ei->second);
+        }
+
+    size_t count = 0;
+    map.forEach([&](int x, int y, int z, int v)
+    {
+        EXPECT_EQ(expected[Voxel(x, y, z)], v);
+        count++;
+    });
+    EXPECT_EQ(count, expected.size());
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(0, 0, 0), nullptr);
+}
+
+TEST(VoxelMapTest, reserve)
+{
+    VoxelMap<std::vector<int>> map;
+
+    map.reserve(1000);
+    for (int i = 0; i < 1000; ++i)
+        map.insert(i, -i).first->push_back(i);
+    EXPECT_EQ(map.size(), 1000u);
+    for (int i = 0; i < 1000; ++i)
+    {
+        std::vector<int> *v = map.find(i, -i);
+        ASSERT_NE(v, nullptr);
+        EXPECT_EQ(v->size(), 1u);
+        EXPECT_EQ(v->front(), i);
+    }
+    EXPECT_EQ(map.find(1, 1), nullptr);
+
+    BOX3D bounds(0, 0, 0, 10, 10, 1);
+    EXPECT_EQ(voxelEstimate(bounds, 1.0, 10000), 12u * 12u);
+    EXPECT_EQ(voxelEstimate(bounds, 1.0, 100), 100u);
+    EXPECT_EQ(voxelEstimate(BOX3D(), 1.0, 100), 0u);
+    BOX3D large(0, 0, 0, 1e5, 1e5, 1e3);
+    EXPECT_EQ(voxelEstimate(large, 1.0, 1000000000), MaxVoxelEstimate);
+}
@@ -82,6 +82,39 @@ TEST(TIndex, test1)
     EXPECT_NE(pos, std::string::npos);
 }
 
+// Identical to test1, but the input files are read on several threads.
+TEST(TIndex, threads)
+{
+    std::string inSpec(Support::datapath("tindex/*.txt"));
+    std::string outSpec(Support::temppath("tindex.out"));
+    std::string outPoints(Support::temppath("points.txt"));
+
+    std::string cmd = Support::binpath("pdal") + " tindex create " +
+        outSpec + " \"" + inSpec + "\" --threads=3";
+
+    FileUtils::deleteDirectory(outSpec);
+
+    std::string output;
+    Utils::run_shell_command(cmd, output);
+
+    cmd = Support::binpath("pdal") + " --verbose=info tindex merge " +
+        outSpec + " " + outPoints + " --log=stdout "
+        "--bounds=\"([1.25, 3],[1.25, 3])\"";
+
+    FileUtils::deleteFile(outPoints);
+    Utils::run_shell_command(cmd, output);
+    std::string::size_type pos = output.find("Merge filecount: 3");
+    EXPECT_NE(pos, std::string::npos);
+
+    cmd = Support::binpath("pdal") + " --verbose=info tindex merge " +
+        outSpec + " " + outPoints + " --log=stdout "
+        "--bounds=\"([1.25, 1.75],[1.25, 1.75])\"";
+    FileUtils::deleteFile(outPoints);
+    Utils::run_shell_command(cmd, output);
+    pos = output.find("Merge filecount: 1");
+    EXPECT_NE(pos, std::string::npos);
+}
+
 TEST(TIndex, test2)
 {
     std::string inSpec(Support::datapath("tindex/*.txt"));
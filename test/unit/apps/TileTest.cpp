@@ -90,6 +90,80 @@ TEST(Tile, test1)
 }
 
 
+// Limit the number of open writers so that most tiles are spilled.
+TEST(Tile, maxWriters)
+{
+    std::string inSpec(Support::datapath("text/file*.txt"));
+    std::string outSpec(Support::temppath("tile/out#.txt"));
+
+    std::string baseCmd = Support::binpath("pdal") + " tile \"" +
+        inSpec + "\" \"" + outSpec + "\" ";
+
+    FileUtils::deleteDirectory(Support::temppath("tile"));
+    FileUtils::createDirectory(Support::temppath("tile"));
+
+    std::string output;
+    std::string cmd = baseCmd +
+        " --origin_x=0 --origin_y=0 --length=10 --max_writers=2";
+    Utils::run_shell_command(cmd, output);
+
+    // The spill files are removed.
+    EXPECT_EQ(FileUtils::directoryList(Support::temppath("tile")).size(), 9U);
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            checkFile(i, j, 3);
+}
+
+
+// Read the input files on several threads, from text and LAS files.
+TEST(Tile, threads)
+{
+    std::string inSpec(Support::datapath("text/file*.txt"));
+    std::string outSpec(Support::temppath("tile/out#.txt"));
+
+    std::string baseCmd = Support::binpath("pdal") + " tile \"" +
+        inSpec + "\" \"" + outSpec + "\" ";
+
+    FileUtils::deleteDirectory(Support::temppath("tile"));
+    FileUtils::createDirectory(Support::temppath("tile"));
+
+    std::string output;
+    std::string cmd = baseCmd +
+        " --origin_x=0 --origin_y=0 --length=10 --threads=3";
+    Utils::run_shell_command(cmd, output);
+
+    EXPECT_EQ(FileUtils::directoryList(Support::temppath("tile")).size(), 9U);
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            checkFile(i, j, 3);
+
+    FileUtils::deleteDirectory(Support::temppath("tile"));
+    FileUtils::createDirectory(Support::temppath("tile"));
+
+    std::string infile(Support::datapath("tile/tile.txt"));
+    for (int i = 1; i <= 3; ++i)
+    {
+        std::string file(Support::temppath("tile/file" +
+            std::to_string(i) + ".las"));
+        cmd = Support::binpath("pdal") + " translate \"" + infile + "\" \"" +
+            file + "\" --readers.text.override_srs=\"EPSG:2029\"";
+        Utils::run_shell_command(cmd, output);
+    }
+
+    inSpec = Support::temppath("tile/file*.las");
+    baseCmd = Support::binpath("pdal") + " tile \"" +
+        inSpec + "\" \"" + outSpec + "\" ";
+    cmd = baseCmd + " --origin_x=500000 --origin_y=5000000 "
+        "--length=10 --threads=3 --writers.text.order=X,Y,Z "
+        "--writers.text.keep_unspecified=false";
+    Utils::run_shell_command(cmd, output);
+
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            checkFile(i, j, 3, 500000, 5000000);
+}
+
+
 TEST(Tile, test2)
 {
     std::string output;
@@ -37,6 +37,7 @@
 #include <pdal/StageFactory.hpp>
 #include <pdal/util/FileUtils.hpp>
 
+#include <filters/StreamCallbackFilter.hpp>
 #include "Support.hpp"
 
 using namespace pdal;
@@ -269,3 +270,53 @@ TEST(AssignFilterTest, test_creation)
         EXPECT_DOUBLE_EQ(std::floor(x), xi / 10);
     }
 }
+
+
+TEST(AssignFilterTest, stream)
+{
+    StageFactory factory;
+
+    Stage& r = *factory.createStage("readers.las");
+    Stage& f = *factory.createStage("filters.assign");
+
+    // utm17.las contains 5 points with intensity of 280, 3 of 260 and 2 of 240
+    Options ro;
+    ro.add("filename", Support::datapath("las/utm17.las"));
+    r.setOptions(ro);
+
+    Options fo;
+    fo.add("condition", "Intensity[250:300]");
+    fo.add("assignment", "PointSourceId[:]=6");
+    fo.add("value", "Classification = 2 where Intensity == 280");
+
+    f.setInput(r);
+    f.setOptions(fo);
+
+    StreamCallbackFilter c;
+    c.setInput(f);
+
+    int count = 0;
+    auto cb = [&count](PointRef& point)
+    {
+        int id = point.getFieldAs<int>(Dimension::Id::PointSourceId);
+        int cls = point.getFieldAs<int>(Dimension::Id::Classification);
+        int intensity = point.getFieldAs<int>(Dimension::Id::Intensity);
+        if (intensity >= 250)
+        {
+            EXPECT_EQ(id, 6);
+        }
+        if (intensity == 280)
+        {
+            EXPECT_EQ(cls, 2);
+        }
+        count++;
+        return true;
+    };
+    c.setCallback(cb);
+
+    FixedPointTable t(4);
+    c.prepare(t);
+    c.execute(t);
+
+    EXPECT_EQ(count, 10);
+}
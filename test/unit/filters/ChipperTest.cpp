@@ -144,3 +144,43 @@ TEST(ChipperTest, empty_buffer)
     EXPECT_EQ(viewSet.size(), 0u);
 }
 
+
+// Chips don't depend on the number of threads.
+TEST(ChipperTest, threads)
+{
+    auto chip = [](int threads)
+    {
+        PointTable table;
+
+        LasReader r;
+        Options rOpts;
+        rOpts.add("filename", Support::datapath("las/autzen_trim.las"));
+        r.setOptions(rOpts);
+
+        ChipperFilter chipper;
+        Options cOpts;
+        cOpts.add("capacity", 100);
+        cOpts.add("threads", threads);
+        chipper.setOptions(cOpts);
+        chipper.setInput(r);
+
+        chipper.prepare(table);
+        std::vector<std::vector<double>> chips;
+        for (PointViewPtr v : chipper.execute(table))
+        {
+            std::vector<double> coords;
+            for (PointId i = 0; i < v->size(); ++i)
+            {
+                coords.push_back(v->getFieldAs<double>(Dimension::Id::X, i));
+                coords.push_back(v->getFieldAs<double>(Dimension::Id::Y, i));
+            }
+            chips.push_back(coords);
+        }
+        return chips;
+    };
+
+    std::vector<std::vector<double>> single = chip(1);
+    std::vector<std::vector<double>> multi = chip(4);
+    EXPECT_EQ(single.size(), 1100u);
+    EXPECT_EQ(single, multi);
+}
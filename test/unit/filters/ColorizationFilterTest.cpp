@@ -34,7 +34,11 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <random>
+
 #include <pdal/PointView.hpp>
+#include <pdal/private/gdal/Raster.hpp>
+#include <pdal/private/gdal/RasterSampler.hpp>
 #include <io/LasReader.hpp>
 #include <filters/ColorizationFilter.hpp>
 #include <filters/StreamCallbackFilter.hpp>
@@ -232,4 +236,62 @@ TEST(ColorizationFilterTest, test5)
     // expect input points that were translated out of the raster image area are not filtered out.
     EXPECT_NE(pointCount, 23u);
     EXPECT_EQ(pointCount, 106u);
-}
\ No newline at end of file
+}
+
+// Check that cached block sampling matches reading single cells.
+TEST(ColorizationFilterTest, sampler)
+{
+    gdal::Raster raster(Support::datapath("autzen/autzen.jpg"));
+    ASSERT_EQ(raster.open(), gdal::GDALError::None);
+    BOX2D bounds = raster.bounds();
+
+    std::mt19937 gen(4321);
+    std::uniform_real_distribution<double> xdist(bounds.minx - 100,
+        bounds.maxx + 100);
+    std::uniform_real_distribution<double> ydist(bounds.miny - 100,
+        bounds.maxy + 100);
+    std::vector<double> x, y;
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        x.push_back(xdist(gen));
+        y.push_back(ydist(gen));
+    }
+
+    // A tiny cache forces blocks to be evicted and read again.
+    gdal::RasterSampler small(raster, 1);
+    gdal::RasterSampler large(raster);
+
+    std::vector<int> bands { 3, 1 };
+    std::vector<double> values;
+    std::vector<char> valid;
+    large.sample(x, y, bands, values, valid);
+
+    int blockWidth, blockHeight;
+    raster.getBlockSize(0, blockWidth, blockHeight);
+    size_t blocks = ((raster.width() + blockWidth - 1) / blockWidth) *
+        ((raster.height() + blockHeight - 1) / blockHeight);
+    EXPECT_LE(large.blocksRead(), blocks * bands.size());
+
+    std::vector<double> data;
+    std::array<double, 2> pix;
+    size_t inside = 0;
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+        bool ok = raster.read(x[i], y[i], data, pix) == gdal::GDALError::None;
+        EXPECT_EQ(ok, (bool)valid[i]);
+        if (!ok)
+            continue;
+        inside++;
+        EXPECT_EQ(values[i * 2], data[2]);
+        EXPECT_EQ(values[i * 2 + 1], data[0]);
+
+        double v;
+        EXPECT_TRUE(small.sample(x[i], y[i], 2, v));
+        EXPECT_EQ(v, data[1]);
+    }
+    EXPECT_GT(inside, 0u);
+    EXPECT_LT(inside, x.size());
+
+    double v;
+    EXPECT_FALSE(small.sample(x[0], y[0], 4, v));
+}
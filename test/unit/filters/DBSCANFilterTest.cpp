@@ -0,0 +1,200 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <random>
+#include <unordered_set>
+
+#include <filters/DBSCANFilter.hpp>
+#include <io/BufferReader.hpp>
+#include <pdal/Dimension.hpp>
+#include <pdal/KDIndex.hpp>
+#include <pdal/PointTable.hpp>
+#include <pdal/PointView.hpp>
+#include <pdal/pdal_test_main.hpp>
+
+using namespace pdal;
+
+namespace
+{
+
+// Classic sequential DBSCAN with stored neighborhoods.
+std::vector<int64_t> referenceDBSCAN(const PointView& view,
+    const Dimension::IdList& dims, double eps, size_t minPoints)
+{
+    KDFlexIndex kdfi(view, dims);
+    kdfi.build();
+
+    std::vector<PointIdList> neighbors(view.size());
+    for (PointId idx = 0; idx < view.size(); ++idx)
+        neighbors[idx] = kdfi.radius(idx, eps);
+
+    std::vector<int64_t> labels(view.size(), -2);
+    int64_t label = 0;
+    for (PointId idx = 0; idx < view.size(); ++idx)
+    {
+        if (labels[idx] != -2)
+            continue;
+        if (neighbors[idx].size() < minPoints)
+        {
+            labels[idx] = -1;
+            continue;
+        }
+        std::unordered_set<PointId> next(neighbors[idx].begin(),
+            neighbors[idx].end());
+        std::unordered_set<PointId> visited { idx };
+        labels[idx] = label;
+        while (!next.empty())
+        {
+            PointId p = *next.begin();
+            next.erase(next.begin());
+            visited.insert(p);
+            if (labels[p] == -1)
+                labels[p] = label;
+            if (labels[p] != -2)
+                continue;
+            labels[p] = label;
+            if (neighbors[p].size() >= minPoints)
+                for (PointId q : neighbors[p])
+                    if (visited.count(q) == 0)
+                        next.insert(q);
+        }
+        label++;
+    }
+    return labels;
+}
+
+} // unnamed namespace
+
+TEST(DBSCANFilterTest, reference)
+{
+    using namespace Dimension;
+
+    std::mt19937 gen(2468);
+    std::normal_distribution<double> blob(0, 1.5);
+    std::uniform_real_distribution<double> noise(-20, 20);
+
+    for (int threads : { 1, 4 })
+    {
+        PointTable table;
+        table.layout()->registerDims({Id::X, Id::Y, Id::Z});
+
+        BufferReader br;
+        DBSCANFilter filter;
+        Options opts;
+        opts.add("eps", 1.0);
+        opts.add("min_points", 6);
+        opts.add("threads", threads);
+        filter.setInput(br);
+        filter.setOptions(opts);
+        filter.prepare(table);
+
+        PointViewPtr src(new PointView(table));
+        PointId idx = 0;
+        for (double center : { -10.0, 0.0, 10.0 })
+            for (int i = 0; i < 1000; ++i)
+            {
+                src->setField(Id::X, idx, center + blob(gen));
+                src->setField(Id::Y, idx, center + blob(gen));
+                src->setField(Id::Z, idx, blob(gen));
+                idx++;
+            }
+        for (int i = 0; i < 1000; ++i)
+        {
+            src->setField(Id::X, idx, noise(gen));
+            src->setField(Id::Y, idx, noise(gen));
+            src->setField(Id::Z, idx, noise(gen));
+            idx++;
+        }
+        br.addView(src);
+
+        PointViewSet viewSet = filter.execute(table);
+        PointViewPtr view = *viewSet.begin();
+
+        std::vector<int64_t> expected =
+            referenceDBSCAN(*view, { Id::X, Id::Y, Id::Z }, 1.0, 6);
+        int64_t clusters = 0;
+        for (PointId i = 0; i < view->size(); ++i)
+        {
+            int64_t label = view->getFieldAs<int64_t>(Id::ClusterID, i);
+            EXPECT_EQ(label, expected[i]);
+            clusters = (std::max)(clusters, label + 1);
+        }
+        EXPECT_GT(clusters, 2);
+
+        MetadataNode m = filter.getMetadata();
+        EXPECT_EQ(m.findChild("clusters").value<int64_t>(), clusters);
+        EXPECT_GT(m.findChild("estimated_memory").value<uint64_t>(), 0u);
+        EXPECT_TRUE(m.findChild("core_time").valid());
+    }
+}
+
+// Metadata is reported once, with totals over all the views.
+TEST(DBSCANFilterTest, metadataViews)
+{
+    using namespace Dimension;
+
+    PointTable table;
+    table.layout()->registerDims({Id::X, Id::Y, Id::Z});
+
+    BufferReader br;
+    DBSCANFilter filter;
+    Options opts;
+    opts.add("eps", 1.0);
+    opts.add("min_points", 6);
+    filter.setInput(br);
+    filter.setOptions(opts);
+    filter.prepare(table);
+
+    // Each view holds a single tight cluster.
+    for (double center : { 0.0, 100.0 })
+    {
+        PointViewPtr view(new PointView(table));
+        for (PointId idx = 0; idx < 20; ++idx)
+        {
+            view->setField(Id::X, idx, center + idx * 0.1);
+            view->setField(Id::Y, idx, center);
+            view->setField(Id::Z, idx, 0.0);
+        }
+        br.addView(view);
+    }
+
+    PointViewSet viewSet = filter.execute(table);
+    EXPECT_EQ(viewSet.size(), 2u);
+
+    MetadataNode m = filter.getMetadata();
+    ASSERT_EQ(m.children("clusters").size(), 1u);
+    EXPECT_EQ(m.findChild("clusters").value<int64_t>(), 2);
+    EXPECT_EQ(m.children("estimated_memory").size(), 1u);
+    EXPECT_EQ(m.children("core_time").size(), 1u);
+}
@@ -417,3 +417,67 @@ TEST(ExpressionFilterTest, nan)
     EXPECT_EQ(1u, viewSet.size());
     EXPECT_EQ(0u, view->size());
 }
+
+// Evaluate an expression with math and negation over enough
+// points to span several evaluation blocks, in standard and stream mode.
+TEST(ExpressionFilterTest, blocks)
+{
+    BOX3D srcBounds(0.0, 0.0, 0.0, 9999.0, 9999.0, 9999.0);
+
+    Options ops;
+    ops.add("bounds", srcBounds);
+    ops.add("mode", "ramp");
+    ops.add("count", 10000);
+
+    Options exprOps;
+    exprOps.add("expression", "X / 2 + Y / 2 >= 100 && "
+        "!(X > 500 && Y < 9900) && -Z < 0");
+
+    auto passes = [](double x)
+    {
+        return (x >= 100 && x <= 500) || x >= 9900;
+    };
+
+    {
+        FauxReader reader;
+        reader.setOptions(ops);
+
+        ExpressionFilter filter;
+        filter.setOptions(exprOps);
+        filter.setInput(reader);
+
+        PointTable table;
+        filter.prepare(table);
+        PointViewSet viewSet = filter.execute(table);
+        PointViewPtr view = *viewSet.begin();
+
+        EXPECT_EQ(501u, view->size());
+        for (PointId i = 0; i < view->size(); ++i)
+            EXPECT_TRUE(passes(view->getFieldAs<double>(Dimension::Id::X, i)));
+    }
+
+    {
+        FauxReader reader;
+        reader.setOptions(ops);
+
+        ExpressionFilter filter;
+        filter.setOptions(exprOps);
+        filter.setInput(reader);
+
+        StreamCallbackFilter f;
+        f.setInput(filter);
+
+        point_count_t count = 0;
+        f.setCallback([&count, &passes](PointRef& point)
+        {
+            EXPECT_TRUE(passes(point.getFieldAs<double>(Dimension::Id::X)));
+            count++;
+            return true;
+        });
+
+        FixedPointTable table(1000);
+        f.prepare(table);
+        f.execute(table);
+        EXPECT_EQ(501u, count);
+    }
+}
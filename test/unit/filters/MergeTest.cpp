@@ -35,6 +35,9 @@
 #include <pdal/pdal_test_main.hpp>
 
 #include <pdal/PipelineManager.hpp>
+#include <io/FauxReader.hpp>
+#include <filters/MergeFilter.hpp>
+#include <filters/RangeFilter.hpp>
 
 #include "Support.hpp"
 
@@ -94,3 +97,79 @@ TEST(MergeTest, test6)
     PointViewPtr view = *viewSet.begin();
     EXPECT_EQ(2130u, view->size());
 }
+
+// Running the branches in parallel should produce the same result as a
+// serial run, including the spatial reference of the merged view.
+TEST(MergeTest, threads)
+{
+    using namespace pdal;
+
+    auto run = [](std::size_t threads)
+    {
+        PipelineManager mgr;
+        mgr.readPipeline(Support::configuredpath("filters/merge3.json"));
+        mgr.setThreads(threads);
+        mgr.execute();
+
+        PointViewSet viewSet = mgr.views();
+        EXPECT_EQ(1u, viewSet.size());
+        PointViewPtr view = *viewSet.begin();
+        EXPECT_EQ(2130u, view->size());
+        return view->spatialReference();
+    };
+
+    SpatialReference serial = run(1);
+    for (size_t i = 0; i < 5; ++i)
+        EXPECT_EQ(serial, run(2));
+}
+
+// A reader that feeds two branches is executed once for each of them.
+// Running the branches in parallel must not run the two executions of the
+// reader at the same time.
+TEST(MergeTest, diamondThreads)
+{
+    using namespace pdal;
+
+    auto run = [](std::size_t threads)
+    {
+        Options ops;
+        ops.add("bounds", BOX3D(0.0, 0.0, 0.0, 100.0, 100.0, 100.0));
+        ops.add("mode", "ramp");
+        ops.add("count", 10000);
+
+        FauxReader reader;
+        reader.setOptions(ops);
+
+        Options lowOps;
+        lowOps.add("limits", "X[:50)");
+        RangeFilter low;
+        low.setOptions(lowOps);
+        low.setInput(reader);
+
+        Options highOps;
+        highOps.add("limits", "X[50:]");
+        RangeFilter high;
+        high.setOptions(highOps);
+        high.setInput(reader);
+
+        MergeFilter merge;
+        merge.setInput(low);
+        merge.setInput(high);
+
+        PointTable table;
+        merge.prepare(table);
+        PointViewSet viewSet = merge.execute(table, threads);
+        EXPECT_EQ(1u, viewSet.size());
+
+        std::vector<double> xs;
+        for (const PointViewPtr& v : viewSet)
+            for (PointId i = 0; i < v->size(); ++i)
+                xs.push_back(v->getFieldAs<double>(Dimension::Id::X, i));
+        return xs;
+    };
+
+    std::vector<double> serial = run(1);
+    EXPECT_EQ(serial.size(), 10000u);
+    for (size_t i = 0; i < 5; ++i)
+        EXPECT_EQ(serial, run(4));
+}
@@ -113,3 +113,120 @@ TEST(MortonOrderTest, test_code)
     EXPECT_EQ(outView->getFieldAs<double>(Dimension::Id::X, 5), 3);
     EXPECT_EQ(outView->getFieldAs<double>(Dimension::Id::Y, 5), 2);
 }
+
+namespace
+{
+
+PointViewPtr sortGrid(PointTableRef table, int size, bool is3d,
+    const std::string& curve, double yScale = 1.0)
+{
+    using namespace Dimension;
+
+    table.layout()->registerDim(Id::X);
+    table.layout()->registerDim(Id::Y);
+    table.layout()->registerDim(Id::Z);
+
+    // Add the points of the grid in scrambled order.
+    PointViewPtr view(new PointView(table));
+    const PointId count = size * size * (is3d ? size : 1);
+    for (PointId id = 0; id < count; ++id)
+    {
+        PointId cell = (id * 7919) % count;
+        view->setField(Id::X, id, cell % size);
+        view->setField(Id::Y, id, ((cell / size) % size) * yScale);
+        view->setField(Id::Z, id, cell / (size * size));
+    }
+
+    BufferReader r;
+    r.addView(view);
+
+    MortonOrderFilter filter;
+    Options o;
+    o.add("curve", curve);
+    o.add("is3d", is3d);
+    o.add("threads", 3);
+    filter.setInput(r);
+    filter.setOptions(o);
+
+    filter.prepare(table);
+    PointViewSet s = filter.execute(table);
+    EXPECT_EQ(s.size(), 1u);
+    return *s.begin();
+}
+
+} // unnamed namespace
+
+TEST(MortonOrderTest, morton)
+{
+    using namespace Dimension;
+
+    PointTable table;
+    PointViewPtr v = sortGrid(table, 16, false, "morton");
+    ASSERT_EQ(v->size(), 256u);
+
+    // The Morton code of a point on the grid is its position in the view,
+    // with X bits above Y bits.
+    for (PointId i = 0; i < v->size(); ++i)
+    {
+        int x = v->getFieldAs<int>(Id::X, i);
+        int y = v->getFieldAs<int>(Id::Y, i);
+        PointId code = 0;
+        for (int b = 0; b < 4; ++b)
+            code |= (PointId)(((x >> b) & 1) << (2 * b + 1)) |
+                (PointId)(((y >> b) & 1) << (2 * b));
+        EXPECT_EQ(code, i);
+    }
+}
+
+// Each axis is normalized to its own range, so squashing the grid along Y
+// doesn't change the order.
+TEST(MortonOrderTest, mortonAspect)
+{
+    using namespace Dimension;
+
+    PointTable table;
+    PointViewPtr v = sortGrid(table, 16, false, "morton", .125);
+    ASSERT_EQ(v->size(), 256u);
+
+    for (PointId i = 0; i < v->size(); ++i)
+    {
+        int x = v->getFieldAs<int>(Id::X, i);
+        int y = (int)std::lround(v->getFieldAs<double>(Id::Y, i) * 8);
+        PointId code = 0;
+        for (int b = 0; b < 4; ++b)
+            code |= (PointId)(((x >> b) & 1) << (2 * b + 1)) |
+                (PointId)(((y >> b) & 1) << (2 * b));
+        EXPECT_EQ(code, i);
+    }
+}
+
+TEST(MortonOrderTest, hilbert)
+{
+    using namespace Dimension;
+
+    // Consecutive points along a Hilbert curve are neighbors on the grid.
+    auto verify = [](PointViewPtr v)
+    {
+        for (PointId i = 1; i < v->size(); ++i)
+        {
+            int dist =
+                std::abs(v->getFieldAs<int>(Id::X, i) -
+                    v->getFieldAs<int>(Id::X, i - 1)) +
+                std::abs(v->getFieldAs<int>(Id::Y, i) -
+                    v->getFieldAs<int>(Id::Y, i - 1)) +
+                std::abs(v->getFieldAs<int>(Id::Z, i) -
+                    v->getFieldAs<int>(Id::Z, i - 1));
+            EXPECT_EQ(dist, 1);
+        }
+    };
+
+    PointTable table2d;
+    PointViewPtr v = sortGrid(table2d, 32, false, "hilbert");
+    ASSERT_EQ(v->size(), 1024u);
+    verify(v);
+
+    PointTable table3d;
+    v = sortGrid(table3d, 8, true, "hilbert");
+    ASSERT_EQ(v->size(), 512u);
+    verify(v);
+}
@@ -34,8 +34,11 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <random>
+
 #include <pdal/StageFactory.hpp>
 #include <pdal/util/FileUtils.hpp>
+#include <filters/private/BoxIndex.hpp>
 
 #include "Support.hpp"
 
@@ -163,3 +166,41 @@ TEST(OverlayFilterTest, stream)
 {
     testOverlay(10, true);
 }
+
+TEST(OverlayFilterTest, boxIndex)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> pos(0, 1000);
+    std::uniform_real_distribution<double> size(0, 50);
+
+    std::vector<BOX2D> boxes;
+    for (int i = 0; i < 5000; ++i)
+    {
+        double x = pos(gen);
+        double y = pos(gen);
+        boxes.emplace_back(x, y, x + size(gen), y + size(gen));
+    }
+    // An empty box is never found.
+    boxes.emplace_back();
+
+    BoxIndex index;
+    index.build(boxes);
+
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < 1000; ++i)
+    {
+        double x = pos(gen);
+        double y = pos(gen);
+        std::vector<uint32_t> expected;
+        for (uint32_t j = 0; j < boxes.size(); ++j)
+            if (boxes[j].contains(x, y))
+                expected.push_back(j);
+        index.query(x, y, ids);
+        EXPECT_EQ(ids, expected);
+    }
+
+    index.build({});
+    EXPECT_TRUE(index.empty());
+    index.query(1, 1, ids);
+    EXPECT_TRUE(ids.empty());
+}
@@ -39,6 +39,7 @@
 #include <io/FauxReader.hpp>
 #include <io/LasReader.hpp>
 #include <io/TextReader.hpp>
+#include <filters/ChipperFilter.hpp>
 #include <filters/RangeFilter.hpp>
 #include <filters/StreamCallbackFilter.hpp>
 
@@ -476,4 +477,51 @@ TEST(RangeFilterTest, wrongStringFormat)
 
     PointTable table;
     EXPECT_ANY_THROW(filter.prepare(table));
-}
\ No newline at end of file
+}
+
+// Check that running views concurrently produces the same points as running
+// them serially.
+TEST(RangeFilterTest, viewThreads)
+{
+    auto run = [](int threads)
+    {
+        Options ops;
+        ops.add("bounds", BOX3D(0.0, 0.0, 0.0, 100.0, 100.0, 100.0));
+        ops.add("mode", "ramp");
+        ops.add("count", 10000);
+
+        FauxReader reader;
+        reader.setOptions(ops);
+
+        Options chipOps;
+        chipOps.add("capacity", 100);
+
+        ChipperFilter chipper;
+        chipper.setOptions(chipOps);
+        chipper.setInput(reader);
+
+        Options rangeOps;
+        rangeOps.add("limits", "Z[25:75]");
+        rangeOps.add("view_threads", threads);
+
+        RangeFilter filter;
+        filter.setOptions(rangeOps);
+        filter.setInput(chipper);
+
+        PointTable table;
+        filter.prepare(table);
+        PointViewSet viewSet = filter.execute(table);
+
+        std::vector<double> zs;
+        for (const PointViewPtr& v : viewSet)
+            for (PointId i = 0; i < v->size(); ++i)
+                zs.push_back(v->getFieldAs<double>(Dimension::Id::Z, i));
+        return std::make_pair(viewSet.size(), zs);
+    };
+
+    auto serial = run(1);
+    auto parallel = run(4);
+    EXPECT_EQ(serial.first, 100u);
+    EXPECT_EQ(serial.first, parallel.first);
+    EXPECT_EQ(serial.second, parallel.second);
+}
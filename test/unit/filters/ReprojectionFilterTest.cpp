@@ -36,6 +36,7 @@
 
 #include <pdal/SpatialReference.hpp>
 #include <pdal/PointView.hpp>
+#include <io/FauxReader.hpp>
 #include <io/LasReader.hpp>
 #include <filters/ReprojectionFilter.hpp>
 #include <filters/StreamCallbackFilter.hpp>
@@ -227,3 +228,135 @@ TEST(ReprojectionFilterTest, stream_test_2)
     f.prepare(table3);
     f.execute(table3);
 }
+
+// Make sure that splitting the transformation among threads gives the
+// same result as transforming serially, in standard and stream mode.
+TEST(ReprojectionFilterTest, threads)
+{
+    auto run = [](int threads)
+    {
+        Options ro;
+        ro.add("filename", Support::datapath("las/autzen_trim.las"));
+        LasReader reader;
+        reader.setOptions(ro);
+
+        Options fo;
+        fo.add("out_srs", "EPSG:4326");
+        fo.add("threads", threads);
+        ReprojectionFilter filter;
+        filter.setOptions(fo);
+        filter.setInput(reader);
+
+        PointTable table;
+        filter.prepare(table);
+        PointViewSet s = filter.execute(table);
+        return *s.begin();
+    };
+
+    PointViewPtr v1 = run(1);
+    PointViewPtr v4 = run(4);
+    ASSERT_EQ(v1->size(), 110000u);
+    ASSERT_EQ(v1->size(), v4->size());
+    for (PointId i = 0; i < v1->size(); ++i)
+    {
+        EXPECT_EQ(v1->getFieldAs<double>(Dimension::Id::X, i),
+            v4->getFieldAs<double>(Dimension::Id::X, i));
+        EXPECT_EQ(v1->getFieldAs<double>(Dimension::Id::Y, i),
+            v4->getFieldAs<double>(Dimension::Id::Y, i));
+        EXPECT_EQ(v1->getFieldAs<double>(Dimension::Id::Z, i),
+            v4->getFieldAs<double>(Dimension::Id::Z, i));
+    }
+
+    Options ro;
+    ro.add("filename", Support::datapath("las/autzen_trim.las"));
+    LasReader reader;
+    reader.setOptions(ro);
+
+    Options fo;
+    fo.add("out_srs", "EPSG:4326");
+    fo.add("threads", 4);
+    ReprojectionFilter filter;
+    filter.setOptions(fo);
+    filter.setInput(reader);
+
+    PointId i = 0;
+    auto cb = [&](PointRef& point)
+    {
+        EXPECT_EQ(v1->getFieldAs<double>(Dimension::Id::X, i),
+            point.getFieldAs<double>(Dimension::Id::X));
+        EXPECT_EQ(v1->getFieldAs<double>(Dimension::Id::Y, i),
+            point.getFieldAs<double>(Dimension::Id::Y));
+        EXPECT_EQ(v1->getFieldAs<double>(Dimension::Id::Z, i),
+            point.getFieldAs<double>(Dimension::Id::Z));
+        i++;
+        return true;
+    };
+    StreamCallbackFilter f;
+    f.setInput(filter);
+    f.setCallback(cb);
+
+    FixedPointTable table(20000);
+    f.prepare(table);
+    f.execute(table);
+    EXPECT_EQ(i, v1->size());
+
+    Options bad;
+    bad.add("out_srs", "EPSG:4326");
+    bad.add("threads", 0);
+    ReprojectionFilter badFilter;
+    badFilter.setOptions(bad);
+    badFilter.setInput(reader);
+    PointTable badTable;
+    EXPECT_THROW(badFilter.prepare(badTable), pdal_error);
+}
+
+// Points that can't be transformed are dropped individually.  The other
+// points of the same batch must still be kept.
+TEST(ReprojectionFilterTest, partialFailure)
+{
+    auto run = [](bool stream)
+    {
+        // Latitudes from 0 to 100.  Those at or beyond the pole can't be
+        // projected to web mercator.
+        Options ro;
+        ro.add("bounds", BOX3D(0, 0, 0, 10, 100, 0));
+        ro.add("mode", "ramp");
+        ro.add("count", 101);
+        FauxReader reader;
+        reader.setOptions(ro);
+
+        Options fo;
+        fo.add("in_srs", "EPSG:4326");
+        fo.add("out_srs", "EPSG:3857");
+        ReprojectionFilter filter;
+        filter.setOptions(fo);
+        filter.setInput(reader);
+
+        if (!stream)
+        {
+            PointTable table;
+            filter.prepare(table);
+            PointViewSet s = filter.execute(table);
+            return (*s.begin())->size();
+        }
+
+        point_count_t count = 0;
+        StreamCallbackFilter f;
+        f.setInput(filter);
+        f.setCallback([&count](PointRef&)
+        {
+            count++;
+            return true;
+        });
+
+        FixedPointTable table(1000);
+        f.prepare(table);
+        f.execute(table);
+        return count;
+    };
+
+    point_count_t count = run(false);
+    EXPECT_GE(count, 90u);
+    EXPECT_LT(count, 101u);
+    EXPECT_EQ(count, run(true));
+}
@@ -212,3 +212,74 @@ TEST(SortFilterTest, issue1121_simpleSortOrderDesc)
     }
 }
 
+
+TEST(SortFilterTest, multipleDimensions)
+{
+    Options opts;
+
+    opts.add("dimension", "ReturnNumber,GpsTime");
+    opts.add("order", "DESC,ASC");
+    opts.add("threads", 2);
+
+    SortFilter filter;
+    filter.setOptions(opts);
+
+    PointTable table;
+    PointViewPtr view(new PointView(table));
+
+    table.layout()->registerDim(Dimension::Id::ReturnNumber);
+    table.layout()->registerDim(Dimension::Id::GpsTime);
+    table.finalize();
+
+    const point_count_t count = 1000;
+    std::default_random_engine generator;
+    std::uniform_real_distribution<double> dist(-100.0, 100.0);
+
+    for (PointId i = 0; i < count; ++i)
+    {
+        view->setField(Dimension::Id::ReturnNumber, i, (uint8_t)(i % 4));
+        view->setField(Dimension::Id::GpsTime, i, dist(generator));
+    }
+
+    filter.prepare(table);
+    FilterWrapper::ready(filter, table);
+    FilterWrapper::filter(filter, *view.get());
+    FilterWrapper::done(filter, table);
+
+    EXPECT_EQ(count, view->size());
+    for (PointId i = 1; i < count; ++i)
+    {
+        int r1 = view->getFieldAs<int>(Dimension::Id::ReturnNumber, i - 1);
+        int r2 = view->getFieldAs<int>(Dimension::Id::ReturnNumber, i);
+        double t1 = view->getFieldAs<double>(Dimension::Id::GpsTime, i - 1);
+        double t2 = view->getFieldAs<double>(Dimension::Id::GpsTime, i);
+        EXPECT_TRUE(r1 > r2 || (r1 == r2 && t1 <= t2));
+    }
+}
+
+TEST(SortFilterTest, orderCount)
+{
+    Options opts;
+
+    opts.add("dimension", "X,Y,Z");
+    opts.add("order", "ASC,DESC");
+
+    SortFilter filter;
+    filter.setOptions(opts);
+
+    PointTable table;
+    EXPECT_THROW(filter.prepare(table), pdal_error);
+}
+
+TEST(SortFilterTest, noDimension)
+{
+    Options opts;
+
+    opts.add("order", "DESC");
+
+    SortFilter filter;
+    filter.setOptions(opts);
+
+    PointTable table;
+    EXPECT_THROW(filter.prepare(table), pdal_error);
+}
@@ -34,6 +34,7 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <algorithm>
 #include <random>
 
 #include <pdal/PDALUtils.hpp>
@@ -504,3 +505,90 @@ TEST(Stats, merge)
             EXPECT_EQ(wm[(double)i], pm[(double)i]);
     }
 }
+
+TEST(Stats, sketch)
+{
+    std::mt19937 gen(314159);
+    std::normal_distribution<double> dis(100, 30);
+
+    using SummaryPtr = std::unique_ptr<stats::Summary>;
+    std::array<SummaryPtr, 10> parts;
+    for (SummaryPtr& part : parts)
+        part.reset(new stats::Summary("test", stats::Summary::Global, false));
+    stats::Summary exact("test", stats::Summary::Global, false, true);
+
+    const size_t count = 200000;
+    std::vector<double> vals;
+    for (size_t i = 0; i < count; ++i)
+    {
+        double d = dis(gen);
+        parts[i % 10]->insert(d);
+        exact.insert(d);
+        vals.push_back(d);
+    }
+    for (size_t i = 1; i < 10; ++i)
+        parts[0]->merge(*parts[i]);
+    stats::Summary& p = *parts[0];
+    std::sort(vals.begin(), vals.end());
+
+    // Check the rank of the estimated quantiles.
+    for (double q : { 0.0, 0.1, 0.25, 0.5, 0.75, 0.9, 1.0 })
+    {
+        double v = p.quantile(q);
+        double rank = std::lower_bound(vals.begin(), vals.end(), v) -
+            vals.begin();
+        EXPECT_NEAR(rank / count, q, .01);
+        EXPECT_DOUBLE_EQ(exact.quantile(q),
+            vals[(std::min)(size_t(q * count), count - 1)]);
+    }
+
+    p.computeGlobalStats();
+    exact.computeGlobalStats();
+    EXPECT_NEAR(p.median(), exact.median(), 1.0);
+    EXPECT_NEAR(p.mad(), exact.mad(), 1.0);
+}
+
+TEST(Stats, quantiles)
+{
+    BOX3D bounds(1.0, 0.0, 0.0, 10.0, 100.0, 1000.0);
+    Options ops;
+    ops.add("bounds", bounds);
+    ops.add("count", 11);
+    ops.add("mode", "ramp");
+
+    FauxReader reader;
+    reader.setOptions(ops);
+
+    Options filterOps;
+    filterOps.add("dimensions", "Z");
+    filterOps.add("global", "Z");
+    filterOps.add("quantiles", 0.1);
+    filterOps.add("quantiles", 0.5);
+    filterOps.add("quantiles", 1.0);
+
+    StatsFilter filter;
+    filter.setInput(reader);
+    filter.setOptions(filterOps);
+
+    PointTable table;
+    filter.prepare(table);
+    filter.execute(table);
+
+    MetadataNode m = filter.getMetadata().findChild("statistic");
+    std::vector<MetadataNode> quantiles = m.children("quantiles");
+    ASSERT_EQ(quantiles.size(), 3u);
+    EXPECT_DOUBLE_EQ(quantiles[0].findChild("value").value<double>(), 100.0);
+    EXPECT_DOUBLE_EQ(quantiles[1].findChild("value").value<double>(), 500.0);
+    EXPECT_DOUBLE_EQ(quantiles[2].findChild("value").value<double>(), 1000.0);
+
+    Options badOps;
+    badOps.add("global", "Z");
+    badOps.add("quantiles", 1.5);
+
+    StatsFilter bad;
+    bad.setInput(reader);
+    bad.setOptions(badOps);
+
+    PointTable badTable;
+    EXPECT_THROW(bad.prepare(badTable), pdal_error);
+}
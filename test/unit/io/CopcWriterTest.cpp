@@ -33,6 +33,7 @@
  ****************************************************************************/
 
 #include <algorithm>
+#include <fstream>
 
 #include <pdal/pdal_test_main.hpp>
 
@@ -258,4 +259,108 @@ TEST(CopcWriterTest, scaling)
     FileUtils::deleteFile(FILENAME);
 }
 
+TEST(CopcWriterTest, stream)
+{
+    const std::string inFilename(Support::datapath("las/autzen_trim.las"));
+    const std::string outFilename(Support::temppath("copc_stream.copc.laz"));
+    FileUtils::deleteFile(outFilename);
+
+    // A directory that happens to be named like the spill directory is left
+    // alone.
+    const std::string otherDir(outFilename + ".spill");
+    FileUtils::deleteDirectory(otherDir);
+    FileUtils::createDirectory(otherDir);
+    std::ofstream(otherDir + "/keep.txt") << "keep";
+
+    {
+        Options readerOps;
+        readerOps.add("filename", inFilename);
+
+        LasReader reader;
+        reader.setOptions(readerOps);
+
+        // A small memory limit causes points to be binned in several passes.
+        Options writerOps;
+        writerOps.add("filename", outFilename);
+        writerOps.add("memory_limit", 1);
+        CopcWriter writer;
+        writer.setInput(reader);
+        writer.setOptions(writerOps);
+
+        FixedPointTable table(1000);
+        writer.prepare(table);
+        writer.execute(table);
+    }
+    EXPECT_TRUE(FileUtils::fileExists(otherDir + "/keep.txt"));
+    FileUtils::deleteDirectory(otherDir);
+
+    // The spill directory is removed.
+    for (const std::string& f : FileUtils::directoryList(Support::temppath("")))
+        EXPECT_FALSE(Utils::startsWith(f, outFilename + ".spill-")) << f;
+
+    auto summarize = [](Stage& reader, point_count_t& count, BOX3D& bounds,
+        double& intensity)
+    {
+        PointTable table;
+        reader.prepare(table);
+        PointViewSet s = reader.execute(table);
+        PointViewPtr v = *s.begin();
+        count = v->size();
+        v->calculateBounds(bounds);
+        intensity = 0;
+        for (PointId idx = 0; idx < v->size(); ++idx)
+            intensity += v->getFieldAs<double>(Dimension::Id::Intensity, idx);
+    };
+
+    point_count_t inCount, outCount;
+    BOX3D inBounds, outBounds;
+    double inIntensity, outIntensity;
+
+    Options inOps;
+    inOps.add("filename", inFilename);
+    LasReader in;
+    in.setOptions(inOps);
+    summarize(in, inCount, inBounds, inIntensity);
+
+    Options outOps;
+    outOps.add("filename", outFilename);
+    CopcReader out;
+    out.setOptions(outOps);
+    summarize(out, outCount, outBounds, outIntensity);
+
+    EXPECT_EQ(inCount, outCount);
+    EXPECT_NEAR(inBounds.minx, outBounds.minx, .01);
+    EXPECT_NEAR(inBounds.maxx, outBounds.maxx, .01);
+    EXPECT_NEAR(inBounds.miny, outBounds.miny, .01);
+    EXPECT_NEAR(inBounds.maxy, outBounds.maxy, .01);
+    EXPECT_NEAR(inBounds.minz, outBounds.minz, .01);
+    EXPECT_NEAR(inBounds.maxz, outBounds.maxz, .01);
+    EXPECT_DOUBLE_EQ(inIntensity, outIntensity);
+    FileUtils::deleteFile(outFilename);
+}
+
+// Streaming no points writes no file.
+TEST(CopcWriterTest, streamEmpty)
+{
+    const std::string outFilename(Support::temppath("copc_empty.copc.laz"));
+    FileUtils::deleteFile(outFilename);
+
+    Options readerOps;
+    readerOps.add("filename", Support::datapath("las/autzen_trim.las"));
+    readerOps.add("count", 0);
+    LasReader reader;
+    reader.setOptions(readerOps);
+
+    Options writerOps;
+    writerOps.add("filename", outFilename);
+    CopcWriter writer;
+    writer.setInput(reader);
+    writer.setOptions(writerOps);
+
+    FixedPointTable table(1000);
+    writer.prepare(table);
+    EXPECT_NO_THROW(writer.execute(table));
+    EXPECT_FALSE(FileUtils::fileExists(outFilename));
+}
+
 } // namespace pdal
@@ -883,6 +883,50 @@ TEST(LasWriterTest, lazperf)
 }
 
 
+// Compressing chunks in parallel must produce the same file as compressing
+// them in order.
+TEST(LasWriterTest, lazperf_threads)
+{
+    auto write = [](const std::string& filename, int threads, int format)
+    {
+        Options readerOps;
+        readerOps.add("filename", Support::datapath("las/autzen_trim.las"));
+
+        LasReader reader;
+        reader.setOptions(readerOps);
+
+        FileUtils::deleteFile(filename);
+
+        Options writerOps;
+        writerOps.add("filename", filename);
+        writerOps.add("minor_version", 4);
+        writerOps.add("dataformat_id", format);
+        writerOps.add("threads", threads);
+        writerOps.add("creation_doy", 1);
+        writerOps.add("creation_year", 2020);
+
+        LasWriter writer;
+        writer.setOptions(writerOps);
+        writer.setInput(reader);
+
+        PointTable t;
+        writer.prepare(t);
+        writer.execute(t);
+    };
+
+    std::string serial(Support::temppath("serial.laz"));
+    std::string parallel(Support::temppath("parallel.laz"));
+    for (int format : { 3, 7 })
+    {
+        write(serial, 1, format);
+        write(parallel, 4, format);
+        EXPECT_TRUE(Support::compare_files(serial, parallel));
+    }
+    FileUtils::deleteFile(serial);
+    FileUtils::deleteFile(parallel);
+}
+
+
 // This is the same test as the above, but for a 1.4-specific point format.
 // LAZ files are normally written in chunks of 50,000, so a file of size
 // 110,000 ensures we read some whole chunks and a partial.